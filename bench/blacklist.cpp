@@ -0,0 +1,223 @@
+#include <string>
+#include <vector>
+#include <regex>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "Blacklist.h"
+#include "backend.h"
+
+/*******************************************************************************
+
+Microbenchmark for Blacklist. Compares the compiled matcher (literal set plus
+one combined regex) against the previous one-regex-per-pattern matcher. Each
+round reads the blacklist and checks every SlackBuild name and installed
+package, as sboui does at startup. Usage:
+
+  bench_blacklist [rounds]
+
+*******************************************************************************/
+
+/*******************************************************************************
+
+Previous Blacklist, kept here for comparison
+
+*******************************************************************************/
+class OldBlacklist {
+
+  private:
+
+    std::vector<std::regex> _patterns;
+
+  public:
+
+    void add(const std::string & pattern)
+    {
+      std::regex reg(pattern);
+      _patterns.push_back(reg);
+    }
+
+    bool blacklisted(const std::string & pkg) const
+    {
+      unsigned int i, npatterns;
+      std::string name, version, arch, build;
+
+      get_pkg_info(pkg, name, version, arch, build);
+      npatterns = _patterns.size();
+      for ( i = 0; i < npatterns; i++ )
+      {
+        if (std::regex_match(name, _patterns[i])) { return true; }
+        if (std::regex_match(version, _patterns[i])) { return true; }
+        if (std::regex_match(arch, _patterns[i])) { return true; }
+        if (std::regex_match(build, _patterns[i])) { return true; }
+        if (std::regex_match(pkg, _patterns[i])) { return true; }
+      }
+
+      return false;
+    }
+
+    bool nameBlacklisted(const std::string & name) const
+    {
+      unsigned int i, npatterns;
+
+      npatterns = _patterns.size();
+      for ( i = 0; i < npatterns; i++ )
+      {
+        if (std::regex_match(name, _patterns[i])) { return true; }
+      }
+
+      return false;
+    }
+};
+
+/*******************************************************************************
+
+Creates SlackBuild names, installed packages, and blacklist patterns: one
+plain name for every 90 SlackBuilds (100 in all) plus a handful of regexes
+like the examples in etc/blacklist
+
+*******************************************************************************/
+void make_inputs(std::vector<std::string> & names,
+                 std::vector<std::string> & pkgs,
+                 std::vector<std::string> & patterns)
+{
+  int i;
+  char buf[64];
+
+  names.resize(0);
+  pkgs.resize(0);
+  patterns.resize(0);
+  for ( i = 0; i < 9000; i++ )
+  {
+    std::snprintf(buf, sizeof(buf), "sb%05d", i);
+    names.push_back(buf);
+    if (i % 90 == 0) { patterns.push_back(buf); }
+    if (i % 9 == 0)
+    {
+      std::snprintf(buf, sizeof(buf), "sb%05d-1.%d.%d-x86_64-%d%s", i, i % 7,
+                    i % 13, 1 + i % 3, (i % 50 == 0) ? "alien" : "_SBo");
+      pkgs.push_back(buf);
+    }
+  }
+  patterns.push_back("[0-9]+alien");
+  patterns.push_back("(.*)flash(.*)");
+  patterns.push_back("sb0012[0-9]");
+  patterns.push_back("lib.*-compat32");
+  patterns.push_back("[0-9]+ponce");
+  patterns.push_back("kernel-.*");
+  patterns.push_back("(.*)-git");
+}
+
+/*******************************************************************************
+
+Runs both matchers. Returns time in ms per round and sets the match count.
+
+*******************************************************************************/
+double time_new(const std::string & file,
+                const std::vector<std::string> & names,
+                const std::vector<std::string> & pkgs, int rounds,
+                long & nmatched)
+{
+  int r;
+  unsigned int i;
+  std::chrono::steady_clock::time_point start, end;
+
+  nmatched = 0;
+  start = std::chrono::steady_clock::now();
+  for ( r = 0; r < rounds; r++ )
+  {
+    Blacklist bl;
+    bl.read(file);
+    for ( i = 0; i < names.size(); i++ )
+    {
+      if (bl.nameBlacklisted(names[i])) { nmatched++; }
+    }
+    for ( i = 0; i < pkgs.size(); i++ )
+    {
+      if (bl.blacklisted(pkgs[i])) { nmatched++; }
+    }
+  }
+  end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double,std::milli>(end-start).count() / rounds;
+}
+
+double time_old(const std::vector<std::string> & patterns,
+                const std::vector<std::string> & names,
+                const std::vector<std::string> & pkgs, int rounds,
+                long & nmatched)
+{
+  int r;
+  unsigned int i;
+  std::chrono::steady_clock::time_point start, end;
+
+  nmatched = 0;
+  start = std::chrono::steady_clock::now();
+  for ( r = 0; r < rounds; r++ )
+  {
+    OldBlacklist bl;
+    for ( i = 0; i < patterns.size(); i++ ) { bl.add(patterns[i]); }
+    for ( i = 0; i < names.size(); i++ )
+    {
+      if (bl.nameBlacklisted(names[i])) { nmatched++; }
+    }
+    for ( i = 0; i < pkgs.size(); i++ )
+    {
+      if (bl.blacklisted(pkgs[i])) { nmatched++; }
+    }
+  }
+  end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double,std::milli>(end-start).count() / rounds;
+}
+
+int main(int argc, char *argv[])
+{
+  int rounds, fd;
+  unsigned int i;
+  long nmatched_old, nmatched_new;
+  double t_old, t_new;
+  char file[] = "/tmp/sboui-bench-blacklist.XXXXXX";
+  std::ofstream out;
+  std::vector<std::string> names, pkgs, patterns;
+
+  rounds = 3;
+  if (argc > 1) { rounds = std::atoi(argv[1]); }
+  if (rounds < 1) { rounds = 1; }
+
+  // Write the patterns to a blacklist file for Blacklist::read
+
+  make_inputs(names, pkgs, patterns);
+  fd = mkstemp(file);
+  if (fd == -1)
+  {
+    std::cerr << "Error: could not create temporary file." << std::endl;
+    return 1;
+  }
+  close(fd);
+  out.open(file);
+  for ( i = 0; i < patterns.size(); i++ ) { out << patterns[i] << std::endl; }
+  out.close();
+
+  t_old = time_old(patterns, names, pkgs, rounds, nmatched_old);
+  t_new = time_new(file, names, pkgs, rounds, nmatched_new);
+  std::remove(file);
+
+  std::cout << "blacklist: " << patterns.size() << " patterns, "
+            << names.size() << " SlackBuilds, " << pkgs.size()
+            << " packages x " << rounds << " rounds" << std::endl;
+  std::cout << "  per-pattern regex: " << t_old << " ms/round ("
+            << nmatched_old << " matched)" << std::endl;
+  std::cout << "  compiled matcher:  " << t_new << " ms/round ("
+            << nmatched_new << " matched)" << std::endl;
+  if (nmatched_old != nmatched_new)
+  {
+    std::cerr << "Error: matchers disagree." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,224 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "ListItem.h"
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+Microbenchmark for SlackBuild props. Compares the typed fields of BuildListItem
+against the string-keyed ListItem prop list that SlackBuilds used before, on a
+synthetic repository the size of SlackBuilds.org. Reports the resident memory
+each takes and the time for the prop lookups that filters and list boxes do.
+Usage:
+
+  bench_build_props [rounds]
+
+*******************************************************************************/
+
+const unsigned int ncategories = 150;
+const unsigned int nperCategory = 60;
+
+/*******************************************************************************
+
+Resident size of this process in bytes, or 0 if it cannot be read
+
+*******************************************************************************/
+long resident_bytes()
+{
+  std::ifstream statm("/proc/self/statm");
+  long size, resident;
+
+  if (! (statm >> size >> resident)) { return 0; }
+
+  return resident*sysconf(_SC_PAGESIZE);
+}
+
+/*******************************************************************************
+
+Values of the SlackBuild props for one synthetic SlackBuild. About one in five
+is installed, and versions and build numbers repeat as they do in the real
+repository.
+
+*******************************************************************************/
+struct build_values {
+  std::string name, category, version, buildnum, reqs;
+  bool installed;
+};
+
+void make_values(std::vector<build_values> & values)
+{
+  unsigned int i, n;
+  char buf[64];
+
+  n = ncategories*nperCategory;
+  values.resize(n);
+  for ( i = 0; i < n; i++ )
+  {
+    std::snprintf(buf, sizeof(buf), "sb%05u", i);
+    values[i].name = buf;
+    std::snprintf(buf, sizeof(buf), "category%03u", i % ncategories);
+    values[i].category = buf;
+    std::snprintf(buf, sizeof(buf), "%u.%u.%u", i % 5, i % 13, i % 7);
+    values[i].version = buf;
+    std::snprintf(buf, sizeof(buf), "%u", 1 + i % 3);
+    values[i].buildnum = buf;
+    if (i % 4 == 0) { values[i].reqs = ""; }
+    else
+    {
+      std::snprintf(buf, sizeof(buf), "sb%05u sb%05u", i/2, i/3);
+      values[i].reqs = buf;
+    }
+    values[i].installed = (i % 5 == 0);
+  }
+}
+
+/*******************************************************************************
+
+Sets the SlackBuild props on an item through the generic prop API. For a
+ListItem, addProp puts them in its prop list; a BuildListItem stores them in
+typed fields.
+
+*******************************************************************************/
+void set_props(ListItem & item, const build_values & values)
+{
+  item.setName(values.name);
+  item.addProp("category", values.category);
+  item.addProp("available_version", values.version);
+  item.addProp("available_buildnum", values.buildnum);
+  item.addProp("requires", values.reqs);
+  item.addProp("installed_version", values.installed ? values.version : "");
+  item.addProp("installed_buildnum", values.installed ? values.buildnum : "");
+  item.addProp("package_name", values.installed ? values.name + "-" +
+               values.version + "-x86_64-" + values.buildnum + "_SBo" : "");
+  item.addProp("build_options", "");
+  item.addProp("action", "");
+  item.addBoolProp("installed", values.installed);
+  item.addBoolProp("upgradable", false);
+  item.addBoolProp("tagged", false);
+  item.addBoolProp("marked", false);
+  item.addBoolProp("blacklisted", false);
+}
+
+/*******************************************************************************
+
+Times the lookups a filter pass and a redraw make for each SlackBuild. Returns
+ns per lookup.
+
+*******************************************************************************/
+template<typename T>
+double time_lookups(const std::vector<T> & items, int rounds, long & nfound)
+{
+  int r;
+  unsigned int i, nitems;
+  std::chrono::steady_clock::time_point start, end;
+
+  nfound = 0;
+  nitems = items.size();
+  start = std::chrono::steady_clock::now();
+  for ( r = 0; r < rounds; r++ )
+  {
+    for ( i = 0; i < nitems; i++ )
+    {
+      if (items[i].getBoolProp("installed")) { nfound++; }
+      if (items[i].getBoolProp("tagged")) { nfound++; }
+      if (items[i].getBoolProp("blacklisted")) { nfound++; }
+      nfound += items[i].getProp("available_version").size();
+      nfound += items[i].getProp("category").size();
+    }
+  }
+  end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double,std::nano>(end-start).count() /
+         (5.*double(rounds)*double(nitems));
+}
+
+double time_typed(const std::vector<BuildListItem> & items, int rounds,
+                  long & nfound)
+{
+  int r;
+  unsigned int i, nitems;
+  std::chrono::steady_clock::time_point start, end;
+
+  nfound = 0;
+  nitems = items.size();
+  start = std::chrono::steady_clock::now();
+  for ( r = 0; r < rounds; r++ )
+  {
+    for ( i = 0; i < nitems; i++ )
+    {
+      if (items[i].installed()) { nfound++; }
+      if (items[i].tagged()) { nfound++; }
+      if (items[i].blacklisted()) { nfound++; }
+      nfound += items[i].getProp("available_version").size();
+      nfound += items[i].category().size();
+    }
+  }
+  end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double,std::nano>(end-start).count() /
+         (5.*double(rounds)*double(nitems));
+}
+
+int main(int argc, char *argv[])
+{
+  int rounds;
+  unsigned int i, n;
+  long rss0, rss1, rss2, nfound_list, nfound_build, nfound_typed;
+  double t_list, t_build, t_typed;
+  std::vector<build_values> values;
+  std::vector<BuildListItem> builds;
+  std::vector<ListItem> items;
+
+  rounds = 20;
+  if (argc > 1) { rounds = std::atoi(argv[1]); }
+  if (rounds < 1) { rounds = 1; }
+
+  // Memory: build each representation of the whole repository in turn, and
+  // keep both alive so that the second cannot reuse memory of the first
+
+  make_values(values);
+  n = values.size();
+  builds.reserve(n);
+  items.reserve(n);
+  rss0 = resident_bytes();
+  for ( i = 0; i < n; i++ )
+  {
+    builds.push_back(BuildListItem());
+    set_props(builds[i], values[i]);
+  }
+  rss1 = resident_bytes();
+  for ( i = 0; i < n; i++ )
+  {
+    items.push_back(ListItem());
+    set_props(items[i], values[i]);
+  }
+  rss2 = resident_bytes();
+
+  // Lookups
+
+  t_list = time_lookups(items, rounds, nfound_list);
+  t_build = time_lookups(builds, rounds, nfound_build);
+  t_typed = time_typed(builds, rounds, nfound_typed);
+
+  std::cout << "build props: " << n << " SlackBuilds, " << rounds
+            << " rounds" << std::endl;
+  std::cout << "  ListItem prop list:  " << (rss2-rss1)/1024 << " KiB, "
+            << t_list << " ns/lookup" << std::endl;
+  std::cout << "  BuildListItem props: " << (rss1-rss0)/1024 << " KiB, "
+            << t_build << " ns/lookup" << std::endl;
+  std::cout << "  typed getters:       " << t_typed << " ns/lookup"
+            << std::endl;
+  if ( (nfound_list != nfound_build) || (nfound_list != nfound_typed) )
+  {
+    std::cerr << "Error: lookups disagree." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include "BuildListItem.h"
+#include "backend.h"
+
+/*******************************************************************************
+
+Microbenchmark for find_slackbuild. Compares the name hash table built by
+index_slackbuilds against the per-category OpenMP bisection it replaced, on a
+synthetic repository about the size of SlackBuilds.org. Usage:
+
+  bench_find_slackbuild [rounds]
+
+*******************************************************************************/
+
+/*******************************************************************************
+
+Previous find_slackbuild, kept here for comparison
+
+*******************************************************************************/
+int find_slackbuild_bisect(const std::string & name,
+                    std::vector<std::vector<BuildListItem> > & slackbuilds,
+                    int & idx0, int & idx1)
+{
+  int i, ncategories, nbuilds, check, lbound, rbound;
+  std::atomic<bool> found(false);
+
+  ncategories = slackbuilds.size();
+#pragma omp parallel for private(i,nbuilds,lbound,rbound,check)
+  for ( i = 0; i < ncategories; i++ )
+  {
+    if (found)
+      continue;
+    nbuilds = slackbuilds[i].size();
+    lbound = 0;
+    rbound = nbuilds-1;
+    check = find_name_in_list(name, slackbuilds[i], idx1, lbound, rbound);
+    if (check == 0)
+    {
+      idx0 = i;
+      found = true;
+    }
+  }
+
+  if (found)
+    return 0;
+  else
+    return 1;
+}
+
+/*******************************************************************************
+
+Creates ncategories x nbuilds SlackBuilds. Names are handed out round-robin,
+so every category spans the whole alphabet like the real repository does and
+the bisection cannot reject a category from its bounds alone.
+
+*******************************************************************************/
+void make_repo(std::vector<std::vector<BuildListItem> > & slackbuilds,
+               std::vector<std::string> & names, int ncategories, int nbuilds)
+{
+  int i, ntotal;
+  char buf[16];
+  BuildListItem build;
+
+  slackbuilds.resize(ncategories);
+  names.resize(0);
+  ntotal = ncategories*nbuilds;
+  for ( i = 0; i < ntotal; i++ )
+  {
+    std::snprintf(buf, sizeof(buf), "sb%05d", i);
+    build.setName(buf);
+    slackbuilds[i % ncategories].push_back(build);
+    names.push_back(buf);
+  }
+}
+
+/*******************************************************************************
+
+Times one lookup function over all names for the given number of rounds.
+Returns ns per lookup and sets the number of names found.
+
+*******************************************************************************/
+double time_lookups(int (*lookup)(const std::string &,
+                                  std::vector<std::vector<BuildListItem> > &,
+                                  int &, int &),
+                    const std::vector<std::string> & names,
+                    std::vector<std::vector<BuildListItem> > & slackbuilds,
+                    int rounds, long & nfound)
+{
+  int r, idx0, idx1;
+  unsigned int i, nnames;
+  std::chrono::steady_clock::time_point start, end;
+
+  nfound = 0;
+  nnames = names.size();
+  start = std::chrono::steady_clock::now();
+  for ( r = 0; r < rounds; r++ )
+  {
+    for ( i = 0; i < nnames; i++ )
+    {
+      if (lookup(names[i], slackbuilds, idx0, idx1) == 0)
+      {
+        if (slackbuilds[idx0][idx1].name() == names[i]) { nfound++; }
+      }
+    }
+  }
+  end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double,std::nano>(end-start).count() /
+         (double(rounds)*double(nnames));
+}
+
+int main(int argc, char *argv[])
+{
+  int rounds;
+  long nfound_bisect, nfound_index;
+  double t_bisect, t_index;
+  std::vector<std::vector<BuildListItem> > slackbuilds;
+  std::vector<std::string> names;
+  std::mt19937 rng(1);
+
+  rounds = 5;
+  if (argc > 1) { rounds = std::atoi(argv[1]); }
+  if (rounds < 1) { rounds = 1; }
+
+  // 150 categories x 60 SlackBuilds; look up every name in random order, plus
+  // one miss for every ten names
+
+  make_repo(slackbuilds, names, 150, 60);
+  std::shuffle(names.begin(), names.end(), rng);
+  names.resize(names.size() + names.size()/10, "not-in-repo");
+  index_slackbuilds(slackbuilds);
+
+  t_bisect = time_lookups(find_slackbuild_bisect, names, slackbuilds, rounds,
+                          nfound_bisect);
+  t_index = time_lookups(find_slackbuild, names, slackbuilds, rounds,
+                         nfound_index);
+
+  std::cout << "find_slackbuild: " << names.size() << " lookups x " << rounds
+            << " rounds" << std::endl;
+  std::cout << "  bisection:  " << t_bisect << " ns/lookup ("
+            << nfound_bisect << " found)" << std::endl;
+  std::cout << "  hash table: " << t_index << " ns/lookup ("
+            << nfound_index << " found)" << std::endl;
+  if (nfound_bisect != nfound_index)
+  {
+    std::cerr << "Error: lookups disagree." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
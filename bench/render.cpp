@@ -0,0 +1,201 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <curses.h>
+#include "Color.h"
+#include "ColorTheme.h"
+#include "settings.h"
+
+/*******************************************************************************
+
+Render microbenchmark for list box rows. Draws pages of rows the way
+BuildListBox::redrawSingleItem does, once picking colors by label (as before
+color-pair handles) and once with handles resolved up front (as widgets do
+now). Each variant is timed for whole rows and for the color switch alone.
+Output goes to a terminal on /dev/null. Usage:
+
+  bench_render [frames]
+
+*******************************************************************************/
+
+const int nrows = 40;
+const int ncols = 60;
+
+struct row {
+  std::string name;
+  bool tagged, installed;
+};
+
+/*******************************************************************************
+
+Prints the row text, if requested, and turns off color; same for both
+variants
+
+*******************************************************************************/
+void print_row(WINDOW *win, int y, const row & item, bool text)
+{
+  int i, nspaces;
+
+  if (! text)
+  {
+    colors.turnOff(win);
+    return;
+  }
+  wmove(win, y, 1);
+  wprintw(win, "%s", item.name.c_str());
+  nspaces = ncols-14 - item.name.size();
+  for ( i = 0; i < nspaces; i++ ) { waddch(win, ' '); }
+  if (item.installed) { wprintw(win, "   [X]   "); }
+  else { wprintw(win, "   [ ]   "); }
+  colors.turnOff(win);
+}
+
+/*******************************************************************************
+
+Draws one row, looking up its color pair by label
+
+*******************************************************************************/
+void draw_row_labels(WINDOW *win, int y, const row & item, bool highlight,
+                     bool text)
+{
+  std::string fg, bg;
+
+  if (highlight)
+  {
+    if (item.tagged) { fg = "tagged"; }
+    else { fg = "fg_highlight_active"; }
+    bg = "bg_highlight_active";
+  }
+  else
+  {
+    if (item.tagged) { fg = "tagged"; }
+    else { fg = "fg_normal"; }
+    bg = "bg_normal";
+  }
+  colors.turnOn(win, fg, bg);
+  print_row(win, y, item, text);
+}
+
+/*******************************************************************************
+
+Draws one row with a precomputed handle
+
+*******************************************************************************/
+void draw_row_handles(WINDOW *win, int y, const row & item, bool highlight,
+                      const std::vector<int> & pairs, bool text)
+{
+  int color_pair;
+
+  if (highlight)
+  {
+    if (item.tagged) { color_pair = pairs[0]; }
+    else { color_pair = pairs[1]; }
+  }
+  else
+  {
+    if (item.tagged) { color_pair = pairs[2]; }
+    else { color_pair = pairs[3]; }
+  }
+  colors.turnOn(win, color_pair);
+  print_row(win, y, item, text);
+}
+
+/*******************************************************************************
+
+Draws frames of nrows rows each, with a moving highlight. Returns ns per row.
+
+*******************************************************************************/
+double time_frames(WINDOW *win, const std::vector<row> & items, int frames,
+                   const std::vector<int> & pairs, bool use_handles,
+                   bool text)
+{
+  int f, i, highlight;
+  std::chrono::steady_clock::time_point start, end;
+
+  start = std::chrono::steady_clock::now();
+  for ( f = 0; f < frames; f++ )
+  {
+    highlight = f % nrows;
+    for ( i = 0; i < nrows; i++ )
+    {
+      if (use_handles)
+        draw_row_handles(win, i+1, items[i], i == highlight, pairs, text);
+      else
+        draw_row_labels(win, i+1, items[i], i == highlight, text);
+    }
+    wnoutrefresh(win);
+  }
+  end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double,std::nano>(end-start).count() /
+         (double(frames)*double(nrows));
+}
+
+int main(int argc, char *argv[])
+{
+  int frames, i;
+  double t_labels, t_handles, t_labels_color, t_handles_color;
+  char buf[32];
+  FILE *devnull;
+  SCREEN *scr;
+  WINDOW *win;
+  ColorTheme theme;
+  std::vector<row> items;
+  std::vector<int> pairs;
+
+  frames = 20000;
+  if (argc > 1) { frames = std::atoi(argv[1]); }
+  if (frames < 1) { frames = 1; }
+
+  // Set up curses on /dev/null with the default theme
+
+  devnull = std::fopen("/dev/null", "w");
+  scr = newterm("xterm-256color", devnull, stdin);
+  if (scr == NULL)
+  {
+    std::cerr << "Error: could not set up xterm-256color terminal."
+              << std::endl;
+    return 1;
+  }
+  set_term(scr);
+  start_color();
+  theme.setDefaultColors();
+  theme.applyTheme(colors);
+  win = newwin(nrows+2, ncols, 0, 0);
+
+  pairs.push_back(colors.getPair("tagged", "bg_highlight_active"));
+  pairs.push_back(colors.getPair("fg_highlight_active", "bg_highlight_active"));
+  pairs.push_back(colors.getPair("tagged", "bg_normal"));
+  pairs.push_back(colors.getPair("fg_normal", "bg_normal"));
+
+  items.resize(nrows);
+  for ( i = 0; i < nrows; i++ )
+  {
+    std::snprintf(buf, sizeof(buf), "slackbuild-%02d", i);
+    items[i].name = buf;
+    items[i].tagged = (i % 7 == 0);
+    items[i].installed = (i % 3 == 0);
+  }
+
+  t_labels = time_frames(win, items, frames, pairs, false, true);
+  t_handles = time_frames(win, items, frames, pairs, true, true);
+  t_labels_color = time_frames(win, items, frames, pairs, false, false);
+  t_handles_color = time_frames(win, items, frames, pairs, true, false);
+
+  delwin(win);
+  endwin();
+  delscreen(scr);
+  std::fclose(devnull);
+
+  std::cout << "render: " << frames << " frames x " << nrows << " rows"
+            << std::endl;
+  std::cout << "  label lookup: " << t_labels << " ns/row, "
+            << t_labels_color << " ns/row for color alone" << std::endl;
+  std::cout << "  handles:      " << t_handles << " ns/row, "
+            << t_handles_color << " ns/row for color alone" << std::endl;
+
+  return 0;
+}
@@ -37,6 +37,7 @@ class AbstractListBox: public CursesWidget {
     /* Edit list */
 
     virtual void addItem(ListItem *item);
+    virtual void insertItem(unsigned int idx, ListItem *item);
     virtual void removeItem(unsigned int idx);
     virtual void clearList();
 
@@ -3,17 +3,37 @@
 #include <vector>
 #include <string>
 #include <regex>
+#include <unordered_set>
+#include <unordered_map>
+#include "InstalledPackages.h"
 
 /*******************************************************************************
 
-Reads blacklist files and checks packages and SlackBuilds for matches
+Reads blacklist files and checks packages and SlackBuilds for matches. Patterns
+without regex special characters (plain names, the common case) are kept in a
+hash set. The rest are compiled together into one regex, except for patterns
+with backreferences, which cannot be combined. Regex results are cached per
+string, since e.g. arch and build are the same for most packages.
 
 *******************************************************************************/
 class Blacklist {
 
   private:
 
+    std::unordered_set<std::string> _literals;
+    std::vector<std::string> _regex_patterns;
+    std::regex _combined;
     std::vector<std::regex> _patterns;
+    bool _have_combined;
+    mutable std::unordered_map<std::string, bool> _cache;
+
+    /* Compiles regex patterns */
+
+    void compile();
+
+    /* Checks one string for a match */
+
+    bool matches(const std::string & str) const;
 
   public:
 
@@ -32,6 +52,7 @@ class Blacklist {
     bool blacklisted(const std::string & pkg, const std::string & name,
                      const std::string & version, const std::string & arch,
                      const std::string & build) const;
+    bool blacklisted(const installed_pkg & pkg) const;
 
     /* Checks not-installed package for match in name only */
 
@@ -6,6 +6,7 @@
 #include "MouseEvent.h"
 
 class TagList;
+class BuildListView;
 
 /*******************************************************************************
 
@@ -39,6 +40,10 @@ class BuildListBox: public ListBox {
 
     bool allTagged() const;
 
+    /* Shows one category of a list view */
+
+    void setView(const BuildListView & view, unsigned int category);
+
     /* User interaction loop */
 
     virtual std::string exec(MouseEvent * mevent=NULL);
@@ -3,21 +3,44 @@
 #include <string>
 #include <vector>
 #include "ListItem.h"
+#include "InstalledPackages.h"
 
 /*******************************************************************************
 
-List item that describes a SlackBuild
+List item that describes a SlackBuild. The known SlackBuild properties are
+stored in typed fields rather than in the generic ListItem prop list: flags as
+bits, versions, build numbers and actions as interned strings, and the category
+as an index into a shared table. The ListItem prop methods are overridden to
+map prop names onto these fields, so they can still be used as before.
 
 *******************************************************************************/
 class BuildListItem: public ListItem {
 
   private:
 
+    // Typed storage for SlackBuild props
+
+    unsigned int _flags, _id;
+    int _category;
+    const std::string *_available_version, *_available_buildnum;
+    const std::string *_installed_version, *_installed_buildnum;
+    const std::string *_action;
+    std::string _requires, _package_name, _build_options;
+
+    // Result of reading repo info (-1 if it has not been read yet)
+
+    int _repo_check;
+
     // Checks whether a SlackBuild can be upgraded
 
     bool differsByKernel(const std::string & installed_version,
                          const std::string & available_version) const;
-    bool upgradable() const;
+    bool checkUpgradable() const;
+
+    // Access to typed fields by field index (see BuildListItem.cpp)
+
+    void setField(int field, const std::string & value);
+    const std::string & getField(int field) const;
 
   public:
 
@@ -29,14 +52,47 @@ class BuildListItem: public ListItem {
 
     void operator = (const ListItem & item);
 
-    // Reads properties from repo 
+    // ListItem prop methods, mapped onto typed fields for SlackBuild props
+
+    void addProp(const std::string & propname, const std::string & value);
+    void addBoolProp(const std::string & propname, bool value);
+    int setProp(const std::string & propname, const std::string & value);
+    int setBoolProp(const std::string & propname, bool value);
+    bool checkProp(const std::string & propname) const;
+    const std::string & getProp(const std::string & propname) const;
+    bool getBoolProp(const std::string & propname) const;
+
+    // Typed access to flags and category, bypassing prop name lookup
+
+    bool installed() const;
+    bool upgradable() const;
+    bool tagged() const;
+    bool marked() const;
+    bool blacklisted() const;
+    const std::string & category() const;
+
+    // Position in the master list, used as index into BuildSets
+
+    void setId(unsigned int id);
+    unsigned int id() const;
+
+    // Reads properties from repo. If use_cached is true and repo info has
+    // already been read (e.g., from the repository index), it is not re-read.
+
+    void readInstalledProps(const InstalledPackages & installedpkgs);
+    int readPropsFromRepo(bool use_cached=false);
+
+    // Sets repo info that was read elsewhere, along with the return value
+    // readPropsFromRepo would have given
 
-    void readInstalledProps(std::vector<std::string> & installedpkgs);
-    int readPropsFromRepo();
+    void setRepoInfo(const std::string & available_version,
+                     const std::string & reqs,
+                     const std::string & available_buildnum, int check);
+    int repoInfoCheck() const;
 
     // Determines BUILD number from last portion of package name
 
-    void parseBuildNum(std::string & build);
+    void parseBuildNum(const std::string & build);
 
     // Build options as string of environment variables
 
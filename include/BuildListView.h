@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include "BuildListItem.h"
+#include "CategoryListItem.h"
+
+/*******************************************************************************
+
+Flat view of the SlackBuilds shown in the main window: one array of builds in
+display order, with offsets marking where each category starts. A single list
+box shows one category at a time from this view, so filtering only fills
+arrays instead of creating a list box per category. The highlight of each
+category is kept here while another category is shown.
+
+*******************************************************************************/
+class BuildListView {
+
+  private:
+
+    std::vector<BuildListItem *> _builds;
+    std::vector<CategoryListItem *> _categories;
+    std::vector<unsigned int> _offsets, _highlights;
+    unsigned int _revision;
+    static unsigned int _last_revision;
+
+    /* Marks the view as changed */
+
+    void touch();
+
+  public:
+
+    /* Constructor */
+
+    BuildListView();
+
+    /* Edit view. Builds are added to the last category. */
+
+    void clear();
+    void addCategory(CategoryListItem *category);
+    void addBuild(BuildListItem *build);
+    void insertBuild(unsigned int category, unsigned int idx,
+                     BuildListItem *build);
+    void removeBuild(unsigned int category, unsigned int idx);
+
+    /* Set attributes */
+
+    void setHighlight(unsigned int category, unsigned int highlight);
+
+    /* Get attributes. The revision is unique to the contents of the view, so
+       list boxes can tell whether what they show is out of date. */
+
+    unsigned int numCategories() const;
+    unsigned int numBuilds() const;
+    unsigned int numBuilds(unsigned int category) const;
+    CategoryListItem * category(unsigned int category) const;
+    BuildListItem * build(unsigned int category, unsigned int idx) const;
+    unsigned int highlight(unsigned int category) const;
+    unsigned int revision() const;
+    bool allTagged(unsigned int category) const;
+};
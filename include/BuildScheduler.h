@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sys/types.h>   // pid_t
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+Applies changes to a list of SlackBuilds in build order, building SlackBuilds
+that do not depend on each other in parallel with the built-in package
+manager. A SlackBuild is built once everything it requires from the list has
+been installed. Packages are installed one at a time, each after the ones it
+requires. If a SlackBuild fails to build or install, the SlackBuilds in the
+list depending on it are skipped, while the rest are still applied. When
+building in parallel, build output is saved to log files, since several builds
+share the terminal.
+
+SlackBuilds whose inputs have not changed since they were last built are
+installed from the package cache instead, once their requirements are
+installed.
+
+Sources can also be prefetched: all sources in the list are then downloaded
+and md5-checked a few at a time from the start, in build order, while earlier
+SlackBuilds compile. A build only waits for its own sources, and is given
+them with the sourcedir option of the built-in package manager.
+
+*******************************************************************************/
+class BuildScheduler {
+
+  private:
+
+    struct build_job {
+      BuildListItem *build;
+      std::vector<unsigned int> deps;   // Jobs this one requires
+      std::string state;                // waiting, building, built, done,
+                                        // failed, or skipped
+      std::string pkgfile, logfile, package, sourcedir;
+      std::string cacheopt;             // Where to cache the built package
+      bool cachechecked, cached;
+      unsigned int nsources;            // Sources not fetched yet
+      pid_t pid;
+    };
+
+    struct source_fetch {
+      unsigned int job;
+      std::string url, md5sum, path;
+      std::string state;                // waiting, fetching, or finished
+      pid_t pid;
+    };
+
+    std::vector<build_job> _jobs;
+    std::vector<source_fetch> _fetches;
+    unsigned int _maxjobs, _nrunning, _nfetching;
+    std::string _workdir;
+    bool _pm_missing, _prefetch;
+
+    static const unsigned int _maxfetches;
+
+    /* Job steps */
+
+    bool depsDone(unsigned int idx) const;
+    bool useCachedPackage(unsigned int idx);
+    int startBuild(unsigned int idx);
+    void finishBuild(unsigned int idx, int status);
+    int installJob(unsigned int idx);
+    void failJob(unsigned int idx);
+    void skipWaiting();
+    void waitForChild();
+    void cleanUp();
+
+    /* Source prefetching */
+
+    void planFetches();
+    int startFetch(unsigned int idx);
+    void finishFetch(unsigned int idx, int status);
+
+  public:
+
+    /* Constructor */
+
+    BuildScheduler();
+
+    /* Set attributes. Builds must be in build order. */
+
+    void setMaxJobs(unsigned int maxjobs);
+    void setPrefetch(bool prefetch);
+    void setBuilds(const std::vector<BuildListItem *> & builds);
+
+    /* Builds and installs, or removes, the SlackBuilds. Returns 0 if all
+       changes were applied, 127 if the package manager was not found, or 1
+       otherwise. */
+
+    int run(int & ninstalled, int & nupgraded, int & nreinstalled,
+            int & nremoved);
+
+    /* SlackBuilds that run attempted to change, whether or not it
+       succeeded */
+
+    void attemptedBuilds(std::vector<BuildListItem *> & attempted) const;
+};
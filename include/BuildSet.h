@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+/*******************************************************************************
+
+Set of SlackBuilds as a bitset over build IDs. Filters are combined word-wise
+with AND, OR and NOT.
+
+*******************************************************************************/
+class BuildSet {
+
+  private:
+
+    std::vector<uint64_t> _words;
+    unsigned int _size;
+
+    /* Clears unused bits in the last word */
+
+    void trim();
+
+  public:
+
+    /* Constructor */
+
+    BuildSet(unsigned int size=0, bool value=false);
+
+    /* Set attributes */
+
+    void reset(unsigned int size, bool value=false);
+    void set(unsigned int id, bool value=true);
+
+    /* Get attributes */
+
+    unsigned int size() const;
+    bool test(unsigned int id) const;
+    unsigned int count() const;
+    unsigned int next(unsigned int id) const;
+
+    /* Set algebra */
+
+    BuildSet & operator &= (const BuildSet & other);
+    BuildSet & operator |= (const BuildSet & other);
+    void invert();
+    bool operator == (const BuildSet & other) const;
+};
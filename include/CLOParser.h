@@ -14,7 +14,7 @@ class CLOParser {
 
     std::vector<std::string> _argv_str;
     std::string _input_file;
-    bool _sync, _upgrade_all, _upgradable;
+    bool _sync, _upgrade_all, _upgradable, _cache_stats, _cache_prune;
 
 
     /* Converts CLOs to vector of strings */
@@ -47,4 +47,6 @@ class CLOParser {
     bool sync() const;
     bool upgradeAll() const;
     bool upgradable() const;
+    bool cacheStats() const;
+    bool cachePrune() const;
 };
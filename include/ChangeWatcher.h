@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+
+Changes seen by ChangeWatcher since the last time they were collected
+
+*******************************************************************************/
+struct watched_changes {
+  std::vector<std::string> packages;    // Names of added/removed packages
+  std::vector<std::string> buildopts;   // SlackBuilds with changed build opts
+  bool repo;                            // Repository changed or was synced
+};
+
+/*******************************************************************************
+
+Watches the installed package directory, the build options directory, and the
+repository with inotify, so that changes made outside of sboui (installpkg from
+another terminal, a sync run by cron, etc.) can be picked up without
+restarting. The watcher never blocks: events are read whenever poll is called,
+and they are only handed out once no new events have arrived for the debounce
+interval, so that e.g. a package upgrade or repository sync is seen as a single
+change.
+
+*******************************************************************************/
+class ChangeWatcher {
+
+  private:
+
+    int _fd, _pkg_wd, _buildopts_wd, _sboui_wd, _repo_wd;
+    std::vector<int> _category_wds;
+    std::string _pkg_path, _repo_path;
+    watched_changes _pending;
+    bool _have_pending;
+    long _last_event;
+
+    static const int _debounce;
+
+    /* Reads available events into list of pending changes */
+
+    void readEvents();
+    void watchBuildopts();
+
+  public:
+
+    /* Constructor and destructor */
+
+    ChangeWatcher();
+    ~ChangeWatcher();
+
+    /* Starts watching (categories are subdirectories of the repository) or
+       stops watching */
+
+    int start(const std::string & repo_dir,
+              const std::vector<std::string> & categories);
+    void stop();
+    bool active() const;
+
+    /* Gets changes once they have settled. Returns 1 if there are changes, 0
+       otherwise. */
+
+    int poll(watched_changes & changes);
+
+    /* Discards changes seen so far, e.g. those made by sboui itself */
+
+    void discard();
+
+    /* How often poll should be called (milliseconds) */
+
+    static const int pollInterval;
+};
@@ -7,7 +7,9 @@
 /*******************************************************************************
 
 Manages colors for ncurses, making color pairs easy to reference by foreground
-and background color.
+and background color. Widgets look up a pair once with getPair and keep the
+returned handle. Handles stay valid when a theme is applied or colors are
+cleared, so drawing never has to compare color labels.
 
 *******************************************************************************/
 class Color {
@@ -28,6 +30,18 @@ class Color {
     std::vector<color_pair> _colors;
     int _active_pair;
 
+    /* Handles: labels requested by getPair and the _colors index each one
+       currently resolves to (-1 if there is no such pair) */
+
+    std::vector<std::string> _handle_fg, _handle_bg;
+    std::vector<int> _handle_pairs;
+
+    /* Looks up color pair by labels and handle */
+
+    int findPair(const std::string & fg_label,
+                 const std::string & bg_label) const;
+    int pairIndex(int handle) const;
+
     /* Translate string color (red, green, etc.) into ncurses variable */
 
     void baseColorName(const std::string & colorname, std::string & basename,
@@ -40,27 +54,26 @@ class Color {
 
     Color();
 
-    /* Create or access color pair by foreground & background colors */
+    /* Create color pair or get handle by foreground & background colors */
 
     void addPair(const std::string & fg_label, const std::string & fg_name,
                  const std::string & bg_label, const std::string & bg_name);
-    int getPair(const std::string & fg_label,
-                const std::string & bg_label) const;
+    int getPair(const std::string & fg_label, const std::string & bg_label);
 
     /* Bold / blink properties */
 
-    bool pairIsBold(int vec_idx) const;
-    bool pairBlinks(int vec_idx) const;
+    bool pairIsBold(int handle) const;
+    bool pairBlinks(int handle) const;
 
     /* Turn color setting on or off in window */
 
     int turnOn(WINDOW *win, const std::string & fg_label,
                const std::string & bg_label);
-    int turnOn(WINDOW *win, int vec_idx);
+    int turnOn(WINDOW *win, int handle);
     int turnOff(WINDOW *win);
     int setBackground(WINDOW *win, const std::string & fg_label,
                       const std::string & bg_label) const;
-    int setBackground(WINDOW *win, int vec_idx) const;
+    int setBackground(WINDOW *win, int handle) const;
 
     /* Clears all colors */
 
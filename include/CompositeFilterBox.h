@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ComboBox.h"
+#include "Label.h"
+#include "InputBox.h"
+
+/*******************************************************************************
+
+Dialog to combine filters, e.g. installed and not blacklisted and with build
+options set. Each filter can be required (yes), excluded (no), or ignored.
+
+*******************************************************************************/
+class CompositeFilterBox: public InputBox {
+
+  private:
+
+    static const unsigned int _nfilters = 6;
+    static const char *_filter_names[_nfilters];
+
+    ComboBox _matchbox;
+    ComboBox _filterboxes[_nfilters];
+    std::vector<Label *> _labels;
+
+    /* Adds a label */
+
+    void addLabel(const std::string & name, int posy);
+
+  public:
+
+    /* Constructor and destructor */
+
+    CompositeFilterBox();
+    ~CompositeFilterBox();
+
+    /* Get attributes */
+
+    bool matchAll() const;
+    void filters(std::vector<std::string> & include,
+                 std::vector<std::string> & exclude) const;
+    std::string description() const;
+};
@@ -21,6 +21,7 @@ class CursesWidget {
     virtual int highlightNextButton();
     virtual int highlightPreviousButton();
     virtual void redrawButtons();
+    void resolveColors();
 
     std::vector<std::string> _buttons;  // At the bottom, e.g. OK/Cancel
     std::vector<std::string> _button_signals;
@@ -33,6 +34,14 @@ class CursesWidget {
     std::string _button_fg, _button_bg;
     std::string _bg_color, _fg_color;   // Default colors
 
+    /* Color pair handles, resolved when colors are set so that drawing does
+       not look up color labels */
+
+    int _color_pair, _hotkey_pair, _tagged_pair, _title_pair, _button_pair;
+    int _highlight_active_pair, _highlight_inactive_pair;
+    int _tagged_active_pair, _tagged_inactive_pair;
+    int _hotkey_active_pair, _hotkey_inactive_pair;
+
     WINDOW *_win;
 
   public:
@@ -69,6 +78,12 @@ class CursesWidget {
     const std::string & fgColor() const;
     const std::string & bgColor() const;
 
+    /* Writes pending screen updates and reads a key. Widgets only stage
+       their windows with wnoutrefresh, so the terminal is written once per
+       input event. */
+
+    static int readKey();
+
     /* Mouse interaction */
 
     virtual std::string handleMouseEvent(MouseEvent * mevent) = 0;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+Dependency graph of all SlackBuilds in the repository. Nodes are numbered in
+the order of the SlackBuilds list (by category, then by name), and forward
+(requires) and reverse (required by) edges are stored in compressed arrays:
+the edges of node n are edges[offsets[n]] through edges[offsets[n+1]-1].
+Forward edges are kept in REQUIRES order. The graph only depends on repository
+data, so installed status is checked when traversing it.
+
+*******************************************************************************/
+class DepGraph {
+
+  private:
+
+    std::vector<BuildListItem *> _nodes;
+    std::vector<unsigned int> _cat_offsets;
+    std::vector<unsigned int> _fwd_offsets, _fwd_edges;
+    std::vector<unsigned int> _rev_offsets, _rev_edges;
+    std::vector<char> _info_missing, _req_missing;
+
+    /* Traversals used by reqsOrder and invReqs */
+
+    void visitReqs(unsigned int node, std::vector<bool> & visited,
+                   std::vector<BuildListItem *> & reqlist,
+                   int & maxcheck) const;
+    void visitInvReqs(unsigned int node, std::vector<bool> & visited,
+                      std::vector<BuildListItem *> & invreqlist) const;
+
+  public:
+
+    /* Constructor */
+
+    DepGraph();
+
+    /* Builds graph from list of SlackBuilds */
+
+    void build(std::vector<std::vector<BuildListItem> > & slackbuilds);
+    void clear();
+
+    /* Number of nodes and node ID for a SlackBuild. Returns 1 if not found. */
+
+    unsigned int size() const;
+    int nodeID(const std::string & name,
+               std::vector<std::vector<BuildListItem> > & slackbuilds,
+               unsigned int & node) const;
+
+    /* Requirements in build order and installed SlackBuilds depending on a
+       node */
+
+    int reqsOrder(unsigned int node,
+                  std::vector<BuildListItem *> & reqlist) const;
+    void invReqs(unsigned int node,
+                 std::vector<BuildListItem *> & invreqlist) const;
+
+    /* Installed SlackBuilds not required by any other installed SlackBuild */
+
+    void nonDeps(std::vector<BuildListItem *> & nondeplist) const;
+};
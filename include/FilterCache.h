@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include "BuildListItem.h"
+#include "BuildSet.h"
+
+/*******************************************************************************
+
+Cache of filters as BuildSets over the master list of SlackBuilds. Each filter
+is evaluated once and kept until it is invalidated because the state it
+depends on has changed. Filters are named as in the filter menu: All,
+Installed, Upgradable, Tagged, Blacklisted, Non-dependencies, and Build options
+set.
+
+*******************************************************************************/
+class FilterCache {
+
+  private:
+
+    std::vector<std::vector<BuildListItem> > *_slackbuilds;
+    unsigned int _nbuilds;
+    std::map<std::string, BuildSet> _sets;
+
+    /* Evaluates a filter */
+
+    int evaluate(const std::string & filter, BuildSet & set) const;
+
+  public:
+
+    /* Constructor */
+
+    FilterCache();
+
+    /* Sets master list and assigns build IDs. Clears the cache. */
+
+    void setBuilds(std::vector<std::vector<BuildListItem> > & slackbuilds);
+    unsigned int numBuilds() const;
+
+    /* Invalidates one or all cached filters */
+
+    void invalidate(const std::string & filter);
+    void invalidate();
+
+    /* Gets a filter. Returns 0 on success, 1 for an unknown filter. */
+
+    int get(const std::string & filter, BuildSet & set);
+
+    /* Combines filters. With match_all, SlackBuilds must match all filters
+       in include and none in exclude; otherwise, any one of them. Returns 0
+       on success, 1 if a filter is unknown. */
+
+    int combine(const std::vector<std::string> & include,
+                const std::vector<std::string> & exclude, bool match_all,
+                BuildSet & set);
+};
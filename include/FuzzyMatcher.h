@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+SlackBuild matching a fuzzy search: position in the lists and score
+
+*******************************************************************************/
+struct fuzzy_match {
+  unsigned int category;
+  unsigned int index;
+  int score;
+};
+
+/*******************************************************************************
+
+Fuzzy name matcher. A name matches if it contains the characters of the query
+in order, and it is scored higher for matches at the start of the name or of a
+word within it and for consecutive characters, and lower for gaps. Lower-case
+names are stored once in a contiguous buffer, along with a bit mask of the
+characters in each name, so that most names are ruled out with one AND and
+matching does not need to allocate.
+
+*******************************************************************************/
+class FuzzyMatcher {
+
+  private:
+
+    std::string _names;
+    std::vector<unsigned int> _offsets;
+    std::vector<uint64_t> _masks;
+    std::vector<unsigned int> _categories, _indices;
+
+    /* Scores one name, or returns -1 if it doesn't match */
+
+    int score(unsigned int idx, const std::string & query) const;
+
+  public:
+
+    /* Constructor */
+
+    FuzzyMatcher();
+
+    /* Stores names from lists */
+
+    void setItems(const std::vector<std::vector<BuildListItem *> > & lists);
+    void clear();
+    unsigned int size() const;
+
+    /* Finds best matches, sorted by decreasing score. Ties go to shorter
+       names and then to list order. Returns the number of names that match,
+       which may be more than max_results. */
+
+    unsigned int match(const std::string & query, unsigned int max_results,
+                       std::vector<fuzzy_match> & matches) const;
+};
@@ -20,7 +20,7 @@ class InstallBox: public BuildOrderBox {
        order, because it is easier to work with BuildListItems than ListItems
        for many of the operations. */
 
-    std::vector<BuildListItem *> _builds;
+    std::vector<BuildListItem *> _builds, _changed;
     int _ndeps, _ninvdeps;
 
     /* Drawing */
@@ -70,4 +70,8 @@ class InstallBox: public BuildOrderBox {
 
     int applyChanges(int & ninstalled, int & nupgraded, int & nreinstalled,
                      int & nremoved);
+
+    /* SlackBuilds that applyChanges attempted to change */
+
+    const std::vector<BuildListItem *> & changedBuilds() const;
 };
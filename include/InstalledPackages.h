@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/*******************************************************************************
+
+Parsed entry in the installed package list
+
+*******************************************************************************/
+struct installed_pkg {
+  std::string pkg;
+  std::string name;
+  std::string version;
+  std::string arch;
+  std::string build;
+};
+
+/*******************************************************************************
+
+Table of installed packages (not just the ones from the repo), keyed by package
+name. Package names are parsed once when the table is read, and entries can be
+refreshed individually after a package is installed, upgraded, or removed.
+
+*******************************************************************************/
+class InstalledPackages {
+
+  private:
+
+    std::unordered_map<std::string, installed_pkg> _table;
+    std::vector<std::string> _invalid;
+    std::string _path;
+
+    /* Checks whether an entry exists in the package directory */
+
+    bool entryExists(const std::string & pkg) const;
+
+  public:
+
+    /* Constructors */
+
+    InstalledPackages();
+    InstalledPackages(const std::string & path);
+
+    /* Reads the whole installed package list */
+
+    int read();
+
+    /* Re-reads entry for one package name, optionally checking the expected
+       package first */
+
+    int update(const std::string & name, const std::string & expected_pkg="");
+    void updateRemoved(const std::string & name);
+
+    /* Finds installed package by name. Returns NULL if not installed. */
+
+    const installed_pkg * find(const std::string & name) const;
+
+    /* List of all installed packages */
+
+    std::vector<const installed_pkg *> list() const;
+
+    /* Installed packages with badly formed names */
+
+    const std::vector<std::string> & invalid() const;
+
+    /* Number of installed packages with valid names */
+
+    unsigned int size() const;
+};
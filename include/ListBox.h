@@ -49,6 +49,7 @@ class ListBox: public AbstractListBox {
 
     /* Edit list */
 
+    void insertItem(unsigned int idx, ListItem *item);
     void removeItem(unsigned int idx);
     virtual void clearList();
 
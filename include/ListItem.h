@@ -8,7 +8,9 @@
 Basic class for an item that goes in a list box. Each item can have multiple
 properties and values, but it must at least have a name. Additional properties
 are stored as strings, but helper functions are included to set and get them via
-other types; e.g., addBoolProp, setBoolProp, and getBoolProp.
+other types; e.g., addBoolProp, setBoolProp, and getBoolProp. Derived classes
+may store some properties in their own typed fields by overriding the prop
+methods.
 
 *******************************************************************************/
 class ListItem {
@@ -40,6 +42,7 @@ class ListItem {
 
     ListItem();
     ListItem(const std::string & name);
+    virtual ~ListItem();
 
     // Set properties
 
@@ -50,16 +53,18 @@ class ListItem {
        is returned. By default it is set to -1. */
     void setHotKey(int hotkey); 
                                    
-    void addProp(const std::string & propname, const std::string & value);
-    void addBoolProp(const std::string & propname, bool value);
-    int setProp(const std::string & propname, const std::string & value);
-    int setBoolProp(const std::string & propname, bool value);
+    virtual void addProp(const std::string & propname,
+                         const std::string & value);
+    virtual void addBoolProp(const std::string & propname, bool value);
+    virtual int setProp(const std::string & propname,
+                        const std::string & value);
+    virtual int setBoolProp(const std::string & propname, bool value);
 
     // Get properties
 
     const std::string & name() const;
     int hotKey() const;
-    bool checkProp(const std::string & propname) const;
-    const std::string & getProp(const std::string & propname) const;
-    bool getBoolProp(const std::string & propname) const;
+    virtual bool checkProp(const std::string & propname) const;
+    virtual const std::string & getProp(const std::string & propname) const;
+    virtual bool getBoolProp(const std::string & propname) const;
 };
@@ -9,8 +9,10 @@
 #include "CategoryListBox.h"
 #include "BuildListItem.h"
 #include "BuildListBox.h"
+#include "BuildListView.h"
 #include "FilterBox.h"
 #include "SearchBox.h"
+#include "CompositeFilterBox.h"
 #include "InputBox.h"
 #include "TagList.h"
 #include "OptionsWindow.h"
@@ -18,6 +20,9 @@
 #include "MouseHelpWindow.h"
 #include "Menubar.h"
 #include "MouseEvent.h"
+#include "ChangeWatcher.h"
+#include "BuildSet.h"
+#include "FilterCache.h"
 
 /*******************************************************************************
 
@@ -30,20 +35,36 @@ class MainWindow: public CursesWidget {
 
     WINDOW *_win1, *_win2;
     CategoryListBox _clistbox;
-    std::vector<BuildListBox> _blistboxes;
+    BuildListBox _blistbox;
+    BuildListView _buildview;
     std::vector<std::vector<BuildListItem> > _slackbuilds;
     std::vector<std::vector<BuildListItem *> > _displayed_slackbuilds;
     std::vector<CategoryListItem> _categories;
     std::vector<CategoryListItem *> _displayed_categories;
+    std::vector<BuildListItem *> _changed_builds;
+    std::vector<std::string> _saved_tags;
     FilterBox _fbox;
     SearchBox _searchbox;
+    CompositeFilterBox _compositebox;
     TagList _taglist;
     OptionsWindow _options;
     KeyHelpWindow _help;
     MouseHelpWindow _mousehelp;
     Menubar _menubar;
+    ChangeWatcher _watcher;
     std::string _filter, _info, _status, _conf_file;
     unsigned int _category_idx, _activated_listbox;
+    unsigned int _shown_category, _shown_revision;
+    static const unsigned int _fuzzy_results;
+
+    // Filters as sets of build IDs. _displayed_set holds the SlackBuilds
+    // shown, and previous filters are kept so they can be restored.
+
+    FilterCache _filter_cache;
+    BuildSet _displayed_set;
+    std::vector<BuildSet> _prev_sets;
+    std::vector<std::string> _prev_filters;
+    static const unsigned int _max_filter_history;
 
     void printStatus(const std::string & msg, bool bold=false);
     void clearStatus();
@@ -58,11 +79,26 @@ class MainWindow: public CursesWidget {
     /* Clearing and setting up lists, etc. */
 
     void clearData();
+    void saveTags();
+    void restoreTags();
     int readLists(MouseEvent * mevent=NULL, bool interactive=true);
     void clearTags();
     void rebuild(MouseEvent * mevent=NULL);
+    void refreshLists(MouseEvent * mevent=NULL);
+    int patchLists();
     void resetDisplayedSlackBuilds();
 
+    /* List box showing the selected category of the list view */
+
+    BuildListBox & currentBuildList();
+    void saveListHighlight();
+
+    /* Filtering by sets */
+
+    void setFilter(const std::string & filter);
+    unsigned int filterBySet(const std::string & filter);
+    unsigned int showBuildSet(const BuildSet & set);
+
     /* Asks for confirmation and quits */
 
     void quit();
@@ -76,8 +112,12 @@ class MainWindow: public CursesWidget {
     void filterBlacklisted();
     void filterNonDeps();
     void filterBuildOptions();
+    void filterComposite();
+    void previousFilter();
     void filterSearch(const std::string & searchterm, bool case_sensitive=false,
-                      bool whole_whord=false, bool search_readmes=false);
+                      bool whole_whord=false, bool search_readmes=false,
+                      bool search_scripts=false, bool use_regex=false);
+    void filterFuzzy(const std::string & query);
 
     /* Displays options window */
 
@@ -87,10 +127,6 @@ class MainWindow: public CursesWidget {
 
     int showHelp(MouseEvent * mevent=NULL, bool mouse_help=false);
 
-    /* Sets taglist reference in BuildListBoxes */
-
-    void setTagList();
-
     /* Actions for a selected SlackBuild */
 
     void browseFiles(const BuildListItem & build, MouseEvent * mevent=NULL);
@@ -108,6 +144,11 @@ class MainWindow: public CursesWidget {
 
     int syncRepo(MouseEvent * mevent=NULL);
 
+    /* Watching for and applying changes made outside of sboui */
+
+    void startWatcher();
+    void applyExternalChanges(MouseEvent * mevent=NULL);
+
     /* Apply action to tagged SlackBuilds */
 
     void applyTags(const std::string & action, MouseEvent * mevent=NULL);
@@ -171,6 +212,7 @@ class MainWindow: public CursesWidget {
 
     void selectFilter(MouseEvent * mevent=NULL);
     void search(MouseEvent * mevent=NULL);
+    void combineFilters(MouseEvent * mevent=NULL);
     void showBuildActions(BuildListItem & build, bool limited_actions=false,
                           MouseEvent * mevent=NULL);
 
@@ -178,6 +220,10 @@ class MainWindow: public CursesWidget {
 
     void quickSearch();
 
+    /* Live search by name, filtering lists as the user types */
+
+    void liveSearch(bool fuzzy=false);
+
     /* Upgrade all */
 
     void upgradeAll(MouseEvent * mevent=NULL);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ctime>          // timespec
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+In-process version of the install and build commands of sboui-backend, for the
+built-in package manager. The SlackBuild directory, version, sources, and
+installed package are taken from what sboui has already read, instead of being
+looked up with find and by sourcing the .info file on every call. Only the
+SlackBuild script, upgradepkg, and downloads are run as child processes.
+Settings are read from sboui-backend.conf, and questions are asked the same way
+as sboui-backend does, with no as the answer if there is no input.
+
+*******************************************************************************/
+class NativeBackend {
+
+  private:
+
+    std::string _tmp, _output, _source_cache;
+    bool _clean_package, _clean_tmp, _clean_source;
+
+    /* Asks a y/n question */
+
+    bool askYesNo(const std::string & msg) const;
+
+    /* Gets sources into the SlackBuild directory */
+
+    bool sourceFromCache(const std::string & source, const std::string & md5,
+                         const std::string & builddir) const;
+    int fetchSources(const std::vector<std::string> & urls,
+                     const std::vector<std::string> & md5sums,
+                     const std::string & builddir,
+                     const std::string & sourcedir) const;
+    void removeSources(const std::vector<std::string> & urls,
+                       const std::string & builddir) const;
+
+    /* Finds the package made by a build */
+
+    int findPackage(const BuildListItem & build, const timespec & start,
+                    std::string & pkg) const;
+
+  public:
+
+    /* Constructor */
+
+    NativeBackend();
+
+    /* Reads settings from sboui-backend.conf, or the file given by the CONF
+       environment variable, and from the environment, including vars */
+
+    int readConfig(const std::string & vars="");
+
+    /* Builds a SlackBuild, with vars as extra environment variables. Sources
+       are copied from sourcedir if given, and the package is also copied to
+       pkgcache if given. Unless force or buildonly is set, asks before
+       rebuilding an installed SlackBuild. buildonly also gives the build a
+       private TMP directory. Returns 0 on success. pkg is the package built,
+       or "" if the user chose not to build it. */
+
+    int buildSlackBuild(const BuildListItem & build, const std::string & vars,
+                        const std::string & sourcedir,
+                        const std::string & pkgcache, bool force,
+                        bool buildonly, std::string & pkg) const;
+
+    /* Installs or upgrades a package. Unless keep is set, it is removed
+       afterwards if CLEAN_PACKAGE is yes. */
+
+    int installPackage(const std::string & pkg, bool keep=false) const;
+};
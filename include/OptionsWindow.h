@@ -22,7 +22,7 @@ class OptionsWindow: public InputBox {
     TextInput _repo_inp, _tag_inp, _sync_inp, _inst_inp, _upgr_inp, _reinst_inp;
     ToggleInput _resolve_toggle, _rebuild_toggle, _confirm_toggle,
                 _buildopts_toggle, _color_toggle, _warninval_toggle,
-                _cumfilt_toggle;
+                _cumfilt_toggle, _watch_toggle, _prefetch_toggle;
     Label _ui_settings, _color_settings, _pm_settings, _misc_settings;
     ComboBox _layout_box, _color_box, _pmgr_box;
 
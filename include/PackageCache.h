@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+Cache of packages built by the built-in package manager, keyed by a hash of
+everything that goes into a build: the files in the SlackBuild directory
+(except downloaded sources), the environment variables and build options it is
+run with, and the installed packages of all the SlackBuilds it requires,
+directly or indirectly. A SlackBuild whose inputs have not changed since it was
+last built can then be reinstalled from the cached package instead of being
+built again. Only the package from the latest successful build of each
+SlackBuild is kept.
+
+*******************************************************************************/
+class PackageCache {
+
+  private:
+
+    std::string _dir;
+
+    /* Adds contents of files in a directory to the hash */
+
+    void hashDir(uint64_t & hash, const std::string & path,
+                 const std::string & relpath,
+                 const std::vector<std::string> & sources) const;
+
+    /* Directory for one SlackBuild's cached package */
+
+    std::string entryDir(const BuildListItem & build,
+                         const std::string & key) const;
+
+  public:
+
+    /* Constructors */
+
+    PackageCache();
+    PackageCache(const std::string & dir);
+
+    /* Hash of build inputs, as hex string. vars are the environment
+       variables the build is run with, besides build options. */
+
+    std::string inputKey(const BuildListItem & build,
+                         const std::string & vars) const;
+
+    /* Cached package built from the given inputs, or "" if there is none */
+
+    std::string find(const BuildListItem & build,
+                     const std::string & key) const;
+
+    /* Directory in which to store the package built from the given inputs */
+
+    std::string storeDir(const BuildListItem & build,
+                         const std::string & key) const;
+
+    /* Removes packages cached for other inputs, once the package built from
+       the given inputs is in the cache */
+
+    void prune(const BuildListItem & build, const std::string & key) const;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>   // size_t
+
+/*******************************************************************************
+
+SlackBuild whose README matches a search, and how many times matching words
+appear in it
+
+*******************************************************************************/
+struct readme_match {
+  std::string category;
+  std::string name;
+  unsigned int count;
+};
+
+/*******************************************************************************
+
+Persistent inverted index of the words in all SlackBuild READMEs: for each
+word (lower case), the SlackBuilds whose README contains it and how many times.
+Words are split the same way as find_in_file does for whole-word searches, so
+that case-insensitive searches can be answered from the index alone. The index
+is built when the repository is synced (or the first time it is needed) and is
+keyed on the same repository state as RepoIndex.
+
+*******************************************************************************/
+class ReadmeIndex {
+
+  private:
+
+    std::string _path, _key;
+    void *_map;
+    size_t _size;
+    const char *_builds, *_terms, *_postings, *_strings;
+    unsigned int _nbuilds, _nterms;
+    unsigned long _npostings, _strings_len;
+
+    /* Access to mapped tables */
+
+    void termAt(unsigned int idx, const char *& term, size_t & len) const;
+    int findTerm(const std::string & term, unsigned int & idx) const;
+    void addPostings(unsigned int idx,
+                     std::vector<unsigned int> & counts) const;
+
+  public:
+
+    /* Constructors and destructor */
+
+    ReadmeIndex();
+    ReadmeIndex(const std::string & path);
+    ~ReadmeIndex();
+
+    /* Not copyable: a copy would unmap the same file again */
+
+    ReadmeIndex(const ReadmeIndex &) = delete;
+    ReadmeIndex & operator = (const ReadmeIndex &) = delete;
+
+    /* Location of index file */
+
+    void setPath(const std::string & path);
+    const std::string & path() const;
+
+    /* Whether the index file can be (re)written */
+
+    bool writable() const;
+
+    /* Reads all READMEs in the repository and writes index file */
+
+    int build() const;
+
+    /* Maps index file if it is present and up to date, or unmaps it */
+
+    int load();
+    void unload();
+
+    /* Whether an index is loaded and still matches the repository */
+
+    bool current() const;
+
+    /* Searches index. Returns 0 if the matches are exact, or 1 if they are
+       only candidates that must still be checked with find_in_file. */
+
+    int search(const std::string & pattern, bool whole_word,
+               bool case_sensitive, std::vector<readme_match> & matches) const;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+Persistent, memory-mappable index of the SlackBuilds repository. Stores name,
+category, VERSION, REQUIRES, and BUILD for every SlackBuild so that startup
+does not need to walk the repo tree and parse every .info file. The index is
+keyed on the git HEAD of the repository (if any), the modification times of the
+top-level and category directories, and the time of the last sync.
+
+*******************************************************************************/
+class RepoIndex {
+
+  private:
+
+    std::string _path;
+
+  public:
+
+    /* Constructors */
+
+    RepoIndex();
+    RepoIndex(const std::string & path);
+
+    /* Computes key describing current state of the repository. Also used to
+       check other indexes built from the repository. */
+
+    std::string computeKey() const;
+
+    /* Location of index file */
+
+    void setPath(const std::string & path);
+    const std::string & path() const;
+
+    /* Whether the index file can be (re)written */
+
+    bool writable() const;
+
+    /* Loads SlackBuilds from index file if it is present and up to date */
+
+    int load(std::vector<std::vector<BuildListItem> > & slackbuilds) const;
+
+    /* Writes index file from SlackBuilds list */
+
+    int write(const std::vector<std::vector<BuildListItem> > & slackbuilds,
+              const std::vector<std::string> & categories) const;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+
+Category directory in the repository and the SlackBuild directories in it
+
+*******************************************************************************/
+struct repo_category {
+  std::string name;
+  std::vector<std::string> builds;
+};
+
+/*******************************************************************************
+
+Scans the SlackBuilds repository tree. Directories are opened relative to the
+repository directory's file descriptor, and categories are scanned in parallel.
+Categories and the SlackBuilds in each are sorted by name, the same order that
+DirListing gives.
+
+*******************************************************************************/
+class RepoScanner {
+
+  private:
+
+    std::string _path;
+    int _max_threads;
+
+  public:
+
+    /* Constructors */
+
+    RepoScanner();
+    RepoScanner(const std::string & path);
+
+    /* Repository directory and maximum number of threads used to scan it */
+
+    void setPath(const std::string & path);
+    void setMaxThreads(int max_threads);
+
+    /* Scans repository */
+
+    int scan(std::vector<repo_category> & categories) const;
+};
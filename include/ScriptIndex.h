@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>   // size_t
+#include <stdint.h>
+#include "ScriptSearch.h"
+
+/*******************************************************************************
+
+Persistent trigram index over all files in each SlackBuild directory: for each
+sequence of three bytes (ASCII letters in lower case), the SlackBuilds that
+contain it in some file. Searches use it to narrow down the SlackBuilds whose
+files must be read. Each SlackBuild is stored with a signature of its files, so
+that rebuilding the index only reads SlackBuilds that have changed.
+
+*******************************************************************************/
+class ScriptIndex {
+
+  private:
+
+    std::string _path, _key;
+    void *_map;
+    size_t _size;
+    const char *_builds, *_trigrams, *_postings, *_strings;
+    unsigned int _nbuilds, _ntrigrams;
+    unsigned long _npostings, _strings_len;
+
+    /* Maps index file, optionally checking that it is up to date */
+
+    int map(bool check_key);
+
+    /* Access to mapped tables */
+
+    std::string buildKey(unsigned int idx) const;
+    uint64_t signatureAt(unsigned int idx) const;
+    int findTrigram(uint32_t trigram, unsigned int & idx) const;
+    void postingsAt(unsigned int idx, std::vector<uint32_t> & builds) const;
+
+  public:
+
+    /* Constructors and destructor */
+
+    ScriptIndex();
+    ScriptIndex(const std::string & path);
+    ~ScriptIndex();
+
+    /* Not copyable: a copy would unmap the same file again */
+
+    ScriptIndex(const ScriptIndex &) = delete;
+    ScriptIndex & operator = (const ScriptIndex &) = delete;
+
+    /* Location of index file */
+
+    void setPath(const std::string & path);
+    const std::string & path() const;
+
+    /* Whether the index file can be (re)written */
+
+    bool writable() const;
+
+    /* Writes index file, reading only SlackBuilds that changed since the
+       existing index file was written */
+
+    int build() const;
+
+    /* Maps index file if it is present and up to date, or unmaps it */
+
+    int load();
+    void unload();
+
+    /* Whether an index is loaded and still matches the repository */
+
+    bool current() const;
+
+    /* SlackBuilds (as category/name) whose files may match a search. Returns
+       1 if the search has no trigrams to look up, so that all SlackBuilds are
+       candidates, or 0 otherwise. */
+
+    int candidates(const ScriptSearch & query,
+                   std::vector<std::string> & builds) const;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <ctime>      // time_t
+
+/*******************************************************************************
+
+File in a SlackBuild directory, relative to that directory
+
+*******************************************************************************/
+struct build_file {
+  std::string path;
+  unsigned long size;
+  time_t mtime_sec;
+  long mtime_nsec;
+};
+
+/*******************************************************************************
+
+Lists regular files in a SlackBuild directory and its subdirectories, sorted
+by path. Hidden files are skipped. Returns 1 if the directory can't be read.
+
+*******************************************************************************/
+int list_build_files(const std::string & builddir,
+                     std::vector<build_file> & files);
+
+/*******************************************************************************
+
+Search for a pattern in all files of SlackBuild directories. The pattern is
+either a substring or an ECMAScript regular expression, which is matched line
+by line. Also gives the literal strings that any match must contain, so that
+ScriptIndex can rule out SlackBuilds without reading their files.
+
+*******************************************************************************/
+class ScriptSearch {
+
+  private:
+
+    std::string _pattern, _lowerpattern;
+    bool _whole_word, _case_sensitive, _use_regex, _valid;
+    std::regex _regex;
+
+    /* Matching */
+
+    bool substringMatches(const std::string & contents) const;
+    bool regexMatches(const std::string & contents) const;
+
+  public:
+
+    /* Constructors */
+
+    ScriptSearch();
+    ScriptSearch(const std::string & pattern, bool whole_word,
+                 bool case_sensitive, bool use_regex);
+
+    /* Sets pattern. Returns 1 if it is not a valid regular expression. */
+
+    int setPattern(const std::string & pattern, bool whole_word,
+                   bool case_sensitive, bool use_regex);
+    bool valid() const;
+
+    /* Lower-case strings that every match must contain */
+
+    void requiredStrings(std::vector<std::string> & strs) const;
+
+    /* Checks a file or all files in a SlackBuild directory for a match */
+
+    bool matchesFile(const std::string & filename) const;
+    bool matchesBuild(const std::string & builddir) const;
+};
@@ -15,7 +15,8 @@ class SearchBox: public InputBox {
   private:
 
     TextInput _entryitem;
-    ToggleInput _caseitem, _wholeitem, _readmeitem, _currentlistitem;
+    ToggleInput _caseitem, _wholeitem, _readmeitem, _scriptitem, _regexitem;
+    ToggleInput _fuzzyitem, _currentlistitem;
 
     /* Drawing */
 
@@ -38,5 +39,8 @@ class SearchBox: public InputBox {
     bool caseSensitive() const;
     bool wholeWord() const;
     bool searchREADMEs() const;
+    bool searchScripts() const;
+    bool regex() const;
+    bool fuzzy() const;
     bool currentList() const;
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "BuildListItem.h"
+
+/*******************************************************************************
+
+Incremental name search for search-as-you-type. The match set of each query is
+cached, so a query extending a cached one only checks that query's matches,
+and deleting characters returns a cached result without searching.
+
+*******************************************************************************/
+class SearchSession {
+
+  private:
+
+    std::string _names;
+    std::vector<unsigned int> _offsets;
+    std::vector<unsigned int> _categories, _indices;
+    std::vector<std::string> _queries;
+    std::vector<std::vector<unsigned int> > _results;
+    std::vector<unsigned int> _last;
+
+    /* Searching */
+
+    void searchAll(const std::string & query,
+                   std::vector<unsigned int> & result) const;
+    void narrow(const std::string & query,
+                const std::vector<unsigned int> & parent,
+                std::vector<unsigned int> & result) const;
+
+  public:
+
+    /* Constructor */
+
+    SearchSession();
+
+    /* Starts a new session on lists */
+
+    void start(const std::vector<std::vector<BuildListItem *> > & lists);
+    void clear();
+
+    /* Updates matches for query. Returns 1 if they changed since the last
+       update, 0 if not. */
+
+    int update(const std::string & query);
+
+    /* Matches from the last update, in list order */
+
+    unsigned int numMatches() const;
+    unsigned int category(unsigned int match) const;
+    unsigned int index(unsigned int match) const;
+    int bestMatch(const std::string & query) const;
+};
@@ -1,28 +1,38 @@
 #pragma once
 
 #include <string>
-#include <fstream>
+#include <vector>
 
 /*******************************************************************************
 
-Reads shell variables in a file
+Reads shell variables in a file. The file is memory-mapped, and lines are
+parsed in place as pointer ranges, so reading does not copy or allocate per
+line.
 
 *******************************************************************************/
 class ShellReader {
 
   private:
 
-    std::ifstream _file;
+    const char *_data;
+    std::size_t _size, _pos;
     bool _file_open;
 
-    // Check if variable name is found
+    // Gets the next line as the range [begin, end). Returns false at the end
+    // of the file.
 
-    bool checkVarname(std::string & line, const std::string & varname) const;
+    bool nextLine(const char *& begin, const char *& end);
+
+    // Check if variable name is found, and if so moves begin past 'varname='
+
+    bool checkVarname(const char *& begin, const char *& end,
+                      const std::string & varname) const;
 
     // Reads value of variable from file
 
-    int readVariable(std::string & line, std::string & value);
-    int readDefaultVariable(std::string & line, std::string & value);
+    int readVariable(const char *begin, const char *end, std::string & value);
+    int readDefaultVariable(const char *begin, const char *end,
+                            std::string & value) const;
 
   public:
 
@@ -31,6 +41,11 @@ class ShellReader {
     ShellReader();
     ~ShellReader();
 
+    /* Not copyable: a copy would unmap the same file again */
+
+    ShellReader(const ShellReader &) = delete;
+    ShellReader & operator = (const ShellReader &) = delete;
+
     /* Opens or closes a file */
 
     int open(const std::string & filename);
@@ -41,6 +56,12 @@ class ShellReader {
     int read(const std::string & varname, std::string & value,
              bool default_var=false);
 
+    /* Reads several variables in a single pass through the file */
+
+    int read(const std::vector<std::string> & varnames,
+             std::vector<std::string> & values,
+             const std::vector<bool> & default_vars);
+
     /* Rewinds to beginning of the file */
 
     int rewind();
@@ -5,11 +5,17 @@
 #include <cmath>   // floor
 #include "BuildListItem.h"
 #include "Blacklist.h"
+#include "InstalledPackages.h"
 
 extern Blacklist blacklist;
+extern InstalledPackages installed_packages;
 
 int read_repo(std::vector<std::vector<BuildListItem> > & slackbuilds);
 int read_buildopts(std::vector<std::vector<BuildListItem> > & slackbuilds);
+void update_buildopts(BuildListItem & build);
+void index_slackbuilds(std::vector<std::vector<BuildListItem> > & slackbuilds);
+int indexed_reqs_order(const BuildListItem & build,
+                       std::vector<BuildListItem *> & reqlist);
 int find_slackbuild(const std::string & name,
                     std::vector<std::vector<BuildListItem> > & slackbuilds,
                     int & idx0, int & idx1);
@@ -17,7 +23,7 @@ int get_pkg_info(const std::string & pkg, std::string & name,
                  std::string & version, std::string & arch,
                  std::string & build);
 bool check_installed(const BuildListItem & build, 
-                     const std::vector<std::string> & installedpkgs,
+                     const InstalledPackages & installedpkgs,
                      std::string & pkg, std::string & version,
                      std::string & arch, std::string & pkgbuild);
 int get_reqs(const BuildListItem & build, std::string & reqs);
@@ -34,10 +40,27 @@ int install_slackbuild(BuildListItem & build);
 int upgrade_slackbuild(BuildListItem & build); 
 int reinstall_slackbuild(BuildListItem & build); 
 int remove_slackbuild(BuildListItem & build);
+int get_sources(const BuildListItem & build, std::vector<std::string> & urls,
+                std::vector<std::string> & md5sums, bool force32=false);
+std::string build_slackbuild_cmd(const BuildListItem & build,
+                                 const std::string & pkgfile,
+                                 const std::string & sourcedir="",
+                                 const std::string & cacheopt="");
+std::string find_cached_package(const BuildListItem & build,
+                                const std::string & vars,
+                                std::string & cacheopt, bool rebuild=false);
+void prune_cached_packages(const BuildListItem & build,
+                           const std::string & cacheopt);
+int install_built_package(BuildListItem & build, const std::string & pkg,
+                          bool cached=false);
+int run_command(const std::string & cmd);
+bool native_command(const std::string & cmd);
 int view_readme(const BuildListItem & build);
 int view_file(const std::string & path);
 int view_notes(const BuildListItem & build);
 int sync_repo(bool interactive=true);
+int source_cache_stats();
+int prune_source_cache();
 
 /*******************************************************************************
 
@@ -6,7 +6,10 @@
 #include "BuildListItem.h"
 #include "CategoryListItem.h"
 #include "CategoryListBox.h"
-#include "BuildListBox.h"
+#include "BuildListView.h"
+#include "FuzzyMatcher.h"
+#include "SearchSession.h"
+#include "BuildSet.h"
 
 bool any_build(const BuildListItem & build);
 bool build_is_installed(const BuildListItem & build);
@@ -18,19 +21,33 @@ bool build_has_buildoptions(const BuildListItem & build);
 void filter_by_func(std::vector<std::vector<BuildListItem *> > & slackbuilds,
                     bool (*func)(const BuildListItem &),
                     std::vector<CategoryListItem *> & categories,
-                    WINDOW *blistboxwin, CategoryListBox & clistbox,
-                    std::vector<BuildListBox> & blistboxes,
+                    CategoryListBox & clistbox, BuildListView & view,
                     unsigned int & nfiltered, bool overwrite=true);
-void filter_nondeps(std::vector<std::vector<BuildListItem> > & all_slackbuilds,
-                    std::vector<std::vector<BuildListItem *> > & slackbuilds,
-                    std::vector<CategoryListItem *> & categories,
-                    WINDOW *blistboxwin, CategoryListBox & clistbox,
-                    std::vector<BuildListBox> & blistboxes,
-                    unsigned int & nnondeps, bool overwrite=true);
 void filter_search(std::vector<std::vector<BuildListItem *> > & slackbuilds,
                    std::vector<CategoryListItem *> & categories,
-                   WINDOW *blistboxwin, CategoryListBox & clistbox,
-                   std::vector<BuildListBox> & blistboxes,
+                   CategoryListBox & clistbox, BuildListView & view,
                    unsigned int & nsearch, const std::string & searchterm,
                    bool case_sensitive, bool whole_word, bool search_readmes,
-                   bool overwrite=true);
+                   bool search_scripts=false, bool use_regex=false,
+                   bool overwrite=true, BuildListItem **best_match=NULL);
+void filter_fuzzy(std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                  std::vector<CategoryListItem *> & categories,
+                  CategoryListBox & clistbox, BuildListView & view,
+                  unsigned int & nmatches, const FuzzyMatcher & matcher,
+                  const std::string & query, unsigned int max_results,
+                  bool overwrite=true, BuildListItem **best_match=NULL);
+void filter_session(std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                    std::vector<CategoryListItem *> & categories,
+                    CategoryListBox & clistbox, BuildListView & view,
+                    unsigned int & nmatches, const SearchSession & session,
+                    const std::string & query, bool overwrite=true,
+                    BuildListItem **best_match=NULL);
+void filter_by_set(std::vector<std::vector<BuildListItem> > & all_slackbuilds,
+                   std::vector<CategoryListItem> & all_categories,
+                   const BuildSet & set,
+                   std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                   std::vector<CategoryListItem *> & categories,
+                   CategoryListBox & clistbox, BuildListView & view,
+                   unsigned int & nfiltered, bool overwrite=true);
+void list_build_set(const BuildListView & view, unsigned int nbuilds,
+                    BuildSet & set);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <cstddef>   // size_t
+#include <stdint.h>
+
+/*******************************************************************************
+
+Helpers shared by the on-disk indexes (RepoIndex, ReadmeIndex, ScriptIndex).
+Strings are stored in one blob at the end of each index file, and the tables
+refer to them by offset and length relative to the start of the blob. The
+FNV-1a hash is also used for PackageCache keys.
+
+*******************************************************************************/
+struct index_string {
+  uint32_t offset;
+  uint32_t len;
+};
+
+extern index_string index_add_string(std::string & blob,
+                                     const std::string & str);
+extern int index_get_string(const char *blob, uint64_t blob_len,
+                            const index_string & istr, std::string & str);
+extern bool index_writable(const std::string & path);
+
+const uint64_t index_hash_basis = 14695981039346656037ULL;
+extern void index_hash_bytes(uint64_t & hash, const void *data,
+                             std::size_t len);
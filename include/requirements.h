@@ -2,6 +2,11 @@
 
 #include <vector>
 #include "BuildListItem.h"
+#include "DepGraph.h"
+
+void reset_dep_graph();
+const DepGraph & get_dep_graph(
+                        std::vector<std::vector<BuildListItem> > & slackbuilds);
 
 int compute_reqs_order(const BuildListItem & build,
                        std::vector<BuildListItem *> & reqlist,
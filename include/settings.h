@@ -21,6 +21,9 @@ namespace settings
   extern std::string layout;
   extern bool resolve_deps, confirm_changes, enable_color, rebuild_inv_deps;
   extern bool save_buildopts, warn_invalid_pkgnames, cumulative_filters;
+  extern bool watch_changes, prefetch_sources, native_backend;
+  extern int build_jobs;
+  extern std::string package_cache;
 }
 
 extern Color colors;
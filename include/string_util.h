@@ -13,8 +13,13 @@ extern std::string remove_comment(const std::string & instr,
                                   char comment='#');
 extern std::vector<std::string> split(const std::string & instr,
                                       char delim=' ');
+extern std::string shell_quote(const std::string & instr);
 extern std::vector<std::string> wrap_words(const std::string & instr,
                                            unsigned int width);
 extern bool find_in_file(const std::string & pattern,
                          const std::string & filename, bool whole_word=false,
                          bool case_sensitive=false);
+extern void find_in_files(const std::string & pattern,
+                          const std::vector<std::string> & filenames,
+                          std::vector<char> & found, bool whole_word=false,
+                          bool case_sensitive=false);
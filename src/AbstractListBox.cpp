@@ -13,7 +13,7 @@ Draws window border and title
 *******************************************************************************/
 void AbstractListBox::redrawFrame()
 {
-  int rows, cols, namelen, i, left, color_pair;
+  int rows, cols, namelen, left;
   double mid;
 
   getmaxyx(_win, rows, cols);
@@ -25,8 +25,7 @@ void AbstractListBox::redrawFrame()
   left = std::floor(mid - double(namelen)/2.0);
   wmove(_win, 1, 1);
   wclrtoeol(_win);
-  color_pair = colors.getPair("fg_title", "bg_title");
-  if (colors.turnOn(_win, color_pair) != 0)
+  if (colors.turnOn(_win, _title_pair) != 0)
     wattron(_win, A_BOLD);
   printSpaces(left-1);
   printToEol(_name);
@@ -46,12 +45,11 @@ void AbstractListBox::redrawFrame()
 
   // Top border
 
-  wmove(_win, 0, 1);
-  for ( i = 1; int(i) < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, 0, 1, ACS_HLINE, cols-2);
   
   // Left border
 
-  for ( i = 1; i < rows-1; i++ ) { mvwaddch(_win, i, 0, ACS_VLINE); }
+  mvwvline(_win, 1, 0, ACS_VLINE, rows-2);
 
   // Right border for header (footer only if there are buttons - below)
 
@@ -59,22 +57,19 @@ void AbstractListBox::redrawFrame()
 
   // Divider for header (footer only if there are buttons - below)
 
-  wmove(_win, 2, 1);
-  for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, 2, 1, ACS_HLINE, cols-2);
   mvwaddch(_win, 2, 0, ACS_LTEE);
   mvwaddch(_win, 2, cols-1, ACS_RTEE);
 
   // Bottom border
 
-  wmove(_win, rows-1, 1);
-  for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, rows-1, 1, ACS_HLINE, cols-2);
 
   // Button area
 
   if (_buttons.size() > 0)
   {
-    wmove(_win, rows-3, 1);
-    for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+    mvwhline(_win, rows-3, 1, ACS_HLINE, cols-2);
     mvwaddch(_win, rows-3, 0, ACS_LTEE);
     mvwaddch(_win, rows-3, cols-1, ACS_RTEE);
     mvwaddch(_win, rows-2, cols-1, ACS_VLINE);
@@ -96,7 +91,7 @@ void AbstractListBox::redrawAllItems()
 
   if (_items.size() == 0)
   {
-    wrefresh(_win);
+    wnoutrefresh(_win);
     return;
   }
   for ( i = _firstprint; i < _firstprint+rowsavail; i++ )
@@ -138,6 +133,13 @@ Edit list items
 
 *******************************************************************************/
 void AbstractListBox::addItem(ListItem *item) { _items.push_back(item); }
+void AbstractListBox::insertItem(unsigned int idx, ListItem *item)
+{
+  if (idx <= _items.size()) { _items.insert(_items.begin()+idx, item); }
+  _firstprint = 0;
+  _redraw_type = "all";
+}
+
 void AbstractListBox::removeItem(unsigned int idx)
 {
   if (idx <= _items.size()) { _items.erase(_items.begin()+idx); }
@@ -260,7 +262,7 @@ void AbstractListBox::draw(bool force)
   if (_redraw_type == "all")
   { 
     clearWindow();
-    colors.setBackground(_win, _fg_color, _bg_color);
+    colors.setBackground(_win, _color_pair);
   }
   if (_redraw_type == "buttons") { redrawButtons(); }
   else if (_redraw_type != "none")
@@ -270,6 +272,6 @@ void AbstractListBox::draw(bool force)
   }
   if ( (_redraw_type == "all") || (_redraw_type == "items")) { 
                                                             redrawAllItems(); }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
@@ -2,16 +2,56 @@
 #include <vector>
 #include <fstream>
 #include <regex>
+#include <unordered_set>
+#include <unordered_map>
 #include "string_util.h"
 #include "backend.h"
 #include "Blacklist.h"
 
 /*******************************************************************************
 
+Checks whether a pattern has no regex special characters, so that it only
+matches itself
+
+*******************************************************************************/
+bool blacklist_literal(const std::string & pattern)
+{
+  return (pattern.find_first_of("\\^$.|?*+()[]{}") == std::string::npos);
+}
+
+/*******************************************************************************
+
+Checks whether a pattern has backreferences (\1 through \9)
+
+*******************************************************************************/
+bool blacklist_backref(const std::string & pattern)
+{
+  std::size_t pos;
+
+  pos = pattern.find('\\');
+  while (pos != std::string::npos)
+  {
+    if (pos+1 >= pattern.size()) { break; }
+    if ( (pattern[pos+1] >= '1') && (pattern[pos+1] <= '9') ) { return true; }
+    pos = pattern.find('\\', pos+2);
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+
 Constructor
 
 *******************************************************************************/
-Blacklist::Blacklist() { _patterns.resize(0); }
+Blacklist::Blacklist()
+{
+  _literals.clear();
+  _regex_patterns.resize(0);
+  _patterns.resize(0);
+  _have_combined = false;
+  _cache.clear();
+}
 
 /*******************************************************************************
 
@@ -28,69 +68,118 @@ int Blacklist::read(const std::string & filename)
 
   while (! file.eof())
   {
-    std::getline(file, line); 
+    std::getline(file, line);
     line = remove_leading_whitespace(line);
     if (line[0] == '#') { continue; }
     line = remove_comment(line, '#');
     line = trim(line);
-    if (line.size() > 0)
+    if (line.size() == 0) { continue; }
+    if (blacklist_literal(line)) { _literals.insert(line); }
+    else if (blacklist_backref(line))
     {
       std::regex reg(line);
       _patterns.push_back(reg);
     }
+    else { _regex_patterns.push_back(line); }
   }
 
   file.close();
+  compile();
 
   return 0;
 }
 
 /*******************************************************************************
 
-Checks installed package for matches in name, version, arch, build, and fullname
+Compiles regex patterns into a single alternation. Each pattern is grouped, so
+that regex_match on the combined regex matches if any one pattern matches the
+whole string.
 
 *******************************************************************************/
-bool Blacklist::blacklisted(const std::string & pkg) const
+void Blacklist::compile()
 {
-  std::string name, version, arch, build;
+  std::string combined;
   unsigned int i, npatterns;
 
-  get_pkg_info(pkg, name, version, arch, build);
+  _cache.clear();
+  npatterns = _regex_patterns.size();
+  _have_combined = (npatterns > 0);
+  if (! _have_combined) { return; }
 
-  // Check for blacklist pattern matching info in package name
+  for ( i = 0; i < npatterns; i++ )
+  {
+    if (i > 0) { combined += "|"; }
+    combined += "(?:" + _regex_patterns[i] + ")";
+  }
+  _combined.assign(combined, std::regex::ECMAScript | std::regex::nosubs);
+}
+
+/*******************************************************************************
+
+Checks one string for a match with any pattern. May be called from multiple
+threads.
+
+*******************************************************************************/
+bool Blacklist::matches(const std::string & str) const
+{
+  std::unordered_map<std::string, bool>::const_iterator it;
+  unsigned int i, npatterns;
+  bool found, match;
+
+  found = false;
+  match = false;
 
+  if (_literals.find(str) != _literals.end()) { return true; }
+  if ( (! _have_combined) && (_patterns.size() == 0) ) { return false; }
+
+#pragma omp critical(blacklist_cache)
+  {
+    it = _cache.find(str);
+    found = (it != _cache.end());
+    if (found) { match = it->second; }
+  }
+  if (found) { return match; }
+
+  if (_have_combined) { match = std::regex_match(str, _combined); }
   npatterns = _patterns.size();
-  for ( i = 0; i < npatterns; i++ )
+  for ( i = 0; (! match) && (i < npatterns); i++ )
   {
-    if (std::regex_match(name, _patterns[i])) { return true; }
-    if (std::regex_match(version, _patterns[i])) { return true; }
-    if (std::regex_match(arch, _patterns[i])) { return true; }
-    if (std::regex_match(build, _patterns[i])) { return true; }
-    if (std::regex_match(pkg, _patterns[i])) { return true; }
+    match = std::regex_match(str, _patterns[i]);
   }
 
-  return false;
+#pragma omp critical(blacklist_cache)
+  { _cache[str] = match; }
+
+  return match;
+}
+
+/*******************************************************************************
+
+Checks installed package for matches in name, version, arch, build, and fullname
+
+*******************************************************************************/
+bool Blacklist::blacklisted(const std::string & pkg) const
+{
+  std::string name, version, arch, build;
+
+  get_pkg_info(pkg, name, version, arch, build);
+
+  return blacklisted(pkg, name, version, arch, build);
 }
 
 bool Blacklist::blacklisted(const std::string & pkg, const std::string & name,
                           const std::string & version, const std::string & arch,
                           const std::string & build) const
 {
-  unsigned int i, npatterns;
-
   // Check for blacklist pattern matching info in package name
 
-  npatterns = _patterns.size();
-  for ( i = 0; i < npatterns; i++ )
-  {
-    if (std::regex_match(name, _patterns[i])) { return true; }
-    if (std::regex_match(version, _patterns[i])) { return true; }
-    if (std::regex_match(arch, _patterns[i])) { return true; }
-    if (std::regex_match(build, _patterns[i])) { return true; }
-    if (std::regex_match(pkg, _patterns[i])) { return true; }
-  }
+  return ( matches(name) || matches(version) || matches(arch) ||
+           matches(build) || matches(pkg) );
+}
 
-  return false;
+bool Blacklist::blacklisted(const installed_pkg & pkg) const
+{
+  return blacklisted(pkg.pkg, pkg.name, pkg.version, pkg.arch, pkg.build);
 }
 
 /*******************************************************************************
@@ -100,13 +189,5 @@ Checks for match by name only (used for not-installed SlackBuilds)
 *******************************************************************************/
 bool Blacklist::nameBlacklisted(const std::string & name) const
 {
-  unsigned int i, npatterns;
-
-  npatterns = _patterns.size();
-  for ( i = 0; i < npatterns; i++ )
-  {
-    if (std::regex_match(name, _patterns[i])) { return true; }
-  }
-
-  return false;
+  return matches(name);
 }
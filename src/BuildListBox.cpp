@@ -7,6 +7,7 @@
 #include "signals.h"
 #include "TagList.h"
 #include "BuildListItem.h"
+#include "BuildListView.h"
 #include "BuildListBox.h"
 
 /*******************************************************************************
@@ -45,10 +46,8 @@ void BuildListBox::redrawFrame()
 
   // Top border
 
-  wmove(_win, 0, 1);
-  for ( i = 1; int(i) < left-1; i++ ) { waddch(_win, ACS_HLINE); }
-  wmove(_win, 0, right+1);
-  for ( i = right+1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, 0, 1, ACS_HLINE, left-2);
+  mvwhline(_win, 0, right+1, ACS_HLINE, cols-2-right);
 
   // Right border for header
 
@@ -56,12 +55,11 @@ void BuildListBox::redrawFrame()
   
   // Left border
 
-  for ( i = 1; i < rows-1; i++ ) { mvwaddch(_win, i, 0, ACS_VLINE); }
+  mvwvline(_win, 1, 0, ACS_VLINE, rows-2);
 
   // Bottom border
 
-  wmove(_win, rows-1, 1);
-  for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, rows-1, 1, ACS_HLINE, cols-2);
 
   // Draw header
 
@@ -76,13 +74,12 @@ void BuildListBox::redrawFrame()
 
   colors.turnOn(_win, "header", "bg_normal");
   printToEol("Installed");
-  wmove(_win, 2, 1);
   colors.turnOff(_win);
 
   // Draw horizontal and then vertical line
 
-  for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
-  for ( i = 3; i < rows-1; i++ ) { mvwaddch(_win, i, vlineloc, ACS_VLINE); }
+  mvwhline(_win, 2, 1, ACS_HLINE, cols-2);
+  mvwvline(_win, 3, vlineloc, ACS_VLINE, rows-4);
 
   // Draw connections between horizontal and vertical lines
 
@@ -100,8 +97,8 @@ screen or not.
 *******************************************************************************/
 void BuildListBox::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
-  int nspaces, vlineloc, printlen, rows, cols, i, nast;
+  int nspaces, vlineloc, printlen, rows, cols, i, nast, color_pair;
+  bool tagged;
 
   getmaxyx(_win, rows, cols);
 
@@ -117,34 +114,32 @@ void BuildListBox::redrawSingleItem(unsigned int idx)
 
   // Turn on highlight color
 
+  tagged = _items[idx]->getBoolProp("tagged");
   if (int(idx) == _highlight)
   {
     if (_activated) 
     { 
-      if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-      else { fg = "fg_highlight_active"; }
-      bg = "bg_highlight_active"; 
+      if (tagged) { color_pair = _tagged_active_pair; }
+      else { color_pair = _highlight_active_pair; }
     }
     else
     {
-      if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-      else { fg = "fg_highlight_inactive"; }
-      bg = "bg_highlight_inactive"; 
+      if (tagged) { color_pair = _tagged_inactive_pair; }
+      else { color_pair = _highlight_inactive_pair; }
     }
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); } 
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   } 
   else
   {
-    if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-    else { fg = "fg_normal"; }
-    bg = "bg_normal";
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (tagged) { color_pair = _tagged_pair; }
+    else { color_pair = _color_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     {
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); } 
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   }
 
@@ -228,6 +223,35 @@ bool BuildListBox::allTagged() const
 
 /*******************************************************************************
 
+Shows one category of a list view, copying only that category's SlackBuilds
+and restoring its saved highlight. An empty list is shown if the category is
+not in the view.
+
+*******************************************************************************/
+void BuildListBox::setView(const BuildListView & view, unsigned int category)
+{
+  unsigned int i, nbuilds;
+
+  _items.resize(0);
+  _firstprint = 0;
+  _highlight = 0;
+  _prevhighlight = 0;
+  _redraw_type = "all";
+  if (category >= view.numCategories())
+  {
+    _name = "SlackBuilds";
+    return;
+  }
+
+  _name = view.category(category)->name();
+  nbuilds = view.numBuilds(category);
+  _items.reserve(nbuilds);
+  for ( i = 0; i < nbuilds; i++ ) { _items.push_back(view.build(category, i)); }
+  if (nbuilds > 0) { setHighlight(int(view.highlight(category))); }
+}
+
+/*******************************************************************************
+
 Sets a pointer to the tag list
 
 *******************************************************************************/
@@ -318,7 +342,7 @@ std::string BuildListBox::exec(MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = readKey()) {
 
     // Enter key: accept selection
 
@@ -438,6 +462,13 @@ std::string BuildListBox::exec(MouseEvent * mevent)
         return signals::nullEvent;
       break;
 
+    // No input before timeout (only if a timeout has been set with timeout())
+
+    case ERR:
+      retval = signals::nullEvent;
+      _redraw_type = "none";
+      break;
+
     default:
       retval = char(ch);
       _redraw_type = "none";
@@ -1,5 +1,8 @@
 #include <string>
 #include <vector>
+#include <deque>
+#include <unordered_set>
+#include <unordered_map>
 #include <algorithm> 	// count
 #include <cctype>	// isdigit
 #include "backend.h"
@@ -9,6 +12,168 @@
 
 /*******************************************************************************
 
+Field indices for SlackBuild props. Flags come first; for these, the bit in
+_flags is 1 << field.
+
+*******************************************************************************/
+const int BUILD_UPGRADABLE = 0;
+const int BUILD_TAGGED = 1;
+const int BUILD_MARKED = 2;
+const int BUILD_INSTALLED = 3;
+const int BUILD_BLACKLISTED = 4;
+const int BUILD_REBUILD = 5;
+const int BUILD_NFLAGS = 6;
+const int BUILD_REQUIRES = 6;
+const int BUILD_PACKAGE_NAME = 7;
+const int BUILD_INSTALLED_VERSION = 8;
+const int BUILD_INSTALLED_BUILDNUM = 9;
+const int BUILD_CATEGORY = 10;
+const int BUILD_BUILD_OPTIONS = 11;
+const int BUILD_AVAILABLE_VERSION = 12;
+const int BUILD_AVAILABLE_BUILDNUM = 13;
+const int BUILD_ACTION = 14;
+
+const std::string build_empty_string = "";
+const std::string build_true_string = "true";
+const std::string build_false_string = "false";
+
+/*******************************************************************************
+
+Returns field index for a prop name, or -1 if it is not a SlackBuild prop.
+Dispatches on length and first character so that at most one full string
+comparison is needed.
+
+*******************************************************************************/
+int build_field(const std::string & propname)
+{
+  int field;
+
+  field = -1;
+  switch (propname.size()) {
+    case 6:
+      if (propname[0] == 'a') { field = BUILD_ACTION; }
+      else if (propname[0] == 't') { field = BUILD_TAGGED; }
+      else if (propname[0] == 'm') { field = BUILD_MARKED; }
+      break;
+    case 7:
+      field = BUILD_REBUILD;
+      break;
+    case 8:
+      if (propname[0] == 'r') { field = BUILD_REQUIRES; }
+      else if (propname[0] == 'c') { field = BUILD_CATEGORY; }
+      break;
+    case 9:
+      field = BUILD_INSTALLED;
+      break;
+    case 10:
+      field = BUILD_UPGRADABLE;
+      break;
+    case 11:
+      field = BUILD_BLACKLISTED;
+      break;
+    case 12:
+      field = BUILD_PACKAGE_NAME;
+      break;
+    case 13:
+      field = BUILD_BUILD_OPTIONS;
+      break;
+    case 17:
+      if (propname[0] == 'i') { field = BUILD_INSTALLED_VERSION; }
+      else if (propname[0] == 'a') { field = BUILD_AVAILABLE_VERSION; }
+      break;
+    case 18:
+      if (propname[0] == 'i') { field = BUILD_INSTALLED_BUILDNUM; }
+      else if (propname[0] == 'a') { field = BUILD_AVAILABLE_BUILDNUM; }
+      break;
+  }
+  if (field == -1) { return -1; }
+
+  switch (field) {
+    case BUILD_UPGRADABLE:
+      return (propname == "upgradable") ? field : -1;
+    case BUILD_TAGGED:
+      return (propname == "tagged") ? field : -1;
+    case BUILD_MARKED:
+      return (propname == "marked") ? field : -1;
+    case BUILD_INSTALLED:
+      return (propname == "installed") ? field : -1;
+    case BUILD_BLACKLISTED:
+      return (propname == "blacklisted") ? field : -1;
+    case BUILD_REBUILD:
+      return (propname == "rebuild") ? field : -1;
+    case BUILD_REQUIRES:
+      return (propname == "requires") ? field : -1;
+    case BUILD_PACKAGE_NAME:
+      return (propname == "package_name") ? field : -1;
+    case BUILD_INSTALLED_VERSION:
+      return (propname == "installed_version") ? field : -1;
+    case BUILD_INSTALLED_BUILDNUM:
+      return (propname == "installed_buildnum") ? field : -1;
+    case BUILD_CATEGORY:
+      return (propname == "category") ? field : -1;
+    case BUILD_BUILD_OPTIONS:
+      return (propname == "build_options") ? field : -1;
+    case BUILD_AVAILABLE_VERSION:
+      return (propname == "available_version") ? field : -1;
+    case BUILD_AVAILABLE_BUILDNUM:
+      return (propname == "available_buildnum") ? field : -1;
+    default:
+      return (propname == "action") ? field : -1;
+  }
+}
+
+/*******************************************************************************
+
+Interns a string and returns a pointer to the shared copy. The pool is never
+freed, so pointers stay valid for the life of the program. Versions, build
+numbers, and actions repeat across many SlackBuilds, so this saves memory and
+makes copies of BuildListItems cheap.
+
+*******************************************************************************/
+const std::string * build_intern(const std::string & value)
+{
+  static std::unordered_set<std::string> pool;
+  const std::string *interned;
+
+  if (value.empty()) { return &build_empty_string; }
+
+#pragma omp critical (build_intern)
+  { interned = &(*pool.insert(value).first); }
+
+  return interned;
+}
+
+/*******************************************************************************
+
+Table of categories. A deque is used so that references stay valid as
+categories are added.
+
+*******************************************************************************/
+std::deque<std::string> build_categories;
+
+int build_category_idx(const std::string & category)
+{
+  static std::unordered_map<std::string, int> category_idx;
+  std::unordered_map<std::string, int>::const_iterator it;
+  int idx;
+
+#pragma omp critical (build_category)
+  {
+    it = category_idx.find(category);
+    if (it != category_idx.end()) { idx = it->second; }
+    else
+    {
+      idx = build_categories.size();
+      build_categories.push_back(category);
+      category_idx[category] = idx;
+    }
+  }
+
+  return idx;
+}
+
+/*******************************************************************************
+
 Checks if installed version is the same as available version, but with a kernel
 tag appended. Returns true if the two match except for a kernel tag appended to
 the installed version string. Otherwise returns false.
@@ -57,23 +222,23 @@ bool BuildListItem::differsByKernel(const std::string & installed_version,
 Checks whether SlackBuild can be upgraded
 
 *******************************************************************************/
-bool BuildListItem::upgradable() const
+bool BuildListItem::checkUpgradable() const
 {
   bool test_version, test_buildnum;
   std::string installed_version, available_version;
   std::string installed_buildnum, available_buildnum;
 
   test_version = false;
-  installed_version = getProp("installed_version");
-  available_version = getProp("available_version");
+  installed_version = *_installed_version;
+  available_version = *_available_version;
 
   test_buildnum = false;
-  installed_buildnum = getProp("installed_buildnum");
-  available_buildnum = getProp("available_buildnum");
+  installed_buildnum = *_installed_buildnum;
+  available_buildnum = *_available_buildnum;
 
   // Check if new VERSION or BUILD is available
 
-  if ( (getBoolProp("installed")) && (! getBoolProp("blacklisted")) )
+  if ( (installed()) && (! blacklisted()) )
   {
     if (installed_version != available_version)
     {
@@ -89,31 +254,217 @@ bool BuildListItem::upgradable() const
 
 /*******************************************************************************
 
+Access to typed fields by field index
+
+*******************************************************************************/
+void BuildListItem::setField(int field, const std::string & value)
+{
+  if (field < BUILD_NFLAGS)
+  {
+    if (string2Bool(value)) { _flags |= (1u << field); }
+    else { _flags &= ~(1u << field); }
+    return;
+  }
+
+  switch (field) {
+    case BUILD_REQUIRES:
+      _requires = value;
+      break;
+    case BUILD_PACKAGE_NAME:
+      _package_name = value;
+      break;
+    case BUILD_INSTALLED_VERSION:
+      _installed_version = build_intern(value);
+      break;
+    case BUILD_INSTALLED_BUILDNUM:
+      _installed_buildnum = build_intern(value);
+      break;
+    case BUILD_CATEGORY:
+      _category = build_category_idx(value);
+      break;
+    case BUILD_BUILD_OPTIONS:
+      _build_options = value;
+      break;
+    case BUILD_AVAILABLE_VERSION:
+      _available_version = build_intern(value);
+      break;
+    case BUILD_AVAILABLE_BUILDNUM:
+      _available_buildnum = build_intern(value);
+      break;
+    case BUILD_ACTION:
+      _action = build_intern(value);
+      break;
+  }
+}
+
+const std::string & BuildListItem::getField(int field) const
+{
+  if (field < BUILD_NFLAGS)
+  {
+    if (_flags & (1u << field)) { return build_true_string; }
+    else { return build_false_string; }
+  }
+
+  switch (field) {
+    case BUILD_REQUIRES:
+      return _requires;
+    case BUILD_PACKAGE_NAME:
+      return _package_name;
+    case BUILD_INSTALLED_VERSION:
+      return *_installed_version;
+    case BUILD_INSTALLED_BUILDNUM:
+      return *_installed_buildnum;
+    case BUILD_CATEGORY:
+      return category();
+    case BUILD_BUILD_OPTIONS:
+      return _build_options;
+    case BUILD_AVAILABLE_VERSION:
+      return *_available_version;
+    case BUILD_AVAILABLE_BUILDNUM:
+      return *_available_buildnum;
+    default:
+      return *_action;
+  }
+}
+
+/*******************************************************************************
+
 Constructor
 
 *******************************************************************************/
 BuildListItem::BuildListItem() 
 { 
   _name = ""; 
+  _repo_check = -1;
+  _flags = 0;
+  _id = 0;
+  _category = -1;
+  _available_version = &build_empty_string;
+  _available_buildnum = &build_empty_string;
+  _installed_version = &build_empty_string;
+  _installed_buildnum = &build_empty_string;
+  _action = &build_empty_string;
+  _requires = "";
+  _package_name = "";
+  _build_options = "";
+}
+
+/*******************************************************************************
+
+ListItem prop methods. SlackBuild props are mapped onto typed fields; any
+other props are stored in the generic prop list.
+
+*******************************************************************************/
+void BuildListItem::addProp(const std::string & propname,
+                            const std::string & value)
+{
+  int field;
+
+  field = build_field(propname);
+  if (field != -1) { setField(field, value); }
+  else { ListItem::addProp(propname, value); }
+}
+
+void BuildListItem::addBoolProp(const std::string & propname, bool value)
+{
+  addProp(propname, bool2String(value));
+}
+
+int BuildListItem::setProp(const std::string & propname,
+                           const std::string & value)
+{
+  int field;
+
+  field = build_field(propname);
+  if (field != -1)
+  {
+    setField(field, value);
+    return 0;
+  }
+  else { return ListItem::setProp(propname, value); }
+}
+
+int BuildListItem::setBoolProp(const std::string & propname, bool value)
+{
+  int field;
+
+  field = build_field(propname);
+  if ( (field != -1) && (field < BUILD_NFLAGS) )
+  {
+    if (value) { _flags |= (1u << field); }
+    else { _flags &= ~(1u << field); }
+    return 0;
+  }
+  else { return setProp(propname, bool2String(value)); }
+}
+
+bool BuildListItem::checkProp(const std::string & propname) const
+{
+  if (build_field(propname) != -1) { return true; }
+  else { return ListItem::checkProp(propname); }
+}
+
+const std::string & BuildListItem::getProp(const std::string & propname) const
+{
+  int field;
+
+  field = build_field(propname);
+  if (field != -1) { return getField(field); }
+  else { return ListItem::getProp(propname); }
+}
+
+bool BuildListItem::getBoolProp(const std::string & propname) const
+{
+  int field;
+
+  field = build_field(propname);
+  if ( (field != -1) && (field < BUILD_NFLAGS) )
+    return (_flags & (1u << field)) != 0;
+  else if (field != -1)
+    return string2Bool(getField(field));
+  else
+    return ListItem::getBoolProp(propname);
+}
+
+/*******************************************************************************
+
+Typed access to flags and category
+
+*******************************************************************************/
+bool BuildListItem::installed() const
+{
+  return (_flags & (1u << BUILD_INSTALLED)) != 0;
+}
+
+bool BuildListItem::upgradable() const
+{
+  return (_flags & (1u << BUILD_UPGRADABLE)) != 0;
+}
+
+bool BuildListItem::tagged() const
+{
+  return (_flags & (1u << BUILD_TAGGED)) != 0;
+}
 
-  // Add props in reverse alphabetical order (should be fastest)
+bool BuildListItem::marked() const
+{
+  return (_flags & (1u << BUILD_MARKED)) != 0;
+}
 
-  addBoolProp("upgradable", false);
-  addBoolProp("tagged", false);
-  addProp("requires", "");
-  addProp("package_name", "");
-  addBoolProp("marked", false);
-  addProp("installed_version", "");
-  addProp("installed_buildnum", "");
-  addBoolProp("installed", false);
-  addProp("category", "");
-  addProp("build_options", "");
-  addBoolProp("blacklisted", false);
-  addProp("available_version", "");
-  addProp("available_buildnum", "");
-  addProp("action", "");
+bool BuildListItem::blacklisted() const
+{
+  return (_flags & (1u << BUILD_BLACKLISTED)) != 0;
 }
 
+const std::string & BuildListItem::category() const
+{
+  if (_category < 0) { return build_empty_string; }
+  else { return build_categories[_category]; }
+}
+
+void BuildListItem::setId(unsigned int id) { _id = id; }
+unsigned int BuildListItem::id() const { return _id; }
+
 /*******************************************************************************
 
 Checks whether this BuildListItem is installed and gets information about it
@@ -121,20 +472,20 @@ if so. If repo info has been read already, checks whether installed SlackBuild
 is also upgradable.
 
 *******************************************************************************/
-void BuildListItem::readInstalledProps(std::vector<std::string> & installedpkgs)
+void BuildListItem::readInstalledProps(const InstalledPackages & installedpkgs)
 {
-  std::string pkg, version, arch, build;
+  const installed_pkg *entry;
 
-  if (check_installed(*this, installedpkgs, pkg, version, arch, build))
+  entry = installedpkgs.find(_name);
+  if (entry != NULL)
   {
     setBoolProp("installed", true);
-    setProp("installed_version", version);
-    setProp("package_name", pkg);
-    setBoolProp("blacklisted", blacklist.blacklisted(pkg, _name, 
-                               version, arch, build));
-    parseBuildNum(build);
+    setProp("installed_version", entry->version);
+    setProp("package_name", entry->pkg);
+    setBoolProp("blacklisted", blacklist.blacklisted(*entry));
+    parseBuildNum(entry->build);
     if (getProp("available_version") != "")
-      setBoolProp("upgradable", upgradable());
+      setBoolProp("upgradable", checkUpgradable());
   }
   else
   {
@@ -151,18 +502,25 @@ void BuildListItem::readInstalledProps(std::vector<std::string> & installedpkgs)
 Reads properties from repo. If installed, checks whether it is upgradable.
 
 *******************************************************************************/
-int BuildListItem::readPropsFromRepo()
+int BuildListItem::readPropsFromRepo(bool use_cached)
 {
   std::string available_version, reqs, available_buildnum;
   int check;
 
+  if ( (use_cached) && (_repo_check >= 0) )
+  {
+    if (installed()) { setBoolProp("upgradable", checkUpgradable()); }
+    return _repo_check;
+  }
+
   check = get_repo_info(*this, available_version, reqs, available_buildnum);
+  _repo_check = check;
   if (check == 0)
   {
     setProp("available_version", available_version);
     setProp("requires", reqs);
     setProp("available_buildnum", available_buildnum);
-    if (getBoolProp("installed")) { setBoolProp("upgradable", upgradable()); }
+    if (installed()) { setBoolProp("upgradable", checkUpgradable()); }
   }
 
   return check;
@@ -170,11 +528,30 @@ int BuildListItem::readPropsFromRepo()
 
 /*******************************************************************************
 
+Sets repo info that was read elsewhere (e.g., from the repository index)
+
+*******************************************************************************/
+void BuildListItem::setRepoInfo(const std::string & available_version,
+                                const std::string & reqs,
+                                const std::string & available_buildnum,
+                                int check)
+{
+  _repo_check = check;
+  setProp("available_version", available_version);
+  setProp("requires", reqs);
+  setProp("available_buildnum", available_buildnum);
+  if (installed()) { setBoolProp("upgradable", checkUpgradable()); }
+}
+
+int BuildListItem::repoInfoCheck() const { return _repo_check; }
+
+/*******************************************************************************
+
 Determines BUILD number from last portion of package name and sets it in
 installed_buildnum prop
 
 *******************************************************************************/
-void BuildListItem::parseBuildNum(std::string & build)
+void BuildListItem::parseBuildNum(const std::string & build)
 {
   int i, buildlen;
   std::string buildnum;
@@ -0,0 +1,145 @@
+#include <vector>
+#include "BuildListItem.h"
+#include "CategoryListItem.h"
+#include "BuildListView.h"
+
+unsigned int BuildListView::_last_revision = 0;
+
+/*******************************************************************************
+
+Marks the view as changed
+
+*******************************************************************************/
+void BuildListView::touch()
+{
+  _last_revision++;
+  _revision = _last_revision;
+}
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+BuildListView::BuildListView()
+{
+  _offsets.assign(1, 0);
+  touch();
+}
+
+/*******************************************************************************
+
+Edit view
+
+*******************************************************************************/
+void BuildListView::clear()
+{
+  _builds.resize(0);
+  _categories.resize(0);
+  _offsets.assign(1, 0);
+  _highlights.resize(0);
+  touch();
+}
+
+void BuildListView::addCategory(CategoryListItem *category)
+{
+  _categories.push_back(category);
+  _offsets.push_back(_builds.size());
+  _highlights.push_back(0);
+  touch();
+}
+
+void BuildListView::addBuild(BuildListItem *build)
+{
+  if (_categories.size() == 0) { return; }
+  _builds.push_back(build);
+  _offsets.back()++;
+  touch();
+}
+
+void BuildListView::insertBuild(unsigned int category, unsigned int idx,
+                                BuildListItem *build)
+{
+  unsigned int i, ncategories;
+
+  if ( (category >= _categories.size()) || (idx > numBuilds(category)) )
+    return;
+  _builds.insert(_builds.begin()+_offsets[category]+idx, build);
+  ncategories = _categories.size();
+  for ( i = category+1; i <= ncategories; i++ ) { _offsets[i]++; }
+  touch();
+}
+
+void BuildListView::removeBuild(unsigned int category, unsigned int idx)
+{
+  unsigned int i, ncategories;
+
+  if ( (category >= _categories.size()) || (idx >= numBuilds(category)) )
+    return;
+  _builds.erase(_builds.begin()+_offsets[category]+idx);
+  ncategories = _categories.size();
+  for ( i = category+1; i <= ncategories; i++ ) { _offsets[i]--; }
+  touch();
+}
+
+/*******************************************************************************
+
+Set attributes
+
+*******************************************************************************/
+void BuildListView::setHighlight(unsigned int category, unsigned int highlight)
+{
+  if (category < _highlights.size()) { _highlights[category] = highlight; }
+}
+
+/*******************************************************************************
+
+Get attributes
+
+*******************************************************************************/
+unsigned int BuildListView::numCategories() const { return _categories.size(); }
+unsigned int BuildListView::numBuilds() const { return _builds.size(); }
+
+unsigned int BuildListView::numBuilds(unsigned int category) const
+{
+  if (category >= _categories.size()) { return 0; }
+  return _offsets[category+1] - _offsets[category];
+}
+
+CategoryListItem * BuildListView::category(unsigned int category) const
+{
+  return _categories[category];
+}
+
+BuildListItem * BuildListView::build(unsigned int category,
+                                     unsigned int idx) const
+{
+  return _builds[_offsets[category]+idx];
+}
+
+unsigned int BuildListView::highlight(unsigned int category) const
+{
+  if (category >= _highlights.size()) { return 0; }
+  return _highlights[category];
+}
+
+unsigned int BuildListView::revision() const { return _revision; }
+
+/*******************************************************************************
+
+Checks if all SlackBuilds in a category are tagged
+
+*******************************************************************************/
+bool BuildListView::allTagged(unsigned int category) const
+{
+  unsigned int i, last;
+
+  if (category >= _categories.size()) { return true; }
+  last = _offsets[category+1];
+  for ( i = _offsets[category]; i < last; i++ )
+  {
+    if (! _builds[i]->getBoolProp("tagged")) { return false; }
+  }
+
+  return true;
+}
@@ -30,7 +30,7 @@ void BuildOrderBox::redrawFrame()
   left = std::floor(mid - double(namelen)/2.0);
   right = left + namelen;
   wmove(_win, 0, left);
-  if (colors.turnOn(_win, "fg_title", "bg_title") != 0)
+  if (colors.turnOn(_win, _title_pair) != 0)
     wattron(_win, A_BOLD);
   wprintw(_win, "%s", _name.c_str());
   if (colors.turnOff(_win) != 0)
@@ -112,8 +112,8 @@ screen or not.
 *******************************************************************************/
 void BuildOrderBox::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
-  int nspaces, vlineloc, printlen, rows, cols, i, nast;
+  int nspaces, vlineloc, printlen, rows, cols, i, nast, color_pair;
+  bool tagged;
 
   getmaxyx(_win, rows, cols);
 
@@ -129,26 +129,24 @@ void BuildOrderBox::redrawSingleItem(unsigned int idx)
 
   // Turn on highlight color
 
+  tagged = _items[idx]->getBoolProp("tagged");
   if (int(idx) == _highlight)
   {
-    if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-    else { fg = "fg_highlight_active"; }
-    bg = "bg_highlight_active"; 
-
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (tagged) { color_pair = _tagged_active_pair; }
+    else { color_pair = _highlight_active_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); } 
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   } 
   else
   {
-    if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-    else { fg = "fg_popup"; }
-    bg = "bg_popup";
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (tagged) { color_pair = _tagged_pair; }
+    else { color_pair = _color_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     {
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); } 
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   }
 
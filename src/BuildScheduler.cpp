@@ -0,0 +1,647 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>        // remove
+#include <cerrno>        // errno, EINTR, ECHILD
+#include <stdlib.h>      // mkdtemp
+#include <unistd.h>      // fork, dup2, execl, _exit
+#include <fcntl.h>       // open
+#include <sys/types.h>
+#include <sys/stat.h>    // mkdir
+#include <sys/wait.h>    // waitpid
+#include "BuildListItem.h"
+#include "string_util.h"
+#include "settings.h"
+#include "backend.h"
+#include "BuildScheduler.h"
+
+const unsigned int BuildScheduler::_maxfetches = 4;
+
+/*******************************************************************************
+
+Returns true if all SlackBuilds a job requires from the list are installed
+
+*******************************************************************************/
+bool BuildScheduler::depsDone(unsigned int idx) const
+{
+  unsigned int i, ndeps;
+
+  ndeps = _jobs[idx].deps.size();
+  for ( i = 0; i < ndeps; i++ )
+  {
+    if (_jobs[_jobs[idx].deps[i]].state != "done") { return false; }
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+
+Checks the package cache for a package built from the same inputs, the first
+time a job is ready to build. If there is one, the job is marked built with it.
+Reinstalls chosen by the user are always built, but their packages are still
+cached.
+
+*******************************************************************************/
+bool BuildScheduler::useCachedPackage(unsigned int idx)
+{
+  build_job & job = _jobs[idx];
+  std::string vars;
+
+  if (job.cachechecked) { return false; }
+  job.cachechecked = true;
+
+  if (job.build->getProp("action") == "Upgrade")
+    vars = settings::upgrade_vars;
+  else { vars = settings::install_vars; }
+  job.package = find_cached_package(*job.build, vars, job.cacheopt,
+                                    job.build->getBoolProp("rebuild"));
+  if (job.package == "") { return false; }
+
+  job.cached = true;
+  job.state = "built";
+
+  return true;
+}
+
+/*******************************************************************************
+
+Starts building a SlackBuild in a child process, which runs sboui-backend build.
+The child only execs the build command, even with native_backend: sboui may
+already be running OpenMP threads, so little else is safe to call after fork.
+When building in parallel, output goes to a log file. Returns 0 on success, 1
+if the process could not be started.
+
+*******************************************************************************/
+int BuildScheduler::startBuild(unsigned int idx)
+{
+  build_job & job = _jobs[idx];
+  std::string cmd;
+  int fd;
+
+  job.pkgfile = _workdir + "/" + job.build->name() + ".pkg";
+  if (_maxjobs > 1)
+    job.logfile = _workdir + "/" + job.build->name() + ".log";
+  cmd = build_slackbuild_cmd(*job.build, job.pkgfile, job.sourcedir,
+                             job.cacheopt);
+
+  // Anything left in the output buffer would also be written by the child
+
+  std::cout << std::flush;
+  job.pid = fork();
+  if (job.pid == -1)
+  {
+    std::cout << "Error: could not start build of " << job.build->name()
+              << "." << std::endl;
+    failJob(idx);
+    return 1;
+  }
+  else if (job.pid == 0)
+  {
+    fd = open("/dev/null", O_RDONLY);
+    if (fd != -1) { dup2(fd, 0); }
+    if (job.logfile != "")
+    {
+      fd = open(job.logfile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd != -1)
+      {
+        dup2(fd, 1);
+        dup2(fd, 2);
+      }
+    }
+    execl("/bin/sh", "sh", "-c", cmd.c_str(), (char *) NULL);
+    _exit(127);
+  }
+
+  if (job.logfile != "")
+    std::cout << "Building " << job.build->name() << " (log: "
+              << job.logfile << ")" << std::endl;
+  else { std::cout << "Building " << job.build->name() << std::endl; }
+  job.state = "building";
+  _nrunning++;
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Records result of a build: the package path is read from the job's pkgfile
+
+*******************************************************************************/
+void BuildScheduler::finishBuild(unsigned int idx, int status)
+{
+  build_job & job = _jobs[idx];
+  std::ifstream pkgfile;
+
+  _nrunning--;
+  if ( WIFEXITED(status) && (WEXITSTATUS(status) == 127) )
+  {
+    std::cout << "Error: package manager not found." << std::endl;
+    _pm_missing = true;
+    job.state = "failed";
+    skipWaiting();
+    return;
+  }
+
+  job.package = "";
+  if ( WIFEXITED(status) && (WEXITSTATUS(status) == 0) )
+  {
+    pkgfile.open(job.pkgfile.c_str());
+    if (pkgfile.is_open())
+    {
+      std::getline(pkgfile, job.package);
+      pkgfile.close();
+    }
+    job.package = trim(job.package);
+  }
+
+  if (job.package == "")
+  {
+    std::cout << "Error: " << job.build->name() << " failed to build.";
+    if (job.logfile != "") { std::cout << " See " << job.logfile << "."; }
+    std::cout << std::endl;
+    failJob(idx);
+  }
+  else
+  {
+    std::cout << "Built " << job.build->name() << "." << std::endl;
+    job.state = "built";
+    prune_cached_packages(*job.build, job.cacheopt);
+  }
+}
+
+/*******************************************************************************
+
+Installs a built package or removes a SlackBuild. Returns the return value of
+the package manager.
+
+*******************************************************************************/
+int BuildScheduler::installJob(unsigned int idx)
+{
+  build_job & job = _jobs[idx];
+  int check;
+
+  if (job.build->getProp("action") == "Remove")
+    check = remove_slackbuild(*job.build);
+  else
+  {
+    if (! job.cached)
+      std::cout << "Installing " << job.package << std::endl;
+    check = install_built_package(*job.build, job.package, job.cached);
+  }
+
+  if (check == 0) { job.state = "done"; }
+  else if (check == 127)
+  {
+    std::cout << "Error: package manager not found." << std::endl;
+    _pm_missing = true;
+    job.state = "failed";
+    skipWaiting();
+  }
+  else
+  {
+    std::cout << "Error: could not apply changes to " << job.build->name()
+              << "." << std::endl;
+    failJob(idx);
+  }
+
+  return check;
+}
+
+/*******************************************************************************
+
+Marks a job as failed and skips the waiting jobs that depend on it, directly
+or through other skipped jobs. Since jobs are in build order, requirements
+always come first, so one pass is enough.
+
+*******************************************************************************/
+void BuildScheduler::failJob(unsigned int idx)
+{
+  unsigned int i, j, njobs, ndeps;
+  std::string depstate;
+
+  _jobs[idx].state = "failed";
+  njobs = _jobs.size();
+  for ( i = idx+1; i < njobs; i++ )
+  {
+    if (_jobs[i].state != "waiting") { continue; }
+    ndeps = _jobs[i].deps.size();
+    for ( j = 0; j < ndeps; j++ )
+    {
+      depstate = _jobs[_jobs[i].deps[j]].state;
+      if ( (depstate == "failed") || (depstate == "skipped") )
+      {
+        std::cout << "Skipping " << _jobs[i].build->name() << " (requires "
+                  << _jobs[_jobs[i].deps[j]].build->name() << ")."
+                  << std::endl;
+        _jobs[i].state = "skipped";
+        break;
+      }
+    }
+  }
+}
+
+/*******************************************************************************
+
+Skips all jobs that have not started, e.g. if the package manager is missing
+
+*******************************************************************************/
+void BuildScheduler::skipWaiting()
+{
+  unsigned int i, njobs;
+
+  njobs = _jobs.size();
+  for ( i = 0; i < njobs; i++ )
+  {
+    if (_jobs[i].state == "waiting") { _jobs[i].state = "skipped"; }
+  }
+}
+
+/*******************************************************************************
+
+Waits for any running build or source download to finish
+
+*******************************************************************************/
+void BuildScheduler::waitForChild()
+{
+  unsigned int i, njobs, nfetches;
+  pid_t pid;
+  int status;
+
+  njobs = _jobs.size();
+  nfetches = _fetches.size();
+  // Signals such as SIGWINCH from ncurses interrupt the wait, since they are
+  // not set up with SA_RESTART
+
+  do
+  {
+    pid = waitpid(-1, &status, 0);
+  } while ( (pid == -1) && (errno == EINTR) );
+  if (pid == -1)
+  {
+    if (errno != ECHILD) { return; }
+
+    // No children left, so none of the running builds or downloads can finish
+
+    for ( i = 0; i < nfetches; i++ )
+    {
+      if (_fetches[i].state == "fetching") { finishFetch(i, -1); }
+    }
+    for ( i = 0; i < njobs; i++ )
+    {
+      if (_jobs[i].state == "building")
+      {
+        _nrunning--;
+        failJob(i);
+      }
+    }
+    return;
+  }
+
+  for ( i = 0; i < njobs; i++ )
+  {
+    if ( (_jobs[i].state == "building") && (_jobs[i].pid == pid) )
+    {
+      finishBuild(i, status);
+      return;
+    }
+  }
+  for ( i = 0; i < nfetches; i++ )
+  {
+    if ( (_fetches[i].state == "fetching") && (_fetches[i].pid == pid) )
+    {
+      finishFetch(i, status);
+      return;
+    }
+  }
+}
+
+/*******************************************************************************
+
+Removes package lists, prefetched sources, and the logs of successful builds.
+Logs of failed builds are kept, along with the directory holding them.
+
+*******************************************************************************/
+void BuildScheduler::cleanUp()
+{
+  unsigned int i, njobs, nfetches;
+
+  nfetches = _fetches.size();
+  for ( i = 0; i < nfetches; i++ ) { std::remove(_fetches[i].path.c_str()); }
+
+  njobs = _jobs.size();
+  for ( i = 0; i < njobs; i++ )
+  {
+    if (_jobs[i].pkgfile != "") { std::remove(_jobs[i].pkgfile.c_str()); }
+    if (_jobs[i].sourcedir != "") { std::remove(_jobs[i].sourcedir.c_str()); }
+    if ( (_jobs[i].logfile != "") && (_jobs[i].state != "failed") )
+      std::remove(_jobs[i].logfile.c_str());
+  }
+  std::remove(_workdir.c_str());
+}
+
+/*******************************************************************************
+
+Lists sources to prefetch for each SlackBuild to be built. SlackBuilds whose
+sources cannot be determined here (e.g., unsupported on this architecture)
+are left to download their own sources.
+
+*******************************************************************************/
+void BuildScheduler::planFetches()
+{
+  unsigned int i, j, njobs, nurls;
+  std::vector<std::string> urls, md5sums;
+  source_fetch fetch;
+  std::string sourcedir;
+
+  _fetches.resize(0);
+  njobs = _jobs.size();
+  for ( i = 0; i < njobs; i++ )
+  {
+    if (_jobs[i].build->getProp("action") == "Remove") { continue; }
+    if (get_sources(*_jobs[i].build, urls, md5sums) != 0) { continue; }
+    nurls = urls.size();
+    if (nurls == 0) { continue; }
+    sourcedir = _workdir + "/" + _jobs[i].build->name() + ".src";
+    if (mkdir(sourcedir.c_str(), 0755) != 0) { continue; }
+
+    _jobs[i].sourcedir = sourcedir;
+    _jobs[i].nsources = nurls;
+    for ( j = 0; j < nurls; j++ )
+    {
+      fetch.job = i;
+      fetch.url = urls[j];
+      if (j < md5sums.size()) { fetch.md5sum = md5sums[j]; }
+      else { fetch.md5sum = ""; }
+      fetch.path = sourcedir + "/" +
+                   urls[j].substr(urls[j].find_last_of('/')+1);
+      fetch.state = "waiting";
+      fetch.pid = -1;
+      _fetches.push_back(fetch);
+    }
+  }
+}
+
+/*******************************************************************************
+
+Starts fetching and checking a source in a child process, through the source
+cache of the built-in package manager. Returns 0 on success, 1 if the process
+could not be started.
+
+*******************************************************************************/
+int BuildScheduler::startFetch(unsigned int idx)
+{
+  source_fetch & fetch = _fetches[idx];
+  std::string cmd;
+  int fd;
+
+  cmd = "sboui-backend fetch-source " + shell_quote(fetch.url) + " "
+      + shell_quote(fetch.md5sum) + " "
+      + shell_quote(_jobs[fetch.job].sourcedir);
+
+  fetch.pid = fork();
+  if (fetch.pid == -1)
+  {
+    finishFetch(idx, -1);
+    return 1;
+  }
+  else if (fetch.pid == 0)
+  {
+    fd = open("/dev/null", O_RDWR);
+    if (fd != -1)
+    {
+      dup2(fd, 0);
+      dup2(fd, 1);
+      dup2(fd, 2);
+    }
+    execl("/bin/sh", "sh", "-c", cmd.c_str(), (char *) NULL);
+    _exit(127);
+  }
+  fetch.state = "fetching";
+  _nfetching++;
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Records result of a download. A SlackBuild whose sources cannot all be fetched
+fails without being built.
+
+*******************************************************************************/
+void BuildScheduler::finishFetch(unsigned int idx, int status)
+{
+  source_fetch & fetch = _fetches[idx];
+  build_job & job = _jobs[fetch.job];
+
+  if (fetch.state == "fetching") { _nfetching--; }
+  fetch.state = "finished";
+  if (job.state != "waiting") { return; }
+
+  if ( WIFEXITED(status) && (WEXITSTATUS(status) == 0) )
+  {
+    job.nsources--;
+    return;
+  }
+
+  if ( WIFEXITED(status) && (WEXITSTATUS(status) == 3) )
+    std::cout << "Error: md5sum check failed on " << fetch.url << "."
+              << std::endl;
+  else
+    std::cout << "Error: could not download " << fetch.url << "."
+              << std::endl;
+  failJob(fetch.job);
+}
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+BuildScheduler::BuildScheduler()
+{
+  _jobs.resize(0);
+  _fetches.resize(0);
+  _maxjobs = 1;
+  _nrunning = 0;
+  _nfetching = 0;
+  _workdir = "";
+  _pm_missing = false;
+  _prefetch = false;
+}
+
+/*******************************************************************************
+
+Set attributes. Dependencies are taken from the REQUIRES of each SlackBuild;
+requirements that are not in the list are assumed to be satisfied.
+
+*******************************************************************************/
+void BuildScheduler::setMaxJobs(unsigned int maxjobs)
+{
+  if (maxjobs < 1) { maxjobs = 1; }
+  _maxjobs = maxjobs;
+}
+
+void BuildScheduler::setPrefetch(bool prefetch) { _prefetch = prefetch; }
+
+void BuildScheduler::setBuilds(const std::vector<BuildListItem *> & builds)
+{
+  unsigned int i, j, nbuilds, nreqs;
+  std::map<std::string, unsigned int> jobidx;
+  std::map<std::string, unsigned int>::const_iterator it;
+  std::vector<std::string> reqs;
+
+  nbuilds = builds.size();
+  _jobs.resize(nbuilds);
+  for ( i = 0; i < nbuilds; i++ )
+  {
+    _jobs[i].build = builds[i];
+    _jobs[i].deps.resize(0);
+    _jobs[i].state = "waiting";
+    _jobs[i].pkgfile = "";
+    _jobs[i].logfile = "";
+    _jobs[i].package = "";
+    _jobs[i].sourcedir = "";
+    _jobs[i].cacheopt = "";
+    _jobs[i].cachechecked = false;
+    _jobs[i].cached = false;
+    _jobs[i].nsources = 0;
+    _jobs[i].pid = -1;
+
+    if (builds[i]->getProp("action") == "Remove") { reqs.resize(0); }
+    else { reqs = split(builds[i]->getProp("requires")); }
+    nreqs = reqs.size();
+    for ( j = 0; j < nreqs; j++ )
+    {
+      it = jobidx.find(reqs[j]);
+      if (it != jobidx.end()) { _jobs[i].deps.push_back(it->second); }
+    }
+    jobidx[builds[i]->name()] = i;
+  }
+}
+
+/*******************************************************************************
+
+Builds and installs, or removes, the SlackBuilds. Between installs, as many
+downloads and builds are started as allowed, and then the next one to finish
+is waited for. Removals have no build step and are run in list order.
+
+*******************************************************************************/
+int BuildScheduler::run(int & ninstalled, int & nupgraded, int & nreinstalled,
+                        int & nremoved)
+{
+  unsigned int i, njobs, nfetches, nextinstall, nfailed, nskipped;
+  std::string action, state;
+  bool cachehit;
+  char workdir[] = "/tmp/sboui-build.XXXXXX";
+
+  if (mkdtemp(workdir) == NULL)
+  {
+    std::cout << "Error: could not create directory for build logs."
+              << std::endl;
+    return 1;
+  }
+  _workdir = workdir;
+  _nrunning = 0;
+  _nfetching = 0;
+  _pm_missing = false;
+  if (_prefetch) { planFetches(); }
+  nfetches = _fetches.size();
+
+  njobs = _jobs.size();
+  nextinstall = 0;
+  while (true)
+  {
+    // Install or remove one at a time once requirements are installed. Since
+    // requirements come first, one pass picks up everything that is ready.
+
+    for ( i = nextinstall; i < njobs; i++ )
+    {
+      state = _jobs[i].state;
+      action = _jobs[i].build->getProp("action");
+      if ( ( (state == "built") ||
+             ( (state == "waiting") && (action == "Remove") ) ) &&
+           depsDone(i) )
+      {
+        if (installJob(i) == 0)
+        {
+          if (action == "Install") { ninstalled++; }
+          else if (action == "Upgrade") { nupgraded++; }
+          else if (action == "Reinstall") { nreinstalled++; }
+          else { nremoved++; }
+        }
+      }
+    }
+    while ( (nextinstall < njobs) &&
+            ( (_jobs[nextinstall].state == "done") ||
+              (_jobs[nextinstall].state == "failed") ||
+              (_jobs[nextinstall].state == "skipped") ) )
+      nextinstall++;
+
+    // Download sources in build order, skipping those no longer needed
+
+    for ( i = 0; (i < nfetches) && (_nfetching < _maxfetches); i++ )
+    {
+      if (_fetches[i].state != "waiting") { continue; }
+      if (_jobs[_fetches[i].job].state != "waiting")
+        _fetches[i].state = "finished";
+      else { startFetch(i); }
+    }
+
+    // Start builds whose requirements are installed and sources are ready,
+    // unless a cached package can be used instead
+
+    cachehit = false;
+    for ( i = nextinstall; (i < njobs) && (_nrunning < _maxjobs); i++ )
+    {
+      if ( (_jobs[i].state != "waiting") ||
+           (_jobs[i].build->getProp("action") == "Remove") || (! depsDone(i)) )
+        continue;
+      if (useCachedPackage(i)) { cachehit = true; }
+      else if (_jobs[i].nsources == 0) { startBuild(i); }
+    }
+
+    // If nothing is running, nothing else can become ready
+
+    if (cachehit) { continue; }
+    if ( (_nrunning == 0) && (_nfetching == 0) ) { break; }
+    waitForChild();
+  }
+  cleanUp();
+
+  // Summary
+
+  nfailed = 0;
+  nskipped = 0;
+  for ( i = 0; i < njobs; i++ )
+  {
+    if (_jobs[i].state == "failed") { nfailed++; }
+    else if (_jobs[i].state != "done") { nskipped++; }
+  }
+  if (_pm_missing) { return 127; }
+  if (nfailed + nskipped == 0) { return 0; }
+  std::cout << int_to_string(nfailed) << " failed, "
+            << int_to_string(nskipped) << " skipped. ";
+
+  return 1;
+}
+
+/*******************************************************************************
+
+SlackBuilds that run attempted to change
+
+*******************************************************************************/
+void BuildScheduler::attemptedBuilds(
+                              std::vector<BuildListItem *> & attempted) const
+{
+  unsigned int i, njobs;
+
+  attempted.resize(0);
+  njobs = _jobs.size();
+  for ( i = 0; i < njobs; i++ )
+  {
+    if (_jobs[i].state != "skipped") { attempted.push_back(_jobs[i].build); }
+  }
+}
@@ -0,0 +1,140 @@
+#include <vector>
+#include <algorithm>    // min
+#include <stdint.h>
+#include "BuildSet.h"
+
+/*******************************************************************************
+
+Clears unused bits in the last word, so that counting and comparing can work
+on whole words
+
+*******************************************************************************/
+void BuildSet::trim()
+{
+  unsigned int nused;
+
+  nused = _size % 64;
+  if ( (nused > 0) && (_words.size() > 0) )
+    _words.back() &= (uint64_t(1) << nused) - 1;
+}
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+BuildSet::BuildSet(unsigned int size, bool value) { reset(size, value); }
+
+/*******************************************************************************
+
+Set attributes
+
+*******************************************************************************/
+void BuildSet::reset(unsigned int size, bool value)
+{
+  _size = size;
+  _words.assign((size+63)/64, value ? ~uint64_t(0) : uint64_t(0));
+  trim();
+}
+
+void BuildSet::set(unsigned int id, bool value)
+{
+  if (id >= _size) { return; }
+  if (value) { _words[id/64] |= uint64_t(1) << (id % 64); }
+  else { _words[id/64] &= ~(uint64_t(1) << (id % 64)); }
+}
+
+/*******************************************************************************
+
+Get attributes
+
+*******************************************************************************/
+unsigned int BuildSet::size() const { return _size; }
+
+bool BuildSet::test(unsigned int id) const
+{
+  if (id >= _size) { return false; }
+  return ( (_words[id/64] >> (id % 64)) & 1 );
+}
+
+unsigned int BuildSet::count() const
+{
+  unsigned int i, nwords, total;
+
+  total = 0;
+  nwords = _words.size();
+  for ( i = 0; i < nwords; i++ )
+  {
+    total += __builtin_popcountll(_words[i]);
+  }
+
+  return total;
+}
+
+/*******************************************************************************
+
+Returns the first ID in the set at or after id, or size() if there is none.
+Empty words are skipped whole.
+
+*******************************************************************************/
+unsigned int BuildSet::next(unsigned int id) const
+{
+  unsigned int w, nwords;
+  uint64_t word;
+
+  if (id >= _size) { return _size; }
+  w = id/64;
+  word = _words[w] & (~uint64_t(0) << (id % 64));
+  nwords = _words.size();
+  while (word == 0)
+  {
+    w++;
+    if (w >= nwords) { return _size; }
+    word = _words[w];
+  }
+
+  return w*64 + __builtin_ctzll(word);
+}
+
+/*******************************************************************************
+
+Set algebra. Sets of different sizes are combined over the smaller size; bits
+past the end of the other set count as unset.
+
+*******************************************************************************/
+BuildSet & BuildSet::operator &= (const BuildSet & other)
+{
+  unsigned int i, nwords, ncommon;
+
+  nwords = _words.size();
+  ncommon = std::min(nwords, (unsigned int)other._words.size());
+  for ( i = 0; i < ncommon; i++ ) { _words[i] &= other._words[i]; }
+  for ( i = ncommon; i < nwords; i++ ) { _words[i] = 0; }
+
+  return *this;
+}
+
+BuildSet & BuildSet::operator |= (const BuildSet & other)
+{
+  unsigned int i, ncommon;
+
+  ncommon = std::min(_words.size(), other._words.size());
+  for ( i = 0; i < ncommon; i++ ) { _words[i] |= other._words[i]; }
+  trim();
+
+  return *this;
+}
+
+void BuildSet::invert()
+{
+  unsigned int i, nwords;
+
+  nwords = _words.size();
+  for ( i = 0; i < nwords; i++ ) { _words[i] = ~_words[i]; }
+  trim();
+}
+
+bool BuildSet::operator == (const BuildSet & other) const
+{
+  return ( (_size == other._size) && (_words == other._words) );
+}
@@ -32,6 +32,8 @@ CLOParser::CLOParser()
   _sync = false;
   _upgrade_all = false;
   _upgradable = false;
+  _cache_stats = false;
+  _cache_prune = false;
 }
 
 /*******************************************************************************
@@ -83,6 +85,16 @@ int CLOParser::checkCLOs(int argc, char *argv[], const std::string & version)
       _upgradable = true;
       i += 1;
     }
+    else if (_argv_str[i] == "--cache-stats")
+    {
+      _cache_stats = true;
+      i += 1;
+    }
+    else if (_argv_str[i] == "--cache-prune")
+    {
+      _cache_prune = true;
+      i += 1;
+    }
     else if ( (_argv_str[i] == "-h") || (_argv_str[i] == "--help") )
     {
       printHelp();
@@ -139,6 +151,10 @@ void CLOParser::printHelp() const
             << std::endl;
   std::cout << "  -p, --upgradable   List upgradable SlackBuilds and exit"
             << std::endl;
+  std::cout << "      --cache-stats  Show source cache of built-in package "
+            << "manager and exit" << std::endl;
+  std::cout << "      --cache-prune  Shrink source cache to its size limit and "
+            << "exit" << std::endl;
   std::cout << "  -h, --help         Display usage information and exit"
             << std::endl;
   std::cout << "  -v, --version      Display version number of sboui and exit"
@@ -171,3 +187,5 @@ Other possible inputs
 bool CLOParser::sync() const { return _sync; }
 bool CLOParser::upgradeAll() const { return _upgrade_all; }
 bool CLOParser::upgradable() const { return _upgradable; }
+bool CLOParser::cacheStats() const { return _cache_stats; }
+bool CLOParser::cachePrune() const { return _cache_prune; }
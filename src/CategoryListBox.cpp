@@ -16,7 +16,7 @@ Draws window border, title, and header
 *******************************************************************************/
 void CategoryListBox::redrawFrame()
 {
-  int rows, cols, namelen, i, left, right;
+  int rows, cols, namelen, left, right;
   double mid;
 
   getmaxyx(_win, rows, cols);
@@ -45,14 +45,12 @@ void CategoryListBox::redrawFrame()
 
   // Top border
 
-  wmove(_win, 0, 1);
-  for ( i = 1; int(i) < left-1; i++ ) { waddch(_win, ACS_HLINE); }
-  wmove(_win, 0, right+1);
-  for ( i = right+1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, 0, 1, ACS_HLINE, left-2);
+  mvwhline(_win, 0, right+1, ACS_HLINE, cols-2-right);
   
   // Left border
 
-  for ( i = 1; i < rows-1; i++ ) { mvwaddch(_win, i, 0, ACS_VLINE); }
+  mvwvline(_win, 1, 0, ACS_VLINE, rows-2);
 
   // Right border for header
 
@@ -60,8 +58,7 @@ void CategoryListBox::redrawFrame()
 
   // Bottom border
 
-  wmove(_win, rows-1, 1);
-  for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, rows-1, 1, ACS_HLINE, cols-2);
 
   // Draw header
 
@@ -69,8 +66,7 @@ void CategoryListBox::redrawFrame()
   colors.turnOn(_win, "header", "bg_normal");
   printToEol("Name");
   colors.turnOff(_win);
-  wmove(_win, 2, 1);
-  for ( i = 1; i < cols-1; i++ ) { waddch(_win, ACS_HLINE); }
+  mvwhline(_win, 2, 1, ACS_HLINE, cols-2);
 
   // Draw connections between horizontal and vertical lines
 
@@ -86,7 +82,8 @@ screen or not.
 *******************************************************************************/
 void CategoryListBox::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
+  int color_pair;
+  bool tagged;
 
   // Go to item location, optionally highlight, and print item
 
@@ -94,34 +91,32 @@ void CategoryListBox::redrawSingleItem(unsigned int idx)
 
   // Turn on highlight color
 
+  tagged = _items[idx]->getBoolProp("tagged");
   if (int(idx) == _highlight)
   {
     if (_activated) 
     { 
-      if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-      else { fg = "fg_highlight_active"; }
-      bg = "bg_highlight_active"; 
+      if (tagged) { color_pair = _tagged_active_pair; }
+      else { color_pair = _highlight_active_pair; }
     }
     else
     {
-      if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-      else { fg = "fg_highlight_inactive"; }
-      bg = "bg_highlight_inactive"; 
+      if (tagged) { color_pair = _tagged_inactive_pair; }
+      else { color_pair = _highlight_inactive_pair; }
     }
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); }
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   } 
   else
   {
-    if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-    else { fg = "fg_normal"; }
-    bg = "bg_normal";
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (tagged) { color_pair = _tagged_pair; }
+    else { color_pair = _color_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     {
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); }
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   }
 
@@ -203,7 +198,7 @@ std::string CategoryListBox::exec(MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = readKey()) {
 
     // Enter key: accept selection
 
@@ -317,6 +312,13 @@ std::string CategoryListBox::exec(MouseEvent * mevent)
         return signals::nullEvent;
       break;
 
+    // No input before timeout (only if a timeout has been set with timeout())
+
+    case ERR:
+      retval = signals::nullEvent;
+      _redraw_type = "none";
+      break;
+
     default:
       retval = char(ch);
       _redraw_type = "none";
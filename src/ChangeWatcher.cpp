@@ -0,0 +1,269 @@
+#include <string>
+#include <vector>
+#include <algorithm>    // sort, unique
+#include <ctime>        // clock_gettime
+#include <unistd.h>     // read, close
+#include <sys/inotify.h>
+#include "backend.h"    // get_pkg_info
+#include "ChangeWatcher.h"
+
+#ifndef PACKAGE_DIR
+  #define PACKAGE_DIR "/var/lib/pkgtools/packages"
+#endif
+
+const int ChangeWatcher::_debounce = 500;     // Milliseconds
+const int ChangeWatcher::pollInterval = 250;  // Milliseconds
+
+/*******************************************************************************
+
+Events that are watched for in each directory. Files in the package directory
+are written right after they are created, so creation is enough there.
+
+*******************************************************************************/
+const uint32_t WATCH_DIR_ENTRIES = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                   IN_MOVED_TO;
+const uint32_t WATCH_FILES = WATCH_DIR_ENTRIES | IN_CLOSE_WRITE;
+
+/*******************************************************************************
+
+Current time in milliseconds from a monotonic clock
+
+*******************************************************************************/
+long watcher_time_ms()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return long(ts.tv_sec)*1000 + ts.tv_nsec/1000000;
+}
+
+/*******************************************************************************
+
+Sorts list and removes duplicate entries
+
+*******************************************************************************/
+void watcher_unique(std::vector<std::string> & list)
+{
+  std::sort(list.begin(), list.end());
+  list.erase(std::unique(list.begin(), list.end()), list.end());
+}
+
+/*******************************************************************************
+
+Constructor and destructor
+
+*******************************************************************************/
+ChangeWatcher::ChangeWatcher()
+{
+  _fd = -1;
+  _pkg_wd = -1;
+  _buildopts_wd = -1;
+  _sboui_wd = -1;
+  _repo_wd = -1;
+  _category_wds.resize(0);
+  _pkg_path = PACKAGE_DIR;
+  _repo_path = "";
+  _pending.repo = false;
+  _have_pending = false;
+  _last_event = 0;
+}
+
+ChangeWatcher::~ChangeWatcher() { stop(); }
+
+/*******************************************************************************
+
+Adds watch on build options directory. It may not exist until build options
+are first saved, so this is also done when it is created.
+
+*******************************************************************************/
+void ChangeWatcher::watchBuildopts()
+{
+  _buildopts_wd = inotify_add_watch(_fd, "/var/lib/sboui/buildopts",
+                                    WATCH_FILES | IN_ONLYDIR);
+}
+
+/*******************************************************************************
+
+Starts watching for changes, replacing any previous watches. Returns 0 on
+success or 1 if inotify is not available. Directories that cannot be watched
+(e.g. because they do not exist) are skipped.
+
+*******************************************************************************/
+int ChangeWatcher::start(const std::string & repo_dir,
+                         const std::vector<std::string> & categories)
+{
+  unsigned int i, ncategories;
+  int wd;
+
+  stop();
+
+  _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (_fd < 0) { return 1; }
+
+  _repo_path = repo_dir;
+  _pkg_wd = inotify_add_watch(_fd, _pkg_path.c_str(),
+                              WATCH_DIR_ENTRIES | IN_ONLYDIR);
+  _sboui_wd = inotify_add_watch(_fd, "/var/lib/sboui",
+                                WATCH_FILES | IN_ONLYDIR);
+  watchBuildopts();
+  _repo_wd = inotify_add_watch(_fd, _repo_path.c_str(),
+                               WATCH_FILES | IN_ONLYDIR);
+  ncategories = categories.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    wd = inotify_add_watch(_fd, (_repo_path + "/" + categories[i]).c_str(),
+                           WATCH_DIR_ENTRIES | IN_ONLYDIR);
+    if (wd >= 0) { _category_wds.push_back(wd); }
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Stops watching and discards pending changes
+
+*******************************************************************************/
+void ChangeWatcher::stop()
+{
+  if (_fd >= 0) { close(_fd); }   // Also removes all watches
+  _fd = -1;
+  _pkg_wd = -1;
+  _buildopts_wd = -1;
+  _sboui_wd = -1;
+  _repo_wd = -1;
+  _category_wds.resize(0);
+  _pending.packages.resize(0);
+  _pending.buildopts.resize(0);
+  _pending.repo = false;
+  _have_pending = false;
+}
+
+bool ChangeWatcher::active() const { return (_fd >= 0); }
+
+/*******************************************************************************
+
+Reads all available events without blocking and adds them to pending changes.
+If the event queue overflowed or a repository directory went away, the whole
+repository is marked as changed.
+
+*******************************************************************************/
+void ChangeWatcher::readEvents()
+{
+  char buf[4096]
+    __attribute__ ((aligned(__alignof__(struct inotify_event))));
+  const struct inotify_event *event;
+  ssize_t len;
+  char *ptr;
+  std::string fname, name, version, arch, build;
+  std::size_t ext_idx;
+  bool changed;
+
+  while (1)
+  {
+    len = read(_fd, buf, sizeof(buf));
+    if (len <= 0) { break; }
+
+    for ( ptr = buf; ptr < buf + len;
+          ptr += sizeof(struct inotify_event) + event->len )
+    {
+      event = (const struct inotify_event *) ptr;
+      if (event->len > 0) { fname = event->name; }
+      else { fname = ""; }
+      changed = true;
+
+      if (event->mask & IN_Q_OVERFLOW) { _pending.repo = true; }
+      else if (event->wd == _pkg_wd)
+      {
+        if ( (fname == "") || (fname[0] == '.') ||
+             (get_pkg_info(fname, name, version, arch, build) != 0) )
+          changed = false;
+        else
+          _pending.packages.push_back(name);
+      }
+      else if (event->wd == _buildopts_wd)
+      {
+        ext_idx = fname.find(".buildopts");
+        if (event->mask & IN_IGNORED) { _buildopts_wd = -1; }
+        if ( (ext_idx == std::string::npos) || (ext_idx == 0) )
+          changed = false;
+        else
+          _pending.buildopts.push_back(fname.substr(0,ext_idx));
+      }
+      else if (event->wd == _sboui_wd)
+      {
+        if (fname == "last-sync.txt") { _pending.repo = true; }
+        else
+        {
+          if ( (fname == "buildopts") && (event->mask & IN_ISDIR) &&
+               (event->mask & (IN_CREATE | IN_MOVED_TO)) )
+            watchBuildopts();
+          changed = false;
+        }
+      }
+      else
+      {
+        // Repository or category directory. Hidden files are skipped, which
+        // includes temporary files written by rsync.
+
+        if ( (fname == "") && (! (event->mask & IN_IGNORED)) )
+          changed = false;
+        else if ( (fname != "") && (fname[0] == '.') ) { changed = false; }
+        else { _pending.repo = true; }
+      }
+
+      if (changed)
+      {
+        _have_pending = true;
+        _last_event = watcher_time_ms();
+      }
+    }
+  }
+}
+
+/*******************************************************************************
+
+Gets changes once no new events have arrived for the debounce interval. Returns
+1 if there are changes, 0 otherwise.
+
+*******************************************************************************/
+int ChangeWatcher::poll(watched_changes & changes)
+{
+  if (_fd < 0) { return 0; }
+
+  readEvents();
+  if (! _have_pending) { return 0; }
+  if (watcher_time_ms() - _last_event < _debounce) { return 0; }
+
+  changes.packages.swap(_pending.packages);
+  changes.buildopts.swap(_pending.buildopts);
+  changes.repo = _pending.repo;
+  watcher_unique(changes.packages);
+  watcher_unique(changes.buildopts);
+
+  _pending.packages.resize(0);
+  _pending.buildopts.resize(0);
+  _pending.repo = false;
+  _have_pending = false;
+
+  return 1;
+}
+
+/*******************************************************************************
+
+Discards changes seen so far. Used after sboui installs or removes packages or
+saves build options itself, since those changes are already applied to the
+lists, and a repository change would be reported for sources downloaded into
+SlackBuild directories.
+
+*******************************************************************************/
+void ChangeWatcher::discard()
+{
+  if (_fd < 0) { return; }
+
+  readEvents();
+  _pending.packages.resize(0);
+  _pending.buildopts.resize(0);
+  _pending.repo = false;
+  _have_pending = false;
+}
@@ -71,7 +71,7 @@ void Color::addPair(const std::string & fg_label, const std::string & fg_name,
 {
   color_entry fg_entry, bg_entry;
   color_pair pair;
-  unsigned int npairs;
+  unsigned int npairs, i, nhandles;
   bool bright;
   std::string basename;
   int fg_color, bg_color;
@@ -117,16 +117,26 @@ void Color::addPair(const std::string & fg_label, const std::string & fg_name,
   _colors.push_back(pair);
 
   init_pair(pair.idx, fg_color, bg_color);
+
+  // Resolve handles waiting for this pair
+
+  nhandles = _handle_pairs.size();
+  for ( i = 0; i < nhandles; i++ )
+  {
+    if ( (_handle_pairs[i] == -1) && (_handle_fg[i] == fg_label) &&
+         (_handle_bg[i] == bg_label) )
+      _handle_pairs[i] = npairs-1;
+  }
 }
 
 /*******************************************************************************
 
-Get color pair from foreground and background labels. Returns index in the
-_colors vector or -1 if not found.
+Looks up color pair by foreground and background labels or by handle. Returns
+index in the _colors vector or -1 if not found.
 
 *******************************************************************************/
-int Color::getPair(const std::string & fg_label,
-                   const std::string & bg_label) const
+int Color::findPair(const std::string & fg_label,
+                    const std::string & bg_label) const
 {
   int i, npairs, vec_idx;
 
@@ -145,33 +155,67 @@ int Color::getPair(const std::string & fg_label,
   return vec_idx;
 }
 
+int Color::pairIndex(int handle) const
+{
+  if ( (handle < 0) || (handle >= int(_handle_pairs.size())) ) { return -1; }
+  return _handle_pairs[handle];
+}
+
+/*******************************************************************************
+
+Gets handle for foreground and background labels, adding one if needed. The
+handle can be used even if the pair does not exist yet; it is resolved when
+the pair is added.
+
+*******************************************************************************/
+int Color::getPair(const std::string & fg_label, const std::string & bg_label)
+{
+  int i, nhandles;
+
+  nhandles = _handle_pairs.size();
+  for ( i = 0; i < nhandles; i++ )
+  {
+    if ( (_handle_fg[i] == fg_label) && (_handle_bg[i] == bg_label) )
+      return i;
+  }
+  _handle_fg.push_back(fg_label);
+  _handle_bg.push_back(bg_label);
+  _handle_pairs.push_back(findPair(fg_label, bg_label));
+
+  return nhandles;
+}
+
 /*******************************************************************************
 
 Bold / blink properties. Return false for invalid pair.
 
 *******************************************************************************/
-bool Color::pairIsBold(int vec_idx) const
+bool Color::pairIsBold(int handle) const
 {
-  color_pair mypair;
+  const color_pair *mypair;
+  int vec_idx;
 
   // Get color pair
 
-  if ( (vec_idx == -1) || (vec_idx >= int(_colors.size())) ) { return false; }
-  mypair = _colors[vec_idx];
+  vec_idx = pairIndex(handle);
+  if (vec_idx == -1) { return false; }
+  mypair = &_colors[vec_idx];
 
-  return mypair.use_bold;
+  return mypair->use_bold;
 }
 
-bool Color::pairBlinks(int vec_idx) const
+bool Color::pairBlinks(int handle) const
 {
-  color_pair mypair;
+  const color_pair *mypair;
+  int vec_idx;
 
   // Get color pair
 
-  if ( (vec_idx == -1) || (vec_idx >= int(_colors.size())) ) { return false; }
-  mypair = _colors[vec_idx];
+  vec_idx = pairIndex(handle);
+  if (vec_idx == -1) { return false; }
+  mypair = &_colors[vec_idx];
 
-  return mypair.use_blink;
+  return mypair->use_blink;
 }
 
 /*******************************************************************************
@@ -182,54 +226,54 @@ Turn color on or off
 int Color::turnOn(WINDOW *win, const std::string & fg_label,
                   const std::string & bg_label)
 {
-  color_pair mypair;
+  const color_pair *mypair;
 
   // Get color pair
 
-  _active_pair = getPair(fg_label, bg_label);
+  _active_pair = findPair(fg_label, bg_label);
   if (_active_pair == -1) { return 1; }
-  mypair = _colors[_active_pair];
+  mypair = &_colors[_active_pair];
 
   // Turn on attributes
 
-  wattron(win, COLOR_PAIR(mypair.idx));
-  if (mypair.use_bold) { wattron(win, A_BOLD); }
-  if (mypair.use_blink) { wattron(win, A_BLINK); }
+  wattron(win, COLOR_PAIR(mypair->idx));
+  if (mypair->use_bold) { wattron(win, A_BOLD); }
+  if (mypair->use_blink) { wattron(win, A_BLINK); }
 
   return 0;
 }
 
-int Color::turnOn(WINDOW *win, int vec_idx)
+int Color::turnOn(WINDOW *win, int handle)
 {
-  color_pair mypair;
+  const color_pair *mypair;
 
   // Get color pair
 
-  if ( (vec_idx == -1) || (vec_idx >= int(_colors.size())) ) { return 1; }
-  _active_pair = vec_idx;
-  mypair = _colors[_active_pair];
+  _active_pair = pairIndex(handle);
+  if (_active_pair == -1) { return 1; }
+  mypair = &_colors[_active_pair];
 
   // Turn on attributes
 
-  wattron(win, COLOR_PAIR(mypair.idx));
-  if (mypair.use_bold) { wattron(win, A_BOLD); }
-  if (mypair.use_blink) { wattron(win, A_BLINK); }
+  wattron(win, COLOR_PAIR(mypair->idx));
+  if (mypair->use_bold) { wattron(win, A_BOLD); }
+  if (mypair->use_blink) { wattron(win, A_BLINK); }
 
   return 0;
 }
 
 int Color::turnOff(WINDOW *win)
 {
-  color_pair mypair;
+  const color_pair *mypair;
 
   if (_active_pair == -1) { return 1; }
-  mypair = _colors[_active_pair];
+  mypair = &_colors[_active_pair];
 
   // Turn off attributes
 
-  wattroff(win, COLOR_PAIR(mypair.idx));
-  if (mypair.use_bold) { wattroff(win, A_BOLD); }
-  if (mypair.use_blink) { wattroff(win, A_BLINK); }
+  wattroff(win, COLOR_PAIR(mypair->idx));
+  if (mypair->use_bold) { wattroff(win, A_BOLD); }
+  if (mypair->use_blink) { wattroff(win, A_BLINK); }
 
   return 0;
 }
@@ -237,45 +281,49 @@ int Color::turnOff(WINDOW *win)
 int Color::setBackground(WINDOW *win, const std::string & fg_label,
                          const std::string & bg_label) const
 {
-  color_pair mypair;
+  const color_pair *mypair;
   int vec_idx;
 
   // Get color pair
 
-  vec_idx = getPair(fg_label, bg_label);
+  vec_idx = findPair(fg_label, bg_label);
   if (vec_idx == -1) { return 1; }
-  mypair = _colors[vec_idx];
+  mypair = &_colors[vec_idx];
 
   // Set background color
 
-  wbkgd(win, COLOR_PAIR(mypair.idx));
+  wbkgd(win, COLOR_PAIR(mypair->idx));
 
   return 0;
 }
 
-int Color::setBackground(WINDOW *win, int vec_idx) const
+int Color::setBackground(WINDOW *win, int handle) const
 {
-  color_pair mypair;
+  const color_pair *mypair;
+  int vec_idx;
 
   // Get color pair
 
-  if ( (vec_idx == -1) || (vec_idx >= int(_colors.size())) ) { return 1; }
-  mypair = _colors[vec_idx];
+  vec_idx = pairIndex(handle);
+  if (vec_idx == -1) { return 1; }
+  mypair = &_colors[vec_idx];
 
   // Set background color
 
-  wbkgd(win, COLOR_PAIR(mypair.idx));
+  wbkgd(win, COLOR_PAIR(mypair->idx));
 
   return 0;
 }
 
 /*******************************************************************************
 
-Clears all colors
+Clears all colors. Handles are kept but resolve to nothing until their pairs
+are added again.
 
 *******************************************************************************/
 void Color::clear()
 {
   _colors.resize(0);
   _active_pair = -1;
+  _handle_pairs.assign(_handle_pairs.size(), -1);
 }
@@ -4,6 +4,7 @@
 #include "Color.h"
 #include "settings.h"
 #include "signals.h"
+#include "CursesWidget.h"
 #include "ListItem.h"
 #include "InputItem.h"
 #include "InputBox.h"
@@ -60,7 +61,7 @@ std::string ComboBox::execList(int y_offset, MouseEvent * mevent)
   top = std::floor(double(rows)/2.);
   mvwin(_listwin, top, left);
   wresize(_listwin, 0, 0);
-  wrefresh(_listwin);
+  wnoutrefresh(_listwin);
   _parent->draw(true);
 
   return retval;
@@ -181,7 +182,7 @@ void ComboBox::draw(int y_offset, bool force, bool highlight)
   {
     if (highlight) { wattroff(_win, A_REVERSE); }
   }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -209,7 +210,7 @@ std::string ComboBox::exec(int y_offset, MouseEvent * mevent)
     
     // Get user input
 
-    switch (ch = getch()) {
+    switch (ch = CursesWidget::readKey()) {
 
       // Enter key: return Enter signal
 
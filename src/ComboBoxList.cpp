@@ -25,8 +25,7 @@ screen or not.
 *******************************************************************************/
 void ComboBoxList::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
-  int rows, cols, rowsavail, lastrow;
+  int rows, cols, rowsavail, lastrow, color_pair;
 
   getmaxyx(_win, rows, cols);
   rowsavail = rows-_reserved_rows;
@@ -40,22 +39,14 @@ void ComboBoxList::redrawSingleItem(unsigned int idx)
 
   if (int(idx) == _highlight)
   {
-    if (_activated) 
-    { 
-      fg = "fg_highlight_active"; 
-      bg = "bg_highlight_active"; 
-    }
-    else
-    {
-      fg = "fg_highlight_inactive"; 
-      bg = "bg_highlight_inactive"; 
-    }
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (_activated) { color_pair = _highlight_active_pair; }
+    else { color_pair = _highlight_inactive_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
     }
   } 
-  else { colors.turnOn(_win, "fg_combobox", "bg_combobox"); }
+  else { colors.turnOn(_win, _color_pair); }
 
   // Save highlight idx for redrawing later.
   // Note: prevents this method from being const.
@@ -90,6 +81,7 @@ ComboBoxList::ComboBoxList()
   _header_rows = 0;
   clearButtons();
   setModal(false);
+  setColor("fg_combobox", "bg_combobox");
 }
 
 ComboBoxList::ComboBoxList(WINDOW *win) 
@@ -99,6 +91,7 @@ ComboBoxList::ComboBoxList(WINDOW *win)
   _header_rows = 0;
   clearButtons();
   setModal(false);
+  setColor("fg_combobox", "bg_combobox");
 }
 
 /*******************************************************************************
@@ -161,13 +154,13 @@ void ComboBoxList::draw(bool force)
   if (_redraw_type == "all")
   {
     clearWindow();
-    colors.setBackground(_win, "fg_combobox", "bg_combobox");
+    colors.setBackground(_win, _color_pair);
   }
   if (_redraw_type != "none") { redrawFrame(); }
   if ( (_redraw_type == "all") || (_redraw_type == "items") ) {
                                                             redrawAllItems(); }
   else if (_redraw_type == "changed") { redrawChangedItems(); }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -0,0 +1,120 @@
+#include <string>
+#include <vector>
+#include "ComboBox.h"
+#include "Label.h"
+#include "string_util.h"
+#include "CompositeFilterBox.h"
+
+const char *CompositeFilterBox::_filter_names[] = {
+  "Installed", "Upgradable", "Tagged", "Blacklisted", "Non-dependencies",
+  "Build options set"
+};
+
+/*******************************************************************************
+
+Adds a label
+
+*******************************************************************************/
+void CompositeFilterBox::addLabel(const std::string & name, int posy)
+{
+  Label *label;
+
+  label = new Label();
+  label->setName(name);
+  label->setWidth(name.size());
+  label->setPosition(posy,1);
+  addItem(label);
+  _labels.push_back(label);
+}
+
+/*******************************************************************************
+
+Constructor and destructor
+
+*******************************************************************************/
+CompositeFilterBox::CompositeFilterBox()
+{
+  unsigned int i;
+
+  _firstprint = _header_rows;
+  _msg = "Combine filters";
+
+  addLabel("Match", 3);
+  _matchbox.setParent(this);
+  _matchbox.addChoice("all");
+  _matchbox.addChoice("any");
+  addItem(&_matchbox);
+  _matchbox.setPosition(3,20);
+
+  for ( i = 0; i < _nfilters; i++ )
+  {
+    addLabel(_filter_names[i], i+5);
+    _filterboxes[i].setParent(this);
+    _filterboxes[i].addChoice("ignore");
+    _filterboxes[i].addChoice("yes");
+    _filterboxes[i].addChoice("no");
+    addItem(&_filterboxes[i]);
+    _filterboxes[i].setPosition(i+5,20);
+  }
+}
+
+CompositeFilterBox::~CompositeFilterBox()
+{
+  unsigned int i, nlabels;
+
+  nlabels = _labels.size();
+  for ( i = 0; i < nlabels; i++ ) { delete _labels[i]; }
+}
+
+/*******************************************************************************
+
+Get attributes
+
+*******************************************************************************/
+bool CompositeFilterBox::matchAll() const
+{
+  return (_matchbox.choice() == "all");
+}
+
+void CompositeFilterBox::filters(std::vector<std::string> & include,
+                                 std::vector<std::string> & exclude) const
+{
+  unsigned int i;
+
+  include.resize(0);
+  exclude.resize(0);
+  for ( i = 0; i < _nfilters; i++ )
+  {
+    if (_filterboxes[i].choice() == "yes")
+      include.push_back(_filter_names[i]);
+    else if (_filterboxes[i].choice() == "no")
+      exclude.push_back(_filter_names[i]);
+  }
+}
+
+/*******************************************************************************
+
+Describes the combined filter, e.g. "installed and not blacklisted"
+
+*******************************************************************************/
+std::string CompositeFilterBox::description() const
+{
+  unsigned int i;
+  std::string desc, term;
+
+  for ( i = 0; i < _nfilters; i++ )
+  {
+    if (_filterboxes[i].choice() == "ignore") { continue; }
+    term = string_to_lower(_filter_names[i]);
+    if (_filterboxes[i].choice() == "no") { term = "not " + term; }
+    if (desc.size() > 0)
+    {
+      if (matchAll()) { desc += " and "; }
+      else { desc += " or "; }
+    }
+    desc += term;
+  }
+  if (desc.size() == 0) { desc = "all"; }
+
+  return desc;
+}
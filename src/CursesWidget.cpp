@@ -115,7 +115,7 @@ Redraws buttons at bottom of list box
 *******************************************************************************/
 void CursesWidget::redrawButtons()
 {
-  int rows, cols, nbuttons, namelen, i, left, color_pair;
+  int rows, cols, nbuttons, namelen, i, left;
   double mid;
 
   getmaxyx(_win, rows, cols);
@@ -137,13 +137,12 @@ void CursesWidget::redrawButtons()
       _button_left[i] = _button_right[i-1] + 1;
       _button_right[i] = _button_left[i] + _buttons[i].size()-1;
     }
-    color_pair = colors.getPair(_button_fg, _button_bg);
     wmove(_win, rows-2, left);
     for ( i = 0; i < nbuttons; i++ )
     {
       if (i == _highlighted_button)
       {
-        if (colors.turnOn(_win, color_pair) != 0)
+        if (colors.turnOn(_win, _button_pair) != 0)
           wattron(_win, A_REVERSE);
         wprintw(_win, "%s", _buttons[i].c_str());
         if (colors.turnOff(_win) != 0)
@@ -157,6 +156,28 @@ void CursesWidget::redrawButtons()
 
 /*******************************************************************************
 
+Gets color pair handles for the default, button, and highlight colors
+
+*******************************************************************************/
+void CursesWidget::resolveColors()
+{
+  _color_pair = colors.getPair(_fg_color, _bg_color);
+  _hotkey_pair = colors.getPair("hotkey", _bg_color);
+  _tagged_pair = colors.getPair("tagged", _bg_color);
+  _title_pair = colors.getPair("fg_title", "bg_title");
+  _button_pair = colors.getPair(_button_fg, _button_bg);
+  _highlight_active_pair = colors.getPair("fg_highlight_active",
+                                          "bg_highlight_active");
+  _highlight_inactive_pair = colors.getPair("fg_highlight_inactive",
+                                            "bg_highlight_inactive");
+  _tagged_active_pair = colors.getPair("tagged", "bg_highlight_active");
+  _tagged_inactive_pair = colors.getPair("tagged", "bg_highlight_inactive");
+  _hotkey_active_pair = colors.getPair("hotkey", "bg_highlight_active");
+  _hotkey_inactive_pair = colors.getPair("hotkey", "bg_highlight_inactive");
+}
+
+/*******************************************************************************
+
 Constructor
 
 *******************************************************************************/
@@ -173,6 +194,7 @@ CursesWidget::CursesWidget()
   _bg_color = "bg_normal";
   _highlighted_button = 0;
   _redraw_type = "all";
+  resolveColors();
 }
 
 /*******************************************************************************
@@ -219,6 +241,7 @@ void CursesWidget::setButtonColor(const std::string & button_fg,
 {
   _button_fg = button_fg;
   _button_bg = button_bg;
+  _button_pair = colors.getPair(_button_fg, _button_bg);
 }
 
 void CursesWidget::setColor(const std::string & fg_color,
@@ -226,6 +249,7 @@ void CursesWidget::setColor(const std::string & fg_color,
 {
   _fg_color = fg_color;
   _bg_color = bg_color;
+  resolveColors();
 }
 
 /*******************************************************************************
@@ -279,6 +303,19 @@ const std::string & CursesWidget::bgColor() const { return _bg_color; }
 
 /*******************************************************************************
 
+Writes pending screen updates and reads a key. Windows are staged with
+wnoutrefresh when drawn, so doupdate writes only the cells that differ from
+what the terminal already shows, in a single pass.
+
+*******************************************************************************/
+int CursesWidget::readKey()
+{
+  doupdate();
+  return getch();
+}
+
+/*******************************************************************************
+
 Hides a window by putting it at the center of the screen and giving it 0 size
 
 *******************************************************************************/
@@ -0,0 +1,279 @@
+#include <string>
+#include <vector>
+#include <algorithm>       // max
+#include "BuildListItem.h"
+#include "backend.h"       // get_reqs, find_slackbuild
+#include "string_util.h"   // split
+#include "DepGraph.h"
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+DepGraph::DepGraph() { clear(); }
+
+/*******************************************************************************
+
+Builds graph from list of SlackBuilds. Requirements already read from the repo
+(or repository index) are used directly; otherwise, they are read from the
+.info file.
+
+*******************************************************************************/
+void DepGraph::build(std::vector<std::vector<BuildListItem> > & slackbuilds)
+{
+  unsigned int i, j, ncategories, nbuilds, nnodes, k, ndeps, n;
+  int node, check, idx0, idx1;
+  std::vector<std::vector<unsigned int> > deps;
+  std::vector<unsigned int> last_dependent, cursor;
+  std::vector<std::string> deplist;
+  std::string reqs;
+
+  clear();
+
+  // Number nodes in list order
+
+  ncategories = slackbuilds.size();
+  nnodes = 0;
+  for ( i = 0; i < ncategories; i++ )
+  {
+    _cat_offsets.push_back(nnodes);
+    nbuilds = slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      _nodes.push_back(&slackbuilds[i][j]);
+    }
+    nnodes += nbuilds;
+  }
+
+  // Resolve requirements for each node
+
+  deps.resize(nnodes);
+  _info_missing.assign(nnodes, 0);
+  _req_missing.assign(nnodes, 0);
+#pragma omp parallel for schedule(dynamic,64) \
+                         private(reqs,deplist,check,ndeps,k,idx0,idx1)
+  for ( node = 0; node < int(nnodes); node++ )
+  {
+    if (_nodes[node]->repoInfoCheck() == 0)
+      reqs = _nodes[node]->getProp("requires");
+    else
+    {
+      check = get_reqs(*_nodes[node], reqs);
+      if (check != 0) { _info_missing[node] = 1; }
+    }
+
+    deplist = split(reqs);
+    ndeps = deplist.size();
+    for ( k = 0; k < ndeps; k++ )
+    {
+      if (deplist[k] == "%README%") { continue; }
+      if (find_slackbuild(deplist[k], slackbuilds, idx0, idx1) == 0)
+        deps[node].push_back(_cat_offsets[idx0] + idx1);
+      else
+        _req_missing[node] = 1;
+    }
+  }
+
+  // Forward edges
+
+  _fwd_offsets.resize(nnodes+1);
+  _fwd_offsets[0] = 0;
+  for ( n = 0; n < nnodes; n++ )
+  {
+    _fwd_offsets[n+1] = _fwd_offsets[n] + deps[n].size();
+  }
+  _fwd_edges.reserve(_fwd_offsets[nnodes]);
+  for ( n = 0; n < nnodes; n++ )
+  {
+    _fwd_edges.insert(_fwd_edges.end(), deps[n].begin(), deps[n].end());
+  }
+
+  // Reverse edges, in increasing node order. A SlackBuild that lists the same
+  // requirement twice is only added once.
+
+  _rev_offsets.assign(nnodes+1, 0);
+  last_dependent.assign(nnodes, nnodes);
+  for ( n = 0; n < nnodes; n++ )
+  {
+    for ( k = _fwd_offsets[n]; k < _fwd_offsets[n+1]; k++ )
+    {
+      if (last_dependent[_fwd_edges[k]] == n) { continue; }
+      last_dependent[_fwd_edges[k]] = n;
+      _rev_offsets[_fwd_edges[k]+1]++;
+    }
+  }
+  for ( n = 0; n < nnodes; n++ ) { _rev_offsets[n+1] += _rev_offsets[n]; }
+
+  _rev_edges.resize(_rev_offsets[nnodes]);
+  last_dependent.assign(nnodes, nnodes);
+  cursor.assign(_rev_offsets.begin(), _rev_offsets.end()-1);
+  for ( n = 0; n < nnodes; n++ )
+  {
+    for ( k = _fwd_offsets[n]; k < _fwd_offsets[n+1]; k++ )
+    {
+      if (last_dependent[_fwd_edges[k]] == n) { continue; }
+      last_dependent[_fwd_edges[k]] = n;
+      _rev_edges[cursor[_fwd_edges[k]]++] = n;
+    }
+  }
+}
+
+void DepGraph::clear()
+{
+  _nodes.resize(0);
+  _cat_offsets.resize(0);
+  _fwd_offsets.assign(1, 0);
+  _fwd_edges.resize(0);
+  _rev_offsets.assign(1, 0);
+  _rev_edges.resize(0);
+  _info_missing.resize(0);
+  _req_missing.resize(0);
+}
+
+/*******************************************************************************
+
+Number of nodes and node ID for a SlackBuild by name. Returns 1 if not found.
+
+*******************************************************************************/
+unsigned int DepGraph::size() const { return _nodes.size(); }
+
+int DepGraph::nodeID(const std::string & name,
+                     std::vector<std::vector<BuildListItem> > & slackbuilds,
+                     unsigned int & node) const
+{
+  int idx0, idx1;
+
+  if (find_slackbuild(name, slackbuilds, idx0, idx1) != 0) { return 1; }
+  if (idx0 >= int(_cat_offsets.size())) { return 1; }
+  node = _cat_offsets[idx0] + idx1;
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Visits requirements of a node depth-first, adding each requirement after its
+own requirements. Requirements are visited in reverse REQUIRES order, which
+gives the same build order as moving each requirement to the end of the list
+every time it is encountered and reversing the list at the end. A SlackBuild
+that is not installed and has no .info file has no known requirements.
+
+*******************************************************************************/
+void DepGraph::visitReqs(unsigned int node, std::vector<bool> & visited,
+                         std::vector<BuildListItem *> & reqlist,
+                         int & maxcheck) const
+{
+  unsigned int k, dep;
+
+  if ( (! _nodes[node]->installed()) && (_info_missing[node]) )
+  {
+    maxcheck = std::max(maxcheck, 2);
+    return;
+  }
+  if (_req_missing[node]) { maxcheck = std::max(maxcheck, 1); }
+
+  for ( k = _fwd_offsets[node+1]; k > _fwd_offsets[node]; k-- )
+  {
+    dep = _fwd_edges[k-1];
+    if (visited[dep]) { continue; }
+    visited[dep] = true;
+    visitReqs(dep, visited, reqlist, maxcheck);
+    reqlist.push_back(_nodes[dep]);
+  }
+}
+
+/*******************************************************************************
+
+Computes list of requirements for a node in build order. Returns 1 if a
+requirement is not in the repository, 2 if a .info file is missing, or 0
+otherwise.
+
+*******************************************************************************/
+int DepGraph::reqsOrder(unsigned int node,
+                        std::vector<BuildListItem *> & reqlist) const
+{
+  std::vector<bool> visited;
+  int maxcheck;
+
+  reqlist.resize(0);
+  visited.assign(_nodes.size(), false);
+  visited[node] = true;
+  maxcheck = 0;
+  visitReqs(node, visited, reqlist, maxcheck);
+
+  return maxcheck;
+}
+
+/*******************************************************************************
+
+Visits installed SlackBuilds depending on a node depth-first, in decreasing
+node order, adding each one after the ones that depend on it
+
+*******************************************************************************/
+void DepGraph::visitInvReqs(unsigned int node, std::vector<bool> & visited,
+                            std::vector<BuildListItem *> & invreqlist) const
+{
+  unsigned int k, dependent;
+
+  for ( k = _rev_offsets[node+1]; k > _rev_offsets[node]; k-- )
+  {
+    dependent = _rev_edges[k-1];
+    if ( (visited[dependent]) || (! _nodes[dependent]->installed()) )
+      continue;
+    visited[dependent] = true;
+    visitInvReqs(dependent, visited, invreqlist);
+    invreqlist.push_back(_nodes[dependent]);
+  }
+}
+
+/*******************************************************************************
+
+Computes list of installed SlackBuilds that depend on a node, directly or
+indirectly. The list is in the same order as when each one is moved to the end
+of the list every time it is encountered, going through installed SlackBuilds
+in list order.
+
+*******************************************************************************/
+void DepGraph::invReqs(unsigned int node,
+                       std::vector<BuildListItem *> & invreqlist) const
+{
+  std::vector<bool> visited;
+
+  invreqlist.resize(0);
+  visited.assign(_nodes.size(), false);
+  visited[node] = true;
+  visitInvReqs(node, visited, invreqlist);
+  std::reverse(invreqlist.begin(), invreqlist.end());
+}
+
+/*******************************************************************************
+
+Lists installed SlackBuilds that are not required by any other installed
+SlackBuild, in node order. Counts installed dependents of each node in one pass
+over the edges of installed nodes.
+
+*******************************************************************************/
+void DepGraph::nonDeps(std::vector<BuildListItem *> & nondeplist) const
+{
+  std::vector<unsigned int> indegree;
+  unsigned int n, k, nnodes;
+
+  nondeplist.resize(0);
+  nnodes = _nodes.size();
+  indegree.assign(nnodes, 0);
+  for ( n = 0; n < nnodes; n++ )
+  {
+    if (! _nodes[n]->installed()) { continue; }
+    for ( k = _fwd_offsets[n]; k < _fwd_offsets[n+1]; k++ )
+    {
+      if (_fwd_edges[k] != n) { indegree[_fwd_edges[k]]++; }
+    }
+  }
+
+  for ( n = 0; n < nnodes; n++ )
+  {
+    if ( (_nodes[n]->installed()) && (indegree[n] == 0) )
+      nondeplist.push_back(_nodes[n]);
+  }
+}
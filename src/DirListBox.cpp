@@ -18,7 +18,7 @@ screen or not.
 *******************************************************************************/
 void DirListBox::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
+  int color_pair;
 
   // Go to item location, optionally highlight, and print item
 
@@ -28,17 +28,9 @@ void DirListBox::redrawSingleItem(unsigned int idx)
 
   if (int(idx) == _highlight)
   {
-    if (_activated) 
-    { 
-      fg = "fg_highlight_active"; 
-      bg = "bg_highlight_active"; 
-    }
-    else
-    {
-      fg = "fg_highlight_inactive"; 
-      bg = "bg_highlight_inactive"; 
-    }
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (_activated) { color_pair = _highlight_active_pair; }
+    else { color_pair = _highlight_inactive_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
     }
@@ -240,7 +232,7 @@ std::string DirListBox::exec(MouseEvent * mevent)
   
     // Get user input
   
-    switch (ch = getch()) {
+    switch (ch = readKey()) {
   
       // Enter key: accept selection
   
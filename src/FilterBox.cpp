@@ -22,9 +22,11 @@ FilterBox::FilterBox()
   addItem(new ListItem("Blacklisted"));
   addItem(new ListItem("Non-dependencies"));
   addItem(new ListItem("Build options set"));
+  addItem(new ListItem("Combine filters..."));
 
   for ( i = 0; i < 6; i++ ) { _items[i]->setHotKey(0); }
   _items[6]->setHotKey(3);
+  _items[7]->setHotKey(0);
 }
 
 FilterBox::FilterBox(WINDOW *win, const std::string & name)
@@ -41,9 +43,11 @@ FilterBox::FilterBox(WINDOW *win, const std::string & name)
   addItem(new ListItem("Blacklisted"));
   addItem(new ListItem("Non-dependencies"));
   addItem(new ListItem("Build options set"));
+  addItem(new ListItem("Combine filters..."));
 
   for ( i = 0; i < 6; i++ ) { _items[i]->setHotKey(0); }
   _items[6]->setHotKey(3);
+  _items[7]->setHotKey(0);
 }
 
 FilterBox::~FilterBox()
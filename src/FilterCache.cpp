@@ -0,0 +1,154 @@
+#include <string>
+#include <vector>
+#include <map>
+#include "BuildListItem.h"
+#include "BuildSet.h"
+#include "filters.h"        // filtering functions
+#include "requirements.h"   // get_dep_graph
+#include "FilterCache.h"
+
+/*******************************************************************************
+
+Evaluates a filter over the master list. Returns 1 for an unknown filter.
+
+*******************************************************************************/
+int FilterCache::evaluate(const std::string & filter, BuildSet & set) const
+{
+  unsigned int i, j, ncategories, nbuilds, nnondeps;
+  bool (*func)(const BuildListItem &);
+  std::vector<BuildListItem *> nondeplist;
+
+  set.reset(_nbuilds, false);
+  if (! _slackbuilds) { return 0; }
+
+  if (filter == "All") { func = &any_build; }
+  else if (filter == "Installed") { func = &build_is_installed; }
+  else if (filter == "Upgradable") { func = &build_is_upgradable; }
+  else if (filter == "Tagged") { func = &build_is_tagged; }
+  else if (filter == "Blacklisted") { func = &build_is_blacklisted; }
+  else if (filter == "Build options set") { func = &build_has_buildoptions; }
+  else if (filter == "Non-dependencies")
+  {
+    get_dep_graph(*_slackbuilds).nonDeps(nondeplist);
+    nnondeps = nondeplist.size();
+    for ( i = 0; i < nnondeps; i++ ) { set.set(nondeplist[i]->id()); }
+    return 0;
+  }
+  else { return 1; }
+
+  ncategories = _slackbuilds->size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = (*_slackbuilds)[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      if (func((*_slackbuilds)[i][j])) { set.set((*_slackbuilds)[i][j].id()); }
+    }
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+FilterCache::FilterCache()
+{
+  _slackbuilds = NULL;
+  _nbuilds = 0;
+}
+
+/*******************************************************************************
+
+Sets master list and assigns build IDs in list order. Clears the cache.
+
+*******************************************************************************/
+void FilterCache::setBuilds(
+                         std::vector<std::vector<BuildListItem> > & slackbuilds)
+{
+  unsigned int i, j, ncategories, nbuilds;
+
+  _slackbuilds = &slackbuilds;
+  _nbuilds = 0;
+  ncategories = slackbuilds.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      slackbuilds[i][j].setId(_nbuilds);
+      _nbuilds++;
+    }
+  }
+  _sets.clear();
+}
+
+unsigned int FilterCache::numBuilds() const { return _nbuilds; }
+
+/*******************************************************************************
+
+Invalidates one or all cached filters
+
+*******************************************************************************/
+void FilterCache::invalidate(const std::string & filter)
+{
+  _sets.erase(filter);
+}
+
+void FilterCache::invalidate() { _sets.clear(); }
+
+/*******************************************************************************
+
+Gets a filter, evaluating it if it is not cached
+
+*******************************************************************************/
+int FilterCache::get(const std::string & filter, BuildSet & set)
+{
+  std::map<std::string, BuildSet>::const_iterator it;
+
+  it = _sets.find(filter);
+  if (it != _sets.end())
+  {
+    set = it->second;
+    return 0;
+  }
+  if (evaluate(filter, set) != 0) { return 1; }
+  _sets[filter] = set;
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Combines filters
+
+*******************************************************************************/
+int FilterCache::combine(const std::vector<std::string> & include,
+                         const std::vector<std::string> & exclude,
+                         bool match_all, BuildSet & set)
+{
+  unsigned int i, ninclude, nexclude;
+  BuildSet term;
+
+  ninclude = include.size();
+  nexclude = exclude.size();
+  set.reset(_nbuilds, (match_all || (ninclude + nexclude == 0)));
+  for ( i = 0; i < ninclude + nexclude; i++ )
+  {
+    if (i < ninclude)
+    {
+      if (get(include[i], term) != 0) { return 1; }
+    }
+    else
+    {
+      if (get(exclude[i-ninclude], term) != 0) { return 1; }
+      term.invert();
+    }
+    if (match_all) { set &= term; }
+    else { set |= term; }
+  }
+
+  return 0;
+}
@@ -0,0 +1,241 @@
+#include <string>
+#include <vector>
+#include <algorithm>    // partial_sort, min, max
+#include <utility>      // pair
+#include <cstring>      // memchr
+#include <stdint.h>
+#include "BuildListItem.h"
+#include "FuzzyMatcher.h"
+
+/*******************************************************************************
+
+Score weights
+
+*******************************************************************************/
+const int fuzzy_char_score = 16;
+const int fuzzy_first_bonus = 12;
+const int fuzzy_word_bonus = 10;
+const int fuzzy_consecutive_bonus = 8;
+const int fuzzy_gap_penalty = 3;
+const int fuzzy_gap_extension = 1;
+const int fuzzy_max_gap_penalty = 12;
+const int fuzzy_exact_bonus = 20;
+
+/*******************************************************************************
+
+Helpers: lower case, character bit masks, and word boundaries
+
+*******************************************************************************/
+char fuzzy_lower(char c)
+{
+  if ( (c >= 'A') && (c <= 'Z') ) { return c - 'A' + 'a'; }
+  return c;
+}
+
+uint64_t fuzzy_char_bit(char c)
+{
+  if ( (c >= 'a') && (c <= 'z') ) { return uint64_t(1) << (c - 'a'); }
+  if ( (c >= '0') && (c <= '9') ) { return uint64_t(1) << (26 + c - '0'); }
+  if (c == '-') { return uint64_t(1) << 36; }
+  if (c == '_') { return uint64_t(1) << 37; }
+  if (c == '.') { return uint64_t(1) << 38; }
+  if (c == '+') { return uint64_t(1) << 39; }
+  return uint64_t(1) << 63;
+}
+
+bool fuzzy_word_start(char prev, char c)
+{
+  bool prev_digit, digit;
+
+  if ( (prev == '-') || (prev == '_') || (prev == '.') || (prev == '+') )
+    return true;
+  prev_digit = ( (prev >= '0') && (prev <= '9') );
+  digit = ( (c >= '0') && (c <= '9') );
+
+  return (prev_digit != digit);
+}
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+FuzzyMatcher::FuzzyMatcher() { clear(); }
+
+/*******************************************************************************
+
+Stores lower-case names and character masks for all SlackBuilds in lists
+
+*******************************************************************************/
+void FuzzyMatcher::setItems(
+                      const std::vector<std::vector<BuildListItem *> > & lists)
+{
+  unsigned int i, j, k, ncategories, nbuilds, namelen;
+  uint64_t mask;
+  char c;
+
+  clear();
+  ncategories = lists.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = lists[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      const std::string & name = lists[i][j]->name();
+
+      namelen = name.size();
+      mask = 0;
+      for ( k = 0; k < namelen; k++ )
+      {
+        c = fuzzy_lower(name[k]);
+        _names.push_back(c);
+        mask |= fuzzy_char_bit(c);
+      }
+      _offsets.push_back(_names.size());
+      _masks.push_back(mask);
+      _categories.push_back(i);
+      _indices.push_back(j);
+    }
+  }
+}
+
+void FuzzyMatcher::clear()
+{
+  _names.clear();
+  _offsets.assign(1, 0);
+  _masks.resize(0);
+  _categories.resize(0);
+  _indices.resize(0);
+}
+
+unsigned int FuzzyMatcher::size() const { return _masks.size(); }
+
+/*******************************************************************************
+
+Scores one name. The query is first matched greedily from the left to find the
+earliest end of a match, and then from that end backwards to find the latest
+start, giving the shortest match ending there. That window is then scored.
+
+*******************************************************************************/
+int FuzzyMatcher::score(unsigned int idx, const std::string & query) const
+{
+  const char *name, *found;
+  unsigned int len, qlen, qi, start, end, i, prev, gap;
+  int total;
+
+  name = _names.data() + _offsets[idx];
+  len = _offsets[idx+1] - _offsets[idx];
+  qlen = query.size();
+  if (qlen > len) { return -1; }
+
+  // Earliest end
+
+  end = 0;
+  for ( qi = 0; qi < qlen; qi++ )
+  {
+    found = static_cast<const char *>(
+            std::memchr(name + end, query[qi], len - end));
+    if (found == NULL) { return -1; }
+    end = found - name + 1;
+  }
+  end--;
+
+  // Latest start for that end
+
+  start = end;
+  qi = qlen-1;
+  for ( i = end+1; i > 0; i-- )
+  {
+    if (name[i-1] != query[qi]) { continue; }
+    start = i-1;
+    if (qi == 0) { break; }
+    qi--;
+  }
+
+  // Score window
+
+  total = 0;
+  prev = start;
+  qi = 0;
+  for ( i = start; (i <= end) && (qi < qlen); i++ )
+  {
+    if (name[i] != query[qi]) { continue; }
+    total += fuzzy_char_score;
+    if (i == 0) { total += fuzzy_first_bonus; }
+    else if (fuzzy_word_start(name[i-1], name[i]))
+      total += fuzzy_word_bonus;
+    if (qi > 0)
+    {
+      gap = i - prev - 1;
+      if (gap == 0) { total += fuzzy_consecutive_bonus; }
+      else
+        total -= std::min(fuzzy_max_gap_penalty,
+                          fuzzy_gap_penalty + int(gap-1)*fuzzy_gap_extension);
+    }
+    prev = i;
+    qi++;
+  }
+  if (qlen == len) { total += fuzzy_exact_bonus; }
+
+  return std::max(total, 0);
+}
+
+/*******************************************************************************
+
+Finds best matches. Names missing any character of the query are ruled out by
+their masks; the rest are scored, and only the best max_results are sorted.
+Returns the number of names that match.
+
+*******************************************************************************/
+unsigned int FuzzyMatcher::match(const std::string & query,
+                                 unsigned int max_results,
+                                 std::vector<fuzzy_match> & matches) const
+{
+  std::string lquery;
+  std::vector<std::pair<int, unsigned int> > scored;
+  uint64_t qmask;
+  unsigned int i, nnames, nscored, nkeep;
+  int s;
+  fuzzy_match result;
+
+  matches.resize(0);
+  if (query.size() == 0) { return 0; }
+
+  lquery.resize(query.size());
+  qmask = 0;
+  for ( i = 0; i < query.size(); i++ )
+  {
+    lquery[i] = fuzzy_lower(query[i]);
+    qmask |= fuzzy_char_bit(lquery[i]);
+  }
+
+  nnames = _masks.size();
+  scored.reserve(nnames);
+  for ( i = 0; i < nnames; i++ )
+  {
+    if ((_masks[i] & qmask) != qmask) { continue; }
+    s = score(i, lquery);
+    if (s < 0) { continue; }
+
+    // Store negative score and length, so that sorting in increasing order
+    // gives decreasing score, then increasing length, then list order
+
+    scored.push_back(std::make_pair(-(s << 8) + std::min(
+                     int(_offsets[i+1] - _offsets[i]), 255), i));
+  }
+
+  nscored = scored.size();
+  nkeep = std::min(nscored, max_results);
+  std::partial_sort(scored.begin(), scored.begin()+nkeep, scored.end());
+
+  matches.reserve(nkeep);
+  for ( i = 0; i < nkeep; i++ )
+  {
+    result.category = _categories[scored[i].second];
+    result.index = _indices[scored[i].second];
+    result.score = (-scored[i].first + 255) >> 8;
+    matches.push_back(result);
+  }
+
+  return nscored;
+}
@@ -304,7 +304,7 @@ void InputBox::redrawFrame()
   left = std::floor(mid - double(msglen)/2.0) + 1;
   wmove(_win, 1, 1);
   wclrtoeol(_win);
-  if (colors.turnOn(_win, "fg_title", "bg_title") != 0)
+  if (colors.turnOn(_win, _title_pair) != 0)
     wattron(_win, A_BOLD);
   printSpaces(left-1);
   printToEol(_msg);
@@ -803,7 +803,7 @@ void InputBox::draw(bool force)
       if (_has_scroll_indicator) { redrawScrollIndicator(); }
     }
   }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -11,6 +11,7 @@
 #include "requirements.h"
 #include "backend.h"
 #include "BuildListItem.h"
+#include "BuildScheduler.h"
 #include "InstallBox.h"
 #include "MouseEvent.h"
 
@@ -34,7 +35,7 @@ void InstallBox::redrawFrame()
   left = std::floor(mid - double(namelen)/2.0);
   right = left + namelen;
   wmove(_win, 0, left);
-  if (colors.turnOn(_win, "fg_title", "bg_title") != 0)
+  if (colors.turnOn(_win, _title_pair) != 0)
     wattron(_win, A_BOLD);
   wprintw(_win, "%s", _name.c_str());
   if (colors.turnOff(_win) != 0)
@@ -123,9 +124,10 @@ screen or not.
 *******************************************************************************/
 void InstallBox::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
   int nspaces, actionlen, action_cols, vlineloc, printlen, rows, cols, i;
   unsigned int j, nitems;
+  int color_pair;
+  bool tagged;
 
   getmaxyx(_win, rows, cols);
 
@@ -148,26 +150,24 @@ void InstallBox::redrawSingleItem(unsigned int idx)
 
   // Turn on highlight color
 
+  tagged = _items[idx]->getBoolProp("tagged");
   if (int(idx) == _highlight)
   {
-    if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-    else { fg = "fg_highlight_active"; }
-    bg = "bg_highlight_active"; 
-
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (tagged) { color_pair = _tagged_active_pair; }
+    else { color_pair = _highlight_active_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); } 
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   } 
   else
   {
-    if (_items[idx]->getBoolProp("tagged")) { fg = "tagged"; }
-    else { fg = "fg_popup"; }
-    bg = "bg_popup";
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (tagged) { color_pair = _tagged_pair; }
+    else { color_pair = _color_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     {
-      if (_items[idx]->getBoolProp("tagged")) { wattron(_win, A_BOLD); } 
+      if (tagged) { wattron(_win, A_BOLD); } 
     }
   }
 
@@ -222,6 +222,7 @@ InstallBox::InstallBox()
   button_signals[2] = "a";
   setButtons(buttons, button_signals);
   _builds.resize(0);
+  _changed.resize(0);
   _ndeps = 0;
   _ninvdeps = 0;
 }
@@ -238,6 +239,7 @@ InstallBox::InstallBox(WINDOW *win, const std::string & name)
   button_signals[2] = "a";
   setButtons(buttons, button_signals);
   _builds.resize(0);
+  _changed.resize(0);
   _ndeps = 0;
   _ninvdeps = 0;
   _win = win;
@@ -418,6 +420,11 @@ int InstallBox::create(BuildListItem & build,
       }
       _builds[nbuilds]->setBoolProp("marked", mark);
       _builds[nbuilds]->setProp("action", action_applied);
+
+      // A reinstall chosen here is built again, even if a package built from
+      // the same inputs is in the package cache
+
+      _builds[nbuilds]->setBoolProp("rebuild", action_applied == "Reinstall");
       nbuilds++;
     }
     else
@@ -460,6 +467,10 @@ int InstallBox::create(BuildListItem & build,
         _builds[nbuilds]->setProp("action", "Upgrade");
       else
         _builds[nbuilds]->setProp("action", "Reinstall");
+
+      // Inverse deps whose inputs have not changed can use the package cache
+
+      _builds[nbuilds]->setBoolProp("rebuild", false);
       nbuilds++;
     }
   }
@@ -574,7 +585,7 @@ std::string InstallBox::exec(MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = readKey()) {
 
     // Enter key: accept selection
 
@@ -748,55 +759,89 @@ int InstallBox::applyChanges(int & ninstalled, int & nupgraded,
   unsigned int nbuilds, i;
   int retval;
   std::string action, response, msg;
+  std::vector<BuildListItem *> marked;
+  BuildScheduler scheduler;
+  bool prefetch;
 
   // Install/upgrade/reinstall/remove selected SlackBuilds
 
   nbuilds = _builds.size();
   retval = 0;
-  for ( i = 0; i < nbuilds; i++ )
+  _changed.resize(0);
+
+  // The built-in package manager can build separately from installing, so
+  // independent SlackBuilds can be built in parallel, and sources can be
+  // downloaded ahead of builds unless a source directory is already given
+
+  prefetch = settings::prefetch_sources &&
+             (settings::install_clos.find("sourcedir=") == std::string::npos) &&
+             (settings::upgrade_clos.find("sourcedir=") == std::string::npos);
+  if ( (settings::package_manager == "built-in") &&
+       ( (settings::build_jobs > 1) || prefetch ) )
   {
-    if (_builds[i]->getBoolProp("marked"))
+    for ( i = 0; i < nbuilds; i++ )
     {
-      action = _builds[i]->getProp("action");
-      if (action == "Install") { retval = install_slackbuild(*_builds[i]); }
-      else if (action == "Upgrade") { retval = 
-                                      upgrade_slackbuild(*_builds[i]); }
-      else if (action == "Remove") { retval = remove_slackbuild(*_builds[i]); }
-      else if (action == "Reinstall") { retval =
-                                        reinstall_slackbuild(*_builds[i]); }
-      else
+      if (_builds[i]->getBoolProp("marked")) { marked.push_back(_builds[i]); }
+    }
+    scheduler.setMaxJobs(settings::build_jobs);
+    scheduler.setPrefetch(prefetch);
+    scheduler.setBuilds(marked);
+    retval = scheduler.run(ninstalled, nupgraded, nreinstalled, nremoved);
+    scheduler.attemptedBuilds(_changed);
+    if (retval == 127) { std::cout << "Error: package manager not found. "; }
+    else if (retval != 0) { std::cout << "An error occurred. "; }
+  }
+  else
+  {
+    for ( i = 0; i < nbuilds; i++ )
+    {
+      if (_builds[i]->getBoolProp("marked"))
       {
-        std::cout << "Error: unrecognized action " + action + "." << std::endl;
-        retval = 1;
-      }
+        _changed.push_back(_builds[i]);
+        action = _builds[i]->getProp("action");
+        if (action == "Install")
+          retval = install_slackbuild(*_builds[i]);
+        else if (action == "Upgrade")
+          retval = upgrade_slackbuild(*_builds[i]);
+        else if (action == "Remove")
+          retval = remove_slackbuild(*_builds[i]);
+        else if (action == "Reinstall")
+          retval = reinstall_slackbuild(*_builds[i]);
+        else
+        {
+          std::cout << "Error: unrecognized action " + action + "."
+                    << std::endl;
+          retval = 1;
+        }
 
-      // Handle errors
+        // Handle errors
 
-      if (retval == 127)
-      {
-        std::cout << "Error: package manager not found. ";
-        break;
-      }
-      else if (retval != 0)
-      {
-        if (i != nbuilds-1)
+        if (retval == 127)
         {
-          std::cout << "An error occurred. Continue anyway [y/N]? ";
-          std::getline(std::cin, response);
-          if ( (response != "y") && (response != "Y") ) { return retval; }
+          std::cout << "Error: package manager not found. ";
+          break;
+        }
+        else if (retval != 0)
+        {
+          if (i != nbuilds-1)
+          {
+            std::cout << "An error occurred. Continue anyway [y/N]? ";
+            std::getline(std::cin, response);
+            if ( (response != "y") && (response != "Y") ) { return retval; }
+          }
+          else { std::cout << " An error occurred. "; }
         }
-        else { std::cout << " An error occurred. "; }
-      }
-      else
-      {
-        if (_builds[i]->getProp("action") == "Install")
-          ninstalled++;
-        else if (_builds[i]->getProp("action") == "Upgrade")
-          nupgraded++;
-        else if (_builds[i]->getProp("action") == "Reinstall")
-          nreinstalled++; 
         else
-          nremoved++; 
+        {
+          if (_builds[i]->getProp("action") == "Install")
+            ninstalled++;
+          else if (_builds[i]->getProp("action") == "Upgrade")
+            nupgraded++;
+          else if (_builds[i]->getProp("action") == "Reinstall")
+            nreinstalled++; 
+          else
+            nremoved++; 
+        }
       }
     }
   }
@@ -809,3 +854,14 @@ int InstallBox::applyChanges(int & ninstalled, int & nupgraded,
 
   return retval;
 } 
+
+/*******************************************************************************
+
+Returns SlackBuilds that applyChanges attempted to change, whether or not it
+succeeded. Their installed state has already been re-read.
+
+*******************************************************************************/
+const std::vector<BuildListItem *> & InstallBox::changedBuilds() const
+{
+  return _changed;
+}
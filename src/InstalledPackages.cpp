@@ -0,0 +1,182 @@
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>      // strncmp
+#include <dirent.h>
+#include <sys/stat.h>
+#include "backend.h"    // get_pkg_info
+#include "InstalledPackages.h"
+
+#ifndef PACKAGE_DIR
+  #define PACKAGE_DIR "/var/lib/pkgtools/packages"
+#endif
+
+/*******************************************************************************
+
+Constructors
+
+*******************************************************************************/
+InstalledPackages::InstalledPackages() { _path = PACKAGE_DIR; }
+InstalledPackages::InstalledPackages(const std::string & path)
+{
+  _path = path;
+}
+
+/*******************************************************************************
+
+Reads all entries in the package directory and parses their names. Returns 1 if
+the directory cannot be read; 0 otherwise.
+
+*******************************************************************************/
+int InstalledPackages::read()
+{
+  DIR *pdir;
+  struct dirent *pent;
+  installed_pkg entry;
+
+  _table.clear();
+  _invalid.resize(0);
+
+  pdir = opendir(_path.c_str());
+  if (pdir == NULL) { return 1; }
+  while ((pent = readdir(pdir)))
+  {
+    if (pent->d_name[0] == '.') { continue; }
+    entry.pkg = pent->d_name;
+    if (get_pkg_info(entry.pkg, entry.name, entry.version, entry.arch,
+                     entry.build) != 0)
+      _invalid.push_back(entry.pkg);
+    else if (_table.find(entry.name) == _table.end())
+      _table[entry.name] = entry;
+  }
+  closedir(pdir);
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Checks whether an entry exists in the package directory
+
+*******************************************************************************/
+bool InstalledPackages::entryExists(const std::string & pkg) const
+{
+  struct stat sb;
+
+  return (stat((_path + "/" + pkg).c_str(), &sb) == 0);
+}
+
+/*******************************************************************************
+
+Re-reads the entry for a given package name. If expected_pkg is given (the
+package name the caller expects to be installed, e.g. after an upgrade), it is
+checked with a single stat. Otherwise, or if it is not there, only directory
+entries beginning with the name are parsed. Returns 1 if the directory cannot
+be read; 0 otherwise.
+
+*******************************************************************************/
+int InstalledPackages::update(const std::string & name,
+                              const std::string & expected_pkg)
+{
+  DIR *pdir;
+  struct dirent *pent;
+  installed_pkg entry;
+  std::string prefix;
+  bool found;
+
+  if ( (expected_pkg != "") && (entryExists(expected_pkg)) )
+  {
+    entry.pkg = expected_pkg;
+    if ( (get_pkg_info(entry.pkg, entry.name, entry.version, entry.arch,
+                       entry.build) == 0) && (entry.name == name) )
+    {
+      _table[name] = entry;
+      return 0;
+    }
+  }
+
+  pdir = opendir(_path.c_str());
+  if (pdir == NULL) { return 1; }
+
+  prefix = name + "-";
+  found = false;
+  while ((pent = readdir(pdir)))
+  {
+    if (std::strncmp(pent->d_name, prefix.c_str(), prefix.size()) != 0)
+      continue;
+    entry.pkg = pent->d_name;
+    if ( (get_pkg_info(entry.pkg, entry.name, entry.version, entry.arch,
+                       entry.build) == 0) && (entry.name == name) )
+    {
+      _table[name] = entry;
+      found = true;
+      break;
+    }
+  }
+  closedir(pdir);
+
+  if (! found) { _table.erase(name); }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Updates entry for a package name after it has been removed: the entry is
+dropped if it is no longer in the package directory. Only a single stat is
+needed.
+
+*******************************************************************************/
+void InstalledPackages::updateRemoved(const std::string & name)
+{
+  std::unordered_map<std::string, installed_pkg>::iterator it;
+
+  it = _table.find(name);
+  if (it == _table.end()) { return; }
+  if (! entryExists(it->second.pkg)) { _table.erase(it); }
+}
+
+/*******************************************************************************
+
+Finds installed package by name. Returns NULL if not installed.
+
+*******************************************************************************/
+const installed_pkg * InstalledPackages::find(const std::string & name) const
+{
+  std::unordered_map<std::string, installed_pkg>::const_iterator it;
+
+  it = _table.find(name);
+  if (it == _table.end()) { return NULL; }
+  else { return &it->second; }
+}
+
+/*******************************************************************************
+
+Returns list of all installed packages with valid names
+
+*******************************************************************************/
+std::vector<const installed_pkg *> InstalledPackages::list() const
+{
+  std::vector<const installed_pkg *> pkglist;
+  std::unordered_map<std::string, installed_pkg>::const_iterator it;
+
+  pkglist.reserve(_table.size());
+  for ( it = _table.begin(); it != _table.end(); it++ )
+  {
+    pkglist.push_back(&it->second);
+  }
+
+  return pkglist;
+}
+
+/*******************************************************************************
+
+Access to installed packages with badly formed names and number of packages
+
+*******************************************************************************/
+const std::vector<std::string> & InstalledPackages::invalid() const
+{
+  return _invalid;
+}
+
+unsigned int InstalledPackages::size() const { return _table.size(); }
@@ -21,7 +21,10 @@ void KeyHelpWindow::createList()
   addItem(new HelpItem("Activate menubar", "F9"));
   addItem(new HelpItem("Activate right/bottom list", "Right arrow"));
   addItem(new HelpItem("Filter", "f"));
+  addItem(new HelpItem("Previous filter", "b"));
+  addItem(new HelpItem("Fuzzy search (live)", "Ctrl-f"));
   addItem(new HelpItem("Show keyboard shortcuts", "?"));
+  addItem(new HelpItem("Live search by name", "Ctrl-n"));
   addItem(new HelpItem("Options", "o"));
   addItem(new HelpItem("Quick search in active list", "Ctrl-s"));
   addItem(new HelpItem("Quit", "q"));
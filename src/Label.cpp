@@ -3,6 +3,7 @@
 #include "Color.h"
 #include "settings.h"
 #include "signals.h"
+#include "CursesWidget.h"
 #include "InputItem.h"
 #include "Label.h"
 #include "MouseEvent.h"
@@ -116,7 +117,7 @@ void Label::draw(int y_offset, bool force, bool highlight)
   if ( (_bold) && (! colors.pairIsBold(_color_idx)) )
     wattroff(_win, A_BOLD);
 
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -140,7 +141,7 @@ std::string Label::exec(int y_offset, MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = CursesWidget::readKey()) {
 
     // Enter key: return Enter signal
 
@@ -215,7 +215,6 @@ screen or not.
 *******************************************************************************/
 void ListBox::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
   int color_pair1, color_pair2, len, i, hidx;
 
   // Go to item location, optionally highlight, and print item
@@ -228,16 +227,14 @@ void ListBox::redrawSingleItem(unsigned int idx)
   {
     if (_activated) 
     { 
-      fg = "fg_highlight_active"; 
-      bg = "bg_highlight_active"; 
+      color_pair1 = _highlight_active_pair;
+      color_pair2 = _hotkey_active_pair;
     }
     else
     {
-      fg = "fg_highlight_inactive"; 
-      bg = "bg_highlight_inactive"; 
+      color_pair1 = _highlight_inactive_pair;
+      color_pair2 = _hotkey_inactive_pair;
     }
-    color_pair1 = colors.getPair(fg, bg);
-    color_pair2 = colors.getPair("hotkey", bg);
     if (colors.turnOn(_win, color_pair1) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
@@ -245,8 +242,8 @@ void ListBox::redrawSingleItem(unsigned int idx)
   } 
   else
   {
-    color_pair1 = colors.getPair(_fg_color, _bg_color);
-    color_pair2 = colors.getPair("hotkey", _bg_color);
+    color_pair1 = _color_pair;
+    color_pair2 = _hotkey_pair;
   }
 
   // Save highlight idx for redrawing later.
@@ -384,6 +381,15 @@ ListBox::ListBox(WINDOW *win, const std::string & name)
 Edit list items
 
 *******************************************************************************/
+void ListBox::insertItem(unsigned int idx, ListItem *item)
+{
+  if (idx <= _items.size()) { _items.insert(_items.begin()+idx, item); }
+  _highlight = 0;
+  _firstprint = 0;
+  _prevhighlight = 0;
+  _redraw_type = "all";
+}
+
 void ListBox::removeItem(unsigned int idx)
 {
   if (idx <= _items.size()) { _items.erase(_items.begin()+idx); }
@@ -642,7 +648,7 @@ void ListBox::draw(bool force)
   if (_redraw_type == "all")
   { 
     clearWindow(); 
-    colors.setBackground(_win, _fg_color, _bg_color);
+    colors.setBackground(_win, _color_pair);
   }
   if (_redraw_type == "buttons") { redrawButtons(); }
   else if (_redraw_type != "none") 
@@ -653,7 +659,7 @@ void ListBox::draw(bool force)
   if ( (_redraw_type == "all") || (_redraw_type == "items")) { 
                                                             redrawAllItems(); }
   else if (_redraw_type == "changed") { redrawChangedItems(); }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -680,7 +686,7 @@ std::string ListBox::exec(MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = readKey()) {
 
     // Enter key: accept selection
 
@@ -51,6 +51,11 @@ int ListItem::findPropByName(const std::string & propname, int & propidx,
     return 0;
   }
 
+  // Neither bound matched and there is nothing between them
+
+  if (rbound - lbound <= 1)
+    return 1;
+
   // Cut the list in half and try again
 
   midbound = std::floor(double(lbound+rbound)/2.);
@@ -101,7 +106,7 @@ void ListItem::setPropByIdx(unsigned int idx, const std::string & value)
 
 /*******************************************************************************
 
-Constructors
+Constructors and destructor
 
 *******************************************************************************/
 ListItem::ListItem() 
@@ -118,6 +123,8 @@ ListItem::ListItem(const std::string & name)
   _hotkey = -1;
 }
 
+ListItem::~ListItem() {}
+
 /*******************************************************************************
 
 Set properties. Methods with return value return 0 for success or 1 for failure.
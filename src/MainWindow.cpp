@@ -17,6 +17,7 @@
 #include "filters.h"
 #include "FilterBox.h"
 #include "SearchBox.h"
+#include "ScriptSearch.h"
 #include "BuildActionBox.h"
 #include "BuildOptionsBox.h"
 #include "BuildOrderBox.h"
@@ -31,10 +32,19 @@
 #include "PackageInfoBox.h"
 #include "MainWindow.h"
 #include "MouseEvent.h"
+#include "FuzzyMatcher.h"
+#include "SearchSession.h"
+#include "BuildSet.h"
+#include "FilterCache.h"
+#include "CompositeFilterBox.h"
+
+const unsigned int MainWindow::_fuzzy_results = 100;
+const unsigned int MainWindow::_max_filter_history = 32;
 
 /*******************************************************************************
 
-Prints/clears status message
+Prints/clears status message. Printing writes pending updates to the terminal
+right away, since the message often announces a long operation.
 
 *******************************************************************************/
 void MainWindow::printStatus(const std::string & msg, bool bold)
@@ -59,7 +69,7 @@ void MainWindow::clearStatus()
   move(rows-2, 0);
   clrtoeol();
   _status = "";
-  refresh();
+  wnoutrefresh(stdscr);
 }
 
 void MainWindow::refreshStatus() { printStatus(_status); }
@@ -98,7 +108,7 @@ void MainWindow::redrawHeaderFooter()
   printToEol(_info, cols-(left-1));
   colors.turnOff(stdscr);
 
-  refresh();
+  wnoutrefresh(stdscr);
 }
 
 /*******************************************************************************
@@ -183,7 +193,7 @@ void MainWindow::redrawWindows(bool force)
   // Redraw windows
 
   _clistbox.draw(force);
-  _blistboxes[_category_idx].draw(force);
+  currentBuildList().draw(force);
 }
 
 /*******************************************************************************
@@ -208,7 +218,7 @@ void MainWindow::clearData()
 {
   if (_win1) { delwin(_win1); }
   if (_win2) { delwin(_win2); }
-  _blistboxes.resize(0);
+  _buildview.clear();
   _slackbuilds.resize(0);
   _displayed_slackbuilds.resize(0);
   _categories.resize(0);
@@ -220,6 +230,49 @@ void MainWindow::clearData()
 
 /*******************************************************************************
 
+Saves names of tagged SlackBuilds, so that tags can be restored after the lists
+are read again
+
+*******************************************************************************/
+void MainWindow::saveTags()
+{
+  unsigned int i, j, ncategories, nbuilds;
+
+  _saved_tags.resize(0);
+  ncategories = _slackbuilds.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = _slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      if (_slackbuilds[i][j].getBoolProp("tagged"))
+        _saved_tags.push_back(_slackbuilds[i][j].name());
+    }
+  }
+}
+
+/*******************************************************************************
+
+Tags SlackBuilds saved by saveTags that are still in the repository
+
+*******************************************************************************/
+void MainWindow::restoreTags()
+{
+  unsigned int k, ntags;
+  int i, j;
+
+  ntags = _saved_tags.size();
+  for ( k = 0; k < ntags; k++ )
+  {
+    if (find_slackbuild(_saved_tags[k], _slackbuilds, i, j) != 0) { continue; }
+    _slackbuilds[i][j].setBoolProp("tagged", true);
+    _taglist.addItem(&_slackbuilds[i][j]);
+  }
+  _saved_tags.resize(0);
+}
+
+/*******************************************************************************
+
 Creates master list of SlackBuilds
 
 *******************************************************************************/
@@ -259,6 +312,13 @@ int MainWindow::readLists(MouseEvent * mevent, bool interactive)
   if (settings::save_buildopts)
     read_buildopts(_slackbuilds);
 
+  // Number SlackBuilds for filtering by sets
+
+  _filter_cache.setBuilds(_slackbuilds);
+  _displayed_set.reset(_filter_cache.numBuilds(), true);
+  _prev_filters.resize(0);
+  _prev_sets.resize(0);
+
   // Warning for invalid package names
 
   npkgerr = pkg_errors.size();
@@ -329,47 +389,64 @@ Rebuilds lists after applying changes
 *******************************************************************************/
 void MainWindow::rebuild(MouseEvent * mevent)
 {
-  unsigned int list_highlight, prev_activated;
-  std::vector<std::string> pkg_errors, missing_info;
-  std::string errmsg, category;
+  clearTags();
+  refreshLists(mevent);
+}
 
-  // Clear tags
+/*******************************************************************************
 
-  clearTags();
+Updates displayed lists after SlackBuilds in _changed_builds have changed,
+keeping the highlighted SlackBuild if possible
+
+*******************************************************************************/
+void MainWindow::refreshLists(MouseEvent * mevent)
+{
+  unsigned int list_highlight, prev_activated;
+  std::string category;
 
   // Save original highlight info
 
   category = _clistbox.highlightedName();
-  list_highlight = _blistboxes[_category_idx].highlight();
+  list_highlight = currentBuildList().highlight();
   prev_activated = _activated_listbox;
 
-  // Re-filter (data, tags could have changed), unless filtered by search
+  // Patch lists holding changed SlackBuilds if possible. Otherwise, re-filter
+  // (data, tags could have changed), unless filtered by search
 
-  if (_filter == "all SlackBuilds") { filterAll(mevent); }
-  else if (_filter == "installed SlackBuilds") { filterInstalled(); }
-  else if (_filter == "upgradable SlackBuilds") { filterUpgradable(); } 
-  else if (_filter == "tagged SlackBuilds") { filterTagged(); } 
-  else if (_filter == "blacklisted SlackBuilds") { filterBlacklisted(); }
-  else if (_filter == "non-dependencies") { filterNonDeps(); } 
-  else if (_filter == "SlackBuilds with build options set")
-    filterBuildOptions();
+  _filter_cache.invalidate();
+  if (patchLists() != 0)
+  {
+    if (_filter == "all SlackBuilds") { filterAll(mevent); }
+    else if (_filter == "installed SlackBuilds") { filterInstalled(); }
+    else if (_filter == "upgradable SlackBuilds") { filterUpgradable(); } 
+    else if (_filter == "tagged SlackBuilds") { filterTagged(); } 
+    else if (_filter == "blacklisted SlackBuilds") { filterBlacklisted(); }
+    else if (_filter == "non-dependencies") { filterNonDeps(); } 
+    else if (_filter == "SlackBuilds with build options set")
+      filterBuildOptions();
+    else if (_filter.substr(0, 21) == "SlackBuilds matching ")
+      filterComposite();
+  }
+  else
+    list_build_set(_buildview, _filter_cache.numBuilds(), _displayed_set);
+  _changed_builds.resize(0);
 
   // Reset original highlight if possible
 
   if (_clistbox.setHighlight(category) == 0)
   {
     _category_idx = _clistbox.highlight();
-    _blistboxes[_category_idx].setHighlight(list_highlight);
+    currentBuildList().setHighlight(list_highlight);
     if (prev_activated == 0)
     {
       _clistbox.setActivated(true);
-      _blistboxes[_category_idx].setActivated(false);
+      currentBuildList().setActivated(false);
       _activated_listbox = 0;
     }
     else
     {
       _clistbox.setActivated(false);
-      _blistboxes[_category_idx].setActivated(true);
+      currentBuildList().setActivated(true);
       _activated_listbox = 1;
     }
   }
@@ -379,6 +456,91 @@ void MainWindow::rebuild(MouseEvent * mevent)
 
 /*******************************************************************************
 
+Patches displayed lists after SlackBuilds were installed, upgraded, reinstalled
+or removed, instead of re-filtering everything. Only the list boxes holding the
+changed SlackBuilds are touched. Returns 0 on success, or 1 if the lists need
+to be re-filtered instead (e.g., a category must be added or removed, or the
+filter does not depend only on the SlackBuild itself).
+
+*******************************************************************************/
+int MainWindow::patchLists()
+{
+  bool (*func)(const BuildListItem &);
+  unsigned int i, j, k, nchanged, ncategories, nitems, itemidx;
+  int idx, lbound, rbound;
+  BuildListItem *build;
+  bool show, present;
+
+  if (_filter == "all SlackBuilds") { func = &any_build; }
+  else if (_filter == "installed SlackBuilds") { func = &build_is_installed; }
+  else if (_filter == "upgradable SlackBuilds") { func = &build_is_upgradable; }
+  else if (_filter == "blacklisted SlackBuilds")
+    func = &build_is_blacklisted;
+  else if (_filter == "SlackBuilds with build options set")
+    func = &build_has_buildoptions;
+  else if (_filter.substr(0, 11) == "search for ") { return 0; }
+  else { return 1; }
+
+  nchanged = _changed_builds.size();
+  for ( i = 0; i < nchanged; i++ )
+  {
+    build = _changed_builds[i];
+
+    // Skip if it is not in the list being filtered
+
+    ncategories = _displayed_categories.size();
+    for ( j = 0; j < ncategories; j++ )
+    {
+      if (_displayed_categories[j]->name() == build->category()) { break; }
+    }
+    if (j == ncategories) { continue; }
+    nitems = _displayed_slackbuilds[j].size();
+    if (nitems == 0) { continue; }
+    lbound = 0;
+    rbound = nitems-1;
+    if (find_name_in_list(build->name(), _displayed_slackbuilds[j], idx,
+                          lbound, rbound) != 0)
+      continue;
+
+    // Find list box for its category
+
+    show = func(*build);
+    ncategories = _clistbox.numItems();
+    for ( k = 0; k < ncategories; k++ )
+    {
+      if (_clistbox.itemByIdx(k)->name() == build->category()) { break; }
+    }
+    if (k == ncategories)
+    {
+      if (show) { return 1; }
+      else { continue; }
+    }
+
+    // Find SlackBuild in list box or where it belongs, and add or remove it
+
+    nitems = _buildview.numBuilds(k);
+    for ( itemidx = 0; itemidx < nitems; itemidx++ )
+    {
+      if (_buildview.build(k, itemidx)->name() >= build->name()) { break; }
+    }
+    present = ( (itemidx < nitems) &&
+                (_buildview.build(k, itemidx) == build) );
+    if ( (present) && (! show) )
+    {
+      if (nitems == 1) { return 1; }
+      _buildview.removeBuild(k, itemidx);
+      if (settings::cumulative_filters)
+        _displayed_slackbuilds[j].erase(_displayed_slackbuilds[j].begin()+idx);
+    }
+    else if ( (! present) && (show) )
+      _buildview.insertBuild(k, itemidx, build);
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
 Resets displayed slackbuilds and categories lists
 
 *******************************************************************************/
@@ -405,6 +567,43 @@ void MainWindow::resetDisplayedSlackBuilds()
 
 /*******************************************************************************
 
+Returns the list box showing the selected category of the list view. It is
+only reloaded when the category or the view has changed. When the view has
+changed, the list box starts out deactivated, like a newly filtered list.
+
+*******************************************************************************/
+BuildListBox & MainWindow::currentBuildList()
+{
+  if (_shown_revision != _buildview.revision())
+  {
+    _blistbox.setView(_buildview, _category_idx);
+    _blistbox.setActivated(false);
+  }
+  else if (_shown_category != _category_idx)
+  {
+    saveListHighlight();
+    _blistbox.setView(_buildview, _category_idx);
+  }
+  _shown_category = _category_idx;
+  _shown_revision = _buildview.revision();
+
+  return _blistbox;
+}
+
+/*******************************************************************************
+
+Saves the highlight of the list box in the list view, so it is restored when
+the category is selected again
+
+*******************************************************************************/
+void MainWindow::saveListHighlight()
+{
+  if (_shown_revision == _buildview.revision())
+    _buildview.setHighlight(_shown_category, _blistbox.highlight());
+}
+
+/*******************************************************************************
+
 Exit sboui
 
 *******************************************************************************/
@@ -416,6 +615,55 @@ void MainWindow::quit()
 
 /*******************************************************************************
 
+Sets the filter name, saving the previous filter and the SlackBuilds it showed
+so that it can be restored
+
+*******************************************************************************/
+void MainWindow::setFilter(const std::string & filter)
+{
+  if (filter != _filter)
+  {
+    _prev_filters.push_back(_filter);
+    _prev_sets.push_back(_displayed_set);
+    if (_prev_filters.size() > _max_filter_history)
+    {
+      _prev_filters.erase(_prev_filters.begin());
+      _prev_sets.erase(_prev_sets.begin());
+    }
+  }
+  _filter = filter;
+}
+
+/*******************************************************************************
+
+Shows SlackBuilds in a filter from the cache. With cumulative filters, it is
+combined with the SlackBuilds currently displayed. Returns number shown.
+
+*******************************************************************************/
+unsigned int MainWindow::filterBySet(const std::string & filter)
+{
+  BuildSet set;
+
+  _filter_cache.get(filter, set);
+
+  return showBuildSet(set);
+}
+
+unsigned int MainWindow::showBuildSet(const BuildSet & set)
+{
+  unsigned int nfiltered;
+
+  if (settings::cumulative_filters) { _displayed_set &= set; }
+  else { _displayed_set = set; }
+  filter_by_set(_slackbuilds, _categories, _displayed_set,
+                _displayed_slackbuilds, _displayed_categories, _clistbox,
+                _buildview, nfiltered, settings::cumulative_filters);
+
+  return nfiltered;
+}
+
+/*******************************************************************************
+
 Displays all SlackBuilds
 
 *******************************************************************************/
@@ -423,18 +671,16 @@ void MainWindow::filterAll(MouseEvent * mevent)
 {
   unsigned int nbuilds;
   std::string choice;
-  bool (*func)(const BuildListItem &);
 
-  _filter = "all SlackBuilds";
+  setFilter("all SlackBuilds");
   printStatus("Filtering by all SlackBuilds ...");
 
   _activated_listbox = 0;
   _category_idx = 0;
 
   resetDisplayedSlackBuilds();
-  func = &any_build;
-  filter_by_func(_displayed_slackbuilds, func, _displayed_categories, _win2,
-                 _clistbox, _blistboxes, nbuilds, settings::cumulative_filters);
+  _displayed_set.reset(_filter_cache.numBuilds(), true);
+  nbuilds = filterBySet("All");
 
   if (nbuilds == 0)
   {
@@ -447,8 +693,6 @@ void MainWindow::filterAll(MouseEvent * mevent)
     printStatus("1 SlackBuild in repository.");
   else 
     printStatus(int_to_string(nbuilds) + " SlackBuilds in repository.");
-
-  setTagList();
 }
 
 /*******************************************************************************
@@ -460,18 +704,15 @@ void MainWindow::filterInstalled()
 {
   unsigned int ninstalled;
   std::vector<std::string> pkg_errors, missing_info;
-  bool (*func)(const BuildListItem &);
   std::string msg;
 
-  _filter = "installed SlackBuilds";
+  setFilter("installed SlackBuilds");
   printStatus("Filtering by installed SlackBuilds ...");
 
   _activated_listbox = 0;
   _category_idx = 0;
 
-  func = &build_is_installed;
-  filter_by_func(_displayed_slackbuilds, func, _displayed_categories, _win2,
-                 _clistbox, _blistboxes, ninstalled, settings::cumulative_filters);
+  ninstalled = filterBySet("Installed");
 
   if (ninstalled == 0) 
     msg = "No installed SlackBuilds";
@@ -484,8 +725,6 @@ void MainWindow::filterInstalled()
   else
     msg += ".";
   printStatus(msg);
-
-  setTagList();
 }
 
 /*******************************************************************************
@@ -497,19 +736,16 @@ void MainWindow::filterUpgradable()
 {
   unsigned int nupgradable;
   std::vector<std::string> pkg_errors, missing_info;
-  bool (*func)(const BuildListItem &);
   std::string msg;
 
-  _filter = "upgradable SlackBuilds";
+  setFilter("upgradable SlackBuilds");
   printStatus("Filtering by upgradable SlackBuilds ...");
 
   _category_idx = 0;
   _activated_listbox = 0;
   nupgradable = 0;
 
-  func = &build_is_upgradable;
-  filter_by_func(_displayed_slackbuilds, func, _displayed_categories, _win2,
-                 _clistbox, _blistboxes, nupgradable, settings::cumulative_filters);
+  nupgradable = filterBySet("Upgradable");
 
   if (nupgradable == 0) 
     msg = "No upgradable SlackBuilds";
@@ -522,8 +758,6 @@ void MainWindow::filterUpgradable()
   else
     msg += ".";
   printStatus(msg);
-
-  setTagList();
 }
 
 /*******************************************************************************
@@ -534,19 +768,19 @@ Displays tagged SlackBuilds
 void MainWindow::filterTagged()
 {
   unsigned int ntagged;
-  bool (*func)(const BuildListItem &);
   std::string msg;
 
-  _filter = "tagged SlackBuilds";
+  setFilter("tagged SlackBuilds");
   printStatus("Filtering by tagged SlackBuilds ...");
 
   _category_idx = 0;
   _activated_listbox = 0;
   ntagged = 0;
 
-  func = &build_is_tagged;
-  filter_by_func(_displayed_slackbuilds, func, _displayed_categories, _win2,
-                 _clistbox, _blistboxes, ntagged, settings::cumulative_filters);
+  // Tags could have changed, so evaluate again
+
+  _filter_cache.invalidate("Tagged");
+  ntagged = filterBySet("Tagged");
 
   if (ntagged == 0) 
     msg = "No tagged SlackBuilds";
@@ -559,8 +793,6 @@ void MainWindow::filterTagged()
   else
     msg += ".";
   printStatus(msg);
-
-  setTagList();
 }
 
 /*******************************************************************************
@@ -571,19 +803,16 @@ Displays blacklisted SlackBuilds
 void MainWindow::filterBlacklisted()
 {
   unsigned int nblacklisted;
-  bool (*func)(const BuildListItem &);
   std::string msg;
 
-  _filter = "blacklisted SlackBuilds";
+  setFilter("blacklisted SlackBuilds");
   printStatus("Filtering by blacklisted SlackBuilds ...");
 
   _category_idx = 0;
   _activated_listbox = 0;
   nblacklisted = 0;
 
-  func = &build_is_blacklisted;
-  filter_by_func(_displayed_slackbuilds, func, _displayed_categories, _win2,
-                 _clistbox, _blistboxes, nblacklisted, settings::cumulative_filters);
+  nblacklisted = filterBySet("Blacklisted");
 
   if (nblacklisted == 0) 
     msg = "No blacklisted SlackBuilds";
@@ -596,8 +825,6 @@ void MainWindow::filterBlacklisted()
   else
     msg += ".";
   printStatus(msg);
-
-  setTagList();
 }
 
 /*******************************************************************************
@@ -612,15 +839,14 @@ void MainWindow::filterNonDeps()
   std::vector<std::string> pkg_errors, missing_info;
   std::string msg;
 
-  _filter = "non-dependencies";
+  setFilter("non-dependencies");
   printStatus("Filtering by non-dependencies ...");
 
   _category_idx = 0;
   _activated_listbox = 0;
   nnondeps = 0;
 
-  filter_nondeps(_slackbuilds, _displayed_slackbuilds, _displayed_categories,
-                 _win2, _clistbox, _blistboxes, nnondeps, settings::cumulative_filters);
+  nnondeps = filterBySet("Non-dependencies");
 
   if (nnondeps == 0) 
     msg = "No non-dependencies";
@@ -633,8 +859,6 @@ void MainWindow::filterNonDeps()
   else
     msg += ".";
   printStatus(msg);
-
-  setTagList();
 }
 
 /*******************************************************************************
@@ -645,19 +869,19 @@ Displays SlackBuilds with build options set
 void MainWindow::filterBuildOptions()
 {
   unsigned int nbuildsopts;
-  bool (*func)(const BuildListItem &);
   std::string msg;
 
-  _filter = "SlackBuilds with build options set";
+  setFilter("SlackBuilds with build options set");
   printStatus("Filtering by SlackBuilds with build options set ...");
 
   _category_idx = 0;
   _activated_listbox = 0;
   nbuildsopts = 0;
 
-  func = &build_has_buildoptions;
-  filter_by_func(_displayed_slackbuilds, func, _displayed_categories, _win2,
-                 _clistbox, _blistboxes, nbuildsopts, settings::cumulative_filters);
+  // Build options could have changed, so evaluate again
+
+  _filter_cache.invalidate("Build options set");
+  nbuildsopts = filterBySet("Build options set");
 
   if (nbuildsopts == 0) 
     msg = "No SlackBuilds with build options set";
@@ -670,8 +894,83 @@ void MainWindow::filterBuildOptions()
   else
     msg += ".";
   printStatus(msg);
+}
+
+/*******************************************************************************
+
+Displays SlackBuilds matching the filters combined in the composite filter
+dialog
+
+*******************************************************************************/
+void MainWindow::filterComposite()
+{
+  unsigned int nmatches;
+  std::vector<std::string> include, exclude;
+  BuildSet set;
+  std::string desc, msg;
+
+  desc = _compositebox.description();
+  setFilter("SlackBuilds matching " + desc);
+  printStatus("Filtering by " + desc + " ...");
+
+  _category_idx = 0;
+  _activated_listbox = 0;
+
+  // Tags and build options could have changed, so evaluate them again
+
+  _filter_cache.invalidate("Tagged");
+  _filter_cache.invalidate("Build options set");
+  _compositebox.filters(include, exclude);
+  _filter_cache.combine(include, exclude, _compositebox.matchAll(), set);
+  nmatches = showBuildSet(set);
+
+  if (nmatches == 0) 
+    msg = "No SlackBuilds match " + desc;
+  else if (nmatches == 1) 
+    msg = "1 SlackBuild matches " + desc;
+  else 
+    msg = int_to_string(nmatches) + " SlackBuilds match " + desc;
+  if (settings::cumulative_filters)
+    msg += " in current list.";
+  else
+    msg += ".";
+  printStatus(msg);
+}
+
+/*******************************************************************************
+
+Goes back to the previous filter
+
+*******************************************************************************/
+void MainWindow::previousFilter()
+{
+  unsigned int nfiltered;
+
+  if (_prev_filters.size() == 0)
+  {
+    printStatus("No previous filter.");
+    return;
+  }
+
+  _filter = _prev_filters.back();
+  _displayed_set = _prev_sets.back();
+  _prev_filters.pop_back();
+  _prev_sets.pop_back();
+
+  _category_idx = 0;
+  _activated_listbox = 0;
+
+  filter_by_set(_slackbuilds, _categories, _displayed_set,
+                _displayed_slackbuilds, _displayed_categories, _clistbox,
+                _buildview, nfiltered, settings::cumulative_filters);
 
-  setTagList();
+  if (nfiltered == 1)
+    printStatus("Showing " + _filter + " (1 SlackBuild).");
+  else
+    printStatus("Showing " + _filter + " (" + int_to_string(nfiltered)
+                + " SlackBuilds).");
+
+  draw(true);
 }
 
 /*******************************************************************************
@@ -681,13 +980,17 @@ Filters SlackBuilds by search term
 *******************************************************************************/
 void MainWindow::filterSearch(const std::string & searchterm, 
                               bool case_sensitive, bool whole_word,
-                              bool search_readmes)
+                              bool search_readmes, bool search_scripts,
+                              bool use_regex)
 {
   unsigned int nsearch;
   std::string msg;
+  BuildListItem *best_match;
 
-  _filter = "search for " + searchterm;
-  if (search_readmes)
+  setFilter("search for " + searchterm);
+  if (search_scripts)
+    printStatus("Searching for " + searchterm + " in SlackBuild files ...");
+  else if (search_readmes)
     printStatus("Searching for " + searchterm + " in name and README ...");
   else
     printStatus("Searching for " + searchterm + " ...");
@@ -696,9 +999,20 @@ void MainWindow::filterSearch(const std::string & searchterm,
   _category_idx = 0;
   nsearch = 0;
 
-  filter_search(_displayed_slackbuilds, _displayed_categories, _win2, _clistbox,
-                _blistboxes, nsearch, searchterm, case_sensitive, whole_word,
-                search_readmes, settings::cumulative_filters);
+  filter_search(_displayed_slackbuilds, _displayed_categories, _clistbox,
+                _buildview, nsearch, searchterm, case_sensitive, whole_word,
+                search_readmes, search_scripts, use_regex,
+                settings::cumulative_filters, &best_match);
+  list_build_set(_buildview, _filter_cache.numBuilds(), _displayed_set);
+
+  // Highlight best match, which is shown first
+
+  if ( (best_match) &&
+       (_clistbox.setHighlight(best_match->getProp("category")) == 0) )
+  {
+    _category_idx = _clistbox.highlight();
+    currentBuildList().setHighlight(best_match->name());
+  }
 
   if (nsearch == 0) 
     msg = "No matches for " + searchterm;
@@ -711,8 +1025,47 @@ void MainWindow::filterSearch(const std::string & searchterm,
   else
     msg += " in repository.";
   printStatus(msg);
+}
+
+/*******************************************************************************
+
+Filters SlackBuilds by fuzzy name match, keeping the best matches
 
-  setTagList();
+*******************************************************************************/
+void MainWindow::filterFuzzy(const std::string & query)
+{
+  unsigned int nmatches;
+  std::string msg;
+  FuzzyMatcher matcher;
+  BuildListItem *best_match;
+
+  setFilter("fuzzy search for " + query);
+  _activated_listbox = 0;
+  _category_idx = 0;
+
+  matcher.setItems(_displayed_slackbuilds);
+  filter_fuzzy(_displayed_slackbuilds, _displayed_categories,
+               _clistbox, _buildview, nmatches, matcher, query,
+               _fuzzy_results, settings::cumulative_filters, &best_match);
+  list_build_set(_buildview, _filter_cache.numBuilds(), _displayed_set);
+
+  if ( (best_match) &&
+       (_clistbox.setHighlight(best_match->getProp("category")) == 0) )
+  {
+    _category_idx = _clistbox.highlight();
+    currentBuildList().setHighlight(best_match->name());
+  }
+
+  if (nmatches == 0) 
+    msg = "No matches for " + query + ".";
+  else if (nmatches == 1) 
+    msg = "1 match for " + query + ".";
+  else if (nmatches > _fuzzy_results)
+    msg = int_to_string(nmatches) + " matches for " + query + " (showing best "
+        + int_to_string(_fuzzy_results) + ").";
+  else 
+    msg = int_to_string(nmatches) + " matches for " + query + ".";
+  printStatus(msg);
 }
 
 /*******************************************************************************
@@ -727,8 +1080,8 @@ int MainWindow::showOptions(MouseEvent * mevent)
   bool getting_input;
   int check_color, check_write;
 
-  clear();
-  refresh();
+  erase();
+  wnoutrefresh(stdscr);
 
   optionswin = newwin(1, 1, 0, 0);
   _options.setWindow(optionswin);
@@ -745,8 +1098,8 @@ int MainWindow::showOptions(MouseEvent * mevent)
     if (selection == signals::quit) { getting_input = false; }
     else if (selection == signals::resize) 
     { 
-      clear();
-      refresh();
+      erase();
+      wnoutrefresh(stdscr);
       _options.placeWindow();
     }
     else if (selection == "q") { return 1; }
@@ -754,6 +1107,7 @@ int MainWindow::showOptions(MouseEvent * mevent)
     {
       getting_input = false;
       _options.applySettings(check_color, check_write, _conf_file);
+      startWatcher();
     }
   }
 
@@ -821,8 +1175,8 @@ int MainWindow::showHelp(MouseEvent * mevent, bool mouse_help)
   bool getting_input;
   HelpWindow *help;
 
-  clear();
-  refresh();
+  erase();
+  wnoutrefresh(stdscr);
 
   helpwin = newwin(1, 1, 0, 0);
   if (mouse_help)
@@ -842,8 +1196,8 @@ int MainWindow::showHelp(MouseEvent * mevent, bool mouse_help)
       getting_input = false;
     else if (selection == signals::resize) 
     { 
-      clear();
-      refresh();
+      erase();
+      wnoutrefresh(stdscr);
       help->placeWindow();
     }
     else if (selection == "q") { return 1; }
@@ -865,19 +1219,6 @@ int MainWindow::showHelp(MouseEvent * mevent, bool mouse_help)
 
 /*******************************************************************************
 
-Sets taglist reference in BuildListBoxes
-
-*******************************************************************************/
-void MainWindow::setTagList()
-{
-  unsigned int nblistboxes, i;
-
-  nblistboxes = _blistboxes.size();
-  for ( i = 0; i < nblistboxes; i++ ) { _blistboxes[i].setTagList(&_taglist); }
-}
-
-/*******************************************************************************
-
 Installs/upgrades/reinstalls/removes SlackBuild and dependencies. Returns true
 if anything was changed, false otherwise.
 
@@ -1039,6 +1380,10 @@ bool MainWindow::modifyPackage(BuildListItem & build,
     nchanged_orig = ninstalled + nupgraded + nreinstalled + nremoved;
     check = installer.applyChanges(ninstalled, nupgraded, nreinstalled,
                                    nremoved);
+    _watcher.discard();
+    _changed_builds.insert(_changed_builds.end(),
+                           installer.changedBuilds().begin(),
+                           installer.changedBuilds().end());
     nchanged_new = ninstalled + nupgraded + nreinstalled + nremoved;
     if (nchanged_new > nchanged_orig) { needs_rebuild = true; }
     reset_prog_mode();
@@ -1091,6 +1436,7 @@ void MainWindow::setBuildOptions(BuildListItem & build, MouseEvent * mevent)
       if (settings::save_buildopts)
       {
         check = buildoptions.write(build);
+        _watcher.discard();
         if (check != 0)
         {
           msg = "Unable to save build options: "
@@ -1368,6 +1714,81 @@ int MainWindow::syncRepo(MouseEvent * mevent)
 
 /*******************************************************************************
 
+Starts or stops watching for changes made outside of sboui, depending on the
+watch_changes setting
+
+*******************************************************************************/
+void MainWindow::startWatcher()
+{
+  std::vector<std::string> categories;
+  unsigned int i, ncategories;
+
+  if (! settings::watch_changes)
+  {
+    _watcher.stop();
+    return;
+  }
+
+  ncategories = _categories.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    categories.push_back(_categories[i].name());
+  }
+  _watcher.start(settings::repo_dir, categories);
+}
+
+/*******************************************************************************
+
+Applies changes made outside of sboui once they have settled. Installed
+packages and build options are updated for the affected SlackBuilds only, while
+the repository is read again if it changed (as after a sync), keeping tags.
+
+*******************************************************************************/
+void MainWindow::applyExternalChanges(MouseEvent * mevent)
+{
+  watched_changes changes;
+  unsigned int k, nchanges;
+  int i, j;
+
+  if (_watcher.poll(changes) == 0) { return; }
+
+  if (changes.repo)
+  {
+    saveTags();
+    clearData();
+    initialize(mevent);
+    return;
+  }
+
+  nchanges = changes.packages.size();
+  for ( k = 0; k < nchanges; k++ )
+  {
+    installed_packages.update(changes.packages[k]);
+    if (find_slackbuild(changes.packages[k], _slackbuilds, i, j) != 0)
+      continue;
+    BuildListItem & build = _slackbuilds[i][j];
+    build.readInstalledProps(installed_packages);
+    if (build.installed()) { build.readPropsFromRepo(true); }
+    _changed_builds.push_back(&build);
+  }
+
+  if (settings::save_buildopts)
+  {
+    nchanges = changes.buildopts.size();
+    for ( k = 0; k < nchanges; k++ )
+    {
+      if (find_slackbuild(changes.buildopts[k], _slackbuilds, i, j) != 0)
+        continue;
+      update_buildopts(_slackbuilds[i][j]);
+      _changed_builds.push_back(&_slackbuilds[i][j]);
+    }
+  }
+
+  if (_changed_builds.size() > 0) { refreshLists(mevent); }
+}
+
+/*******************************************************************************
+
 Applies action to tagged SlackBuilds
 
 *******************************************************************************/
@@ -1463,7 +1884,7 @@ void MainWindow::applyTags(const std::string & action, MouseEvent * mevent)
         ncategories = _clistbox.numItems();
         for ( j = 0; j < ncategories; j++ )
         {
-          if (_blistboxes[j].allTagged())
+          if (_buildview.allTagged(j))
             _clistbox.itemByIdx(j)->setBoolProp("tagged", true);
           else { _clistbox.itemByIdx(j)->setBoolProp("tagged", false); }
         }
@@ -1714,8 +2135,8 @@ User interaction with menubar
 *******************************************************************************/
 void MainWindow::activateMenubar()
 {
-  _blistboxes[_category_idx].setActivated(false);
-  _blistboxes[_category_idx].draw();
+  currentBuildList().setActivated(false);
+  currentBuildList().draw();
   _clistbox.setActivated(false);
   _clistbox.draw();
   _menubar.setActivated(true);
@@ -1731,8 +2152,8 @@ void MainWindow::deactivateMenubar()
   }
   else
   {
-    _blistboxes[_category_idx].setActivated(true);
-    _blistboxes[_category_idx].draw();
+    currentBuildList().setActivated(true);
+    currentBuildList().draw();
   }
   _menubar.setActivated(false);
   redrawHeaderFooter();
@@ -1799,6 +2220,8 @@ void MainWindow::menubarActions(MouseEvent * mevent)
 
       filterBuildOptions();
     }
+    else if (entry == "Combine filters...") { combineFilters(mevent); }
+    else if (entry == "Previous filter") { previousFilter(); }
     redrawWindows(true);
   }
   else if (list == "Tagged")
@@ -1843,7 +2266,7 @@ void MainWindow::printSelectedPackageVersion()
   // be referenced.
 
   build = static_cast<BuildListItem *>(
-                            _blistboxes[_category_idx].highlightedItem());
+                            currentBuildList().highlightedItem());
   printPackageVersion(*build);
 }
 
@@ -1851,8 +2274,8 @@ void MainWindow::activateListBox(unsigned int list)
 {
   if (list == 0)
   {
-    _blistboxes[_category_idx].setActivated(false);
-    _blistboxes[_category_idx].draw();
+    currentBuildList().setActivated(false);
+    currentBuildList().draw();
     _clistbox.setActivated(true);
     _activated_listbox = 0;
     clearStatus();
@@ -1861,7 +2284,7 @@ void MainWindow::activateListBox(unsigned int list)
   {
     _clistbox.setActivated(false);
     _clistbox.draw();
-    _blistboxes[_category_idx].setActivated(true);
+    currentBuildList().setActivated(true);
     _activated_listbox = 1;
     printSelectedPackageVersion();
   }
@@ -1870,7 +2293,7 @@ void MainWindow::activateListBox(unsigned int list)
 void MainWindow::drawSelectedCategory()
 {
   _category_idx = _clistbox.highlight();
-  _blistboxes[_category_idx].draw(true);
+  currentBuildList().draw(true);
 }
 
 void MainWindow::tagSelectedCategory()
@@ -1878,16 +2301,16 @@ void MainWindow::tagSelectedCategory()
   _category_idx = _clistbox.highlight();
   _clistbox.tagHighlightedCategory();
   _clistbox.draw();
-  _blistboxes[_category_idx].tagAll();
-  _blistboxes[_category_idx].draw(true);
+  currentBuildList().tagAll();
+  currentBuildList().draw(true);
 }
 
 void MainWindow::tagSelectedSlackBuild()
 {
   bool all_tagged;
 
-  _blistboxes[_category_idx].tagHighlightedSlackBuild();
-  all_tagged = _blistboxes[_category_idx].allTagged();
+  currentBuildList().tagHighlightedSlackBuild();
+  all_tagged = currentBuildList().allTagged();
   if (_clistbox.highlightedItem()->getBoolProp("tagged"))
   {
     if (! all_tagged) 
@@ -1913,7 +2336,7 @@ void MainWindow::showSelectedBuildActions(bool limited_actions,
   BuildListItem *build;
 
   build = static_cast<BuildListItem *>(
-                            _blistboxes[_category_idx].highlightedItem());
+                            currentBuildList().highlightedItem());
   showBuildActions(*build, limited_actions, mevent);
 
   // Determine if categories should be tagged and redraw
@@ -1921,7 +2344,7 @@ void MainWindow::showSelectedBuildActions(bool limited_actions,
   ncategories = _clistbox.numItems();
   for ( i = 0; i < ncategories; i++ )
   {
-    if (_blistboxes[i].allTagged())
+    if (_buildview.allTagged(i))
       _clistbox.itemByIdx(i)->setBoolProp("tagged", true);
     else { _clistbox.itemByIdx(i)->setBoolProp("tagged", false); }
   }
@@ -1937,7 +2360,7 @@ MainWindow::MainWindow(const std::string & version)
 {
   _win1 = NULL;
   _win2 = NULL;
-  _blistboxes.resize(0);
+  _blistbox.setTagList(&_taglist);
   _slackbuilds.resize(0);
   _displayed_slackbuilds.resize(0);
   _categories.resize(0);
@@ -1948,6 +2371,8 @@ MainWindow::MainWindow(const std::string & version)
   _conf_file = "";
   _category_idx = 0;
   _activated_listbox = 0;
+  _shown_category = 0;
+  _shown_revision = 0;
   setWindow(stdscr);
 
   // Set up menubar
@@ -1974,6 +2399,8 @@ MainWindow::MainWindow(const std::string & version)
   _menubar.addListItem("Filter", "Blacklisted", "", 0);
   _menubar.addListItem("Filter", "Non-dependencies", "", 0);
   _menubar.addListItem("Filter", "Build options set", "", 3);
+  _menubar.addListItem("Filter", "Combine filters...", "", 0);
+  _menubar.addListItem("Filter", "Previous filter", "b", 0);
 
   _menubar.addList("Tagged", 2);
   _menubar.addListItem("Tagged", "Install", "i", 0);
@@ -1997,7 +2424,6 @@ First time window setup
 *******************************************************************************/
 int MainWindow::initialize(MouseEvent * mevent)
 {
-  BuildListBox initlistbox;
   int retval;
   std::string msg;
 
@@ -2010,10 +2436,7 @@ int MainWindow::initialize(MouseEvent * mevent)
   _clistbox.setWindow(_win1);
   _clistbox.setActivated(true);
   _clistbox.setName("Groups");
-  initlistbox.setWindow(_win2);
-  initlistbox.setActivated(false);
-  initlistbox.setName("SlackBuilds");
-  _blistboxes.push_back(initlistbox);
+  _blistbox.setWindow(_win2);
 
   draw(true);
 
@@ -2026,6 +2449,8 @@ int MainWindow::initialize(MouseEvent * mevent)
 
   if (retval == 0)
   { 
+    restoreTags();
+    startWatcher();
     if (_filter == "installed SlackBuilds") { filterInstalled(); }
     else if (_filter == "upgradable SlackBuilds") { filterUpgradable(); }
     else if (_filter == "tagged SlackBuilds") { filterTagged(); }
@@ -2033,10 +2458,13 @@ int MainWindow::initialize(MouseEvent * mevent)
     else if (_filter == "non-dependencies") { filterNonDeps(); }
     else if (_filter == "SlackBuilds with build options set")
       filterBuildOptions();
+    else if (_filter.substr(0, 21) == "SlackBuilds matching ")
+      filterComposite();
     else { filterAll(mevent); }
   }
   else
   { 
+    _watcher.stop();
     clearStatus();
     if (retval == 1)
       msg = "Error reading SlackBuilds repository.";
@@ -2071,7 +2499,7 @@ void MainWindow::selectFilter(MouseEvent * mevent)
 {
   WINDOW *filterwin;
   std::string selection, selected;
-  bool getting_selection;
+  bool getting_selection, combine;
 
   // Set up window
 
@@ -2082,6 +2510,7 @@ void MainWindow::selectFilter(MouseEvent * mevent)
   // Get filter selection
 
   getting_selection = true;
+  combine = false;
   while (getting_selection)
   {
     selected = "None";
@@ -2119,6 +2548,8 @@ void MainWindow::selectFilter(MouseEvent * mevent)
     else if ( (selected == "Build options set")
            || (selection == "l") )
       filterBuildOptions();
+    else if ( (selected == "Combine filters...") || (selection == "C") )
+      combine = true;
     else if (selection == signals::resize)
     {
       getting_selection = true;
@@ -2132,6 +2563,8 @@ void MainWindow::selectFilter(MouseEvent * mevent)
 
   delwin(filterwin);
   draw(true);
+
+  if (combine) { combineFilters(mevent); }
 }
 
 /*******************************************************************************
@@ -2167,14 +2600,22 @@ void MainWindow::search(MouseEvent * mevent)
     else if (selection == signals::keyEnter)
     { 
       getting_input = false;
-      if (_searchbox.searchString().size() > 0)
+      if ( (_searchbox.searchScripts()) && (_searchbox.regex()) &&
+           (! ScriptSearch(_searchbox.searchString(), false, true,
+                           true).valid()) )
+        printStatus("Invalid regular expression: " +
+                    _searchbox.searchString());
+      else if (_searchbox.searchString().size() > 0)
       {
         // Reset filter to All unless otherwise selected
         if (! _searchbox.currentList()) filterAll(mevent);
 
         // Now do the search
-        filterSearch(_searchbox.searchString(), _searchbox.caseSensitive(),
-                     _searchbox.wholeWord(), _searchbox.searchREADMEs());
+        if (_searchbox.fuzzy()) { filterFuzzy(_searchbox.searchString()); }
+        else
+          filterSearch(_searchbox.searchString(), _searchbox.caseSensitive(),
+                       _searchbox.wholeWord(), _searchbox.searchREADMEs(),
+                       _searchbox.searchScripts(), _searchbox.regex());
       }
     }
     else if (selection == signals::quit) { getting_input = false; }
@@ -2188,6 +2629,47 @@ void MainWindow::search(MouseEvent * mevent)
 
 /*******************************************************************************
 
+Dialog to combine filters
+
+*******************************************************************************/
+void MainWindow::combineFilters(MouseEvent * mevent)
+{
+  WINDOW *filterwin;
+  std::string selection;
+  bool getting_input;
+
+  // Set up window and dialog
+
+  filterwin = newwin(1, 1, 0, 0);
+  _compositebox.setWindow(filterwin);
+  placePopup(&_compositebox, filterwin);
+
+  getting_input = true;
+  while (getting_input)
+  {
+    selection = _compositebox.exec(mevent);
+    if (selection == signals::resize)
+    {
+      placePopup(&_compositebox, filterwin);
+      draw(true);
+      _compositebox.draw(true);
+    }
+    else if (selection == signals::keyEnter)
+    {
+      getting_input = false;
+      filterComposite();
+    }
+    else if (selection == signals::quit) { getting_input = false; }
+  }
+
+  // Get rid of window and redraw
+
+  delwin(filterwin);
+  draw(true);
+}
+
+/*******************************************************************************
+
 Dialog for actions pertaining to selected SlackBuild
 
 *******************************************************************************/
@@ -2373,17 +2855,17 @@ void MainWindow::quickSearch()
         if (check == 0)
         {
           _category_idx = _clistbox.highlight(); 
-          _blistboxes[_category_idx].draw(true);
+          currentBuildList().draw(true);
         }
       }
-      else { _blistboxes[_category_idx].highlightSearch(entry); }
+      else { currentBuildList().highlightSearch(entry); }
     }
   }
 
   if (_activated_listbox == 1)
   {
     build = static_cast<BuildListItem *>(
-                                  _blistboxes[_category_idx].highlightedItem());
+                                  currentBuildList().highlightedItem());
     printPackageVersion(*build);
   }
   else { clearStatus(); }
@@ -2391,12 +2873,170 @@ void MainWindow::quickSearch()
 
 /*******************************************************************************
 
+Performs a live search by name, updating the lists as the user types. A fuzzy
+search reranks all names on each key; otherwise, an incremental search session
+narrows the previous matches, and the lists are only rebuilt and redrawn when
+the matches change. Enter keeps the results as a filter; Esc restores the lists
+from before the search.
+
+*******************************************************************************/
+void MainWindow::liveSearch(bool fuzzy)
+{
+  int rows, cols, labellen, best;
+  unsigned int i, ncategories, nmatches, category_idx, activated_listbox,
+               prev_idx;
+  QuickSearch qsearch;
+  FuzzyMatcher matcher;
+  SearchSession session;
+  bool searching, accepted, changed, shown;
+  std::string selection, entry, label, msg;
+  BuildListView saved_view;
+  unsigned int saved_highlight;
+  BuildListItem *best_match;
+
+  // Save lists to restore if the search is canceled
+
+  saveListHighlight();
+  saved_view = _buildview;
+  saved_highlight = _clistbox.highlight();
+  category_idx = _category_idx;
+  activated_listbox = _activated_listbox;
+
+  if (fuzzy)
+  {
+    matcher.setItems(_displayed_slackbuilds);
+    label = "Fuzzy search: ";
+  }
+  else
+  {
+    session.start(_displayed_slackbuilds);
+    label = "Live search: ";
+  }
+  labellen = label.size();
+
+  getmaxyx(stdscr, rows, cols);
+  qsearch.setWindow(stdscr);
+  qsearch.setPosition(rows-2, labellen); 
+  qsearch.setWidth(cols-labellen);
+  printStatus(label, true);
+
+  searching = true;
+  accepted = false;
+  shown = false;
+  while (searching)
+  {
+    selection = qsearch.exec(0);
+    if (selection == signals::resize)
+    {  
+      getmaxyx(stdscr, rows, cols);
+      qsearch.setPosition(rows-2, labellen); 
+      qsearch.setWidth(cols-labellen);
+      draw(true);
+      printStatus(label, true);
+      qsearch.draw(0, true, false);
+    }
+    else if (selection == signals::keyEnter)
+    {
+      searching = false;
+      accepted = (qsearch.text().size() > 0);
+    }
+    else if (selection == signals::quit) { searching = false; }
+    else if (selection != "ignore")
+    {
+      entry = qsearch.text();
+      if (fuzzy) { changed = true; }
+      else { changed = ( (session.update(entry) != 0) || (! shown) ); }
+      shown = true;
+      prev_idx = _category_idx;
+      best_match = NULL;
+
+      // Show results without changing the displayed SlackBuilds. If the
+      // matches are the same, only the highlight may move.
+
+      if (changed)
+      {
+        _activated_listbox = 0;
+        _category_idx = 0;
+        if (! fuzzy)
+          filter_session(_displayed_slackbuilds, _displayed_categories,
+                         _clistbox, _buildview, nmatches, session, entry,
+                         false, &best_match);
+        else if (entry.size() == 0)
+          filter_by_func(_displayed_slackbuilds, &any_build,
+                         _displayed_categories, _clistbox, _buildview,
+                         nmatches, false);
+        else
+          filter_fuzzy(_displayed_slackbuilds, _displayed_categories,
+                       _clistbox, _buildview, nmatches, matcher, entry,
+                       _fuzzy_results, false, &best_match);
+      }
+      else if ( (best = session.bestMatch(entry)) >= 0 )
+        best_match = _displayed_slackbuilds[session.category(best)]
+                                           [session.index(best)];
+      if ( (best_match) &&
+           (_clistbox.setHighlight(best_match->getProp("category")) == 0) )
+      {
+        _category_idx = _clistbox.highlight();
+        currentBuildList().setHighlight(best_match->name());
+      }
+      changed = ( changed || (_category_idx != prev_idx) );
+      _clistbox.draw(changed);
+      currentBuildList().draw(changed);
+    }
+  }
+
+  if ( (accepted) && (fuzzy) ) { filterFuzzy(qsearch.text()); }
+  else if (accepted)
+  {
+    entry = qsearch.text();
+    setFilter("search for " + entry);
+    session.update(entry);
+    filter_session(_displayed_slackbuilds, _displayed_categories,
+                   _clistbox, _buildview, nmatches, session, entry,
+                   settings::cumulative_filters, &best_match);
+    list_build_set(_buildview, _filter_cache.numBuilds(), _displayed_set);
+    if ( (best_match) &&
+         (_clistbox.setHighlight(best_match->getProp("category")) == 0) )
+    {
+      _category_idx = _clistbox.highlight();
+      currentBuildList().setHighlight(best_match->name());
+    }
+    if (nmatches == 0) 
+      msg = "No matches for " + entry + ".";
+    else if (nmatches == 1) 
+      msg = "1 match for " + entry + ".";
+    else 
+      msg = int_to_string(nmatches) + " matches for " + entry + ".";
+    printStatus(msg);
+  }
+  else
+  {
+    _buildview = saved_view;
+    _clistbox.clearList();
+    ncategories = _buildview.numCategories();
+    for ( i = 0; i < ncategories; i++ )
+    {
+      _clistbox.addItem(_buildview.category(i));
+    }
+    _clistbox.setHighlight(saved_highlight);
+    _category_idx = category_idx;
+    _activated_listbox = activated_listbox;
+    _clistbox.setActivated(_activated_listbox == 0);
+    currentBuildList().setActivated(_activated_listbox == 1);
+    clearStatus();
+  }
+  draw(true);
+}
+
+/*******************************************************************************
+
 Filters by upgradable, tags, and then upgrades tags
 
 *******************************************************************************/
 void MainWindow::upgradeAll(MouseEvent * mevent)
 {
-  unsigned int k, ncategories;
+  unsigned int j, k, ncategories, nbuilds;
+  BuildListItem *build;
 
   // Clear tags
 
@@ -2412,7 +3052,16 @@ void MainWindow::upgradeAll(MouseEvent * mevent)
     for ( k = 0; k < ncategories; k++ )
     {
       _clistbox.tagCategory(k);
-      _blistboxes[k].tagAll();
+      nbuilds = _buildview.numBuilds(k);
+      for ( j = 0; j < nbuilds; j++ )
+      {
+        build = _buildview.build(k, j);
+        if (! build->getBoolProp("tagged"))
+        {
+          build->setBoolProp("tagged", true);
+          _taglist.addItem(build);
+        }
+      }
     }
     draw(true);
 
@@ -2432,7 +3081,6 @@ Lists upgradable SlackBuilds (non-interactive)
 *******************************************************************************/
 int MainWindow::listUpgradable()
 {
-  BuildListBox initlistbox;
   int retval;
   unsigned int i, j, ncategories, nbuilds, nupgradable;
   BuildListItem *build;
@@ -2440,9 +3088,6 @@ int MainWindow::listUpgradable()
   _clistbox.clearList();
   _clistbox.setActivated(true);
   _clistbox.setName("Groups");
-  initlistbox.setActivated(false);
-  initlistbox.setName("SlackBuilds");
-  _blistboxes.push_back(initlistbox);
 
   // Read SlackBuilds repository
 
@@ -2463,11 +3108,7 @@ int MainWindow::listUpgradable()
       std::cout << "No upgradable SlackBuilds." << std::endl;
     else
     {
-      nupgradable = 0;
-      for ( i = 0; i < ncategories; i++ )
-      {
-        nupgradable += _blistboxes[i].numItems();
-      }
+      nupgradable = _buildview.numBuilds();
       if (nupgradable == 1)
         std::cout << "1 upgradable SlackBuild." << std::endl;
       else
@@ -2477,10 +3118,10 @@ int MainWindow::listUpgradable()
       }
       for ( i = 0; i < ncategories; i++ )
       {
-        nbuilds = _blistboxes[i].numItems();
+        nbuilds = _buildview.numBuilds(i);
         for ( j = 0; j < nbuilds; j++ )
         {
-          build = static_cast<BuildListItem *>(_blistboxes[i].itemByIdx(j));
+          build = _buildview.build(i, j);
           std::cout << build->name() << std::endl;
         }
       }
@@ -2549,7 +3190,7 @@ std::string MainWindow::handleMouseEvent(MouseEvent * mevent)
     if (_activated_listbox == 0)
       activateListBox(1);
 
-    action = _blistboxes[_category_idx].handleMouseEvent(mevent);
+    action = currentBuildList().handleMouseEvent(mevent);
     if (action == signals::highlight)
       printSelectedPackageVersion();
 
@@ -2584,7 +3225,10 @@ Redraws window
 *******************************************************************************/
 void MainWindow::draw(bool force)
 {
-  clear();
+  // Erase instead of clear, so the terminal is not wiped and repainted; only
+  // cells that end up different are written when the update is flushed
+
+  erase();
 
   // Draw stuff
 
@@ -2613,6 +3257,11 @@ std::string MainWindow::exec(MouseEvent * mevent)
   {
     // Get input from Categories list box
 
+    // While watching for outside changes, stop waiting for input now and then
+    // to check for them
+
+    if (_watcher.active()) { timeout(ChangeWatcher::pollInterval); }
+
     if (_activated_listbox == 0)
     {
       selection = _clistbox.exec(mevent);
@@ -2643,7 +3292,7 @@ std::string MainWindow::exec(MouseEvent * mevent)
 
     else if (_activated_listbox == 1)
     {
-      selection = _blistboxes[_category_idx].exec(mevent);
+      selection = currentBuildList().exec(mevent);
 
       // Highlighted item changed
 
@@ -2672,11 +3321,15 @@ std::string MainWindow::exec(MouseEvent * mevent)
         handleMouseEvent(mevent);
     }
 
+    timeout(-1);
+
     // Key signals with the same action w/ either type of list box
 
-    if (selection == "q") { quit(); }
+    if (selection == signals::nullEvent) { applyExternalChanges(mevent); }
+    else if (selection == "q") { quit(); }
     else if (selection == signals::resize) { draw(true); }
     else if (selection == "f") { selectFilter(mevent); }
+    else if (selection == "b") { previousFilter(); }
     else if (selection == "/") { search(mevent); }
     else if (selection == "s") { syncRepo(mevent); }
     else if (selection == "o") 
@@ -2697,6 +3350,10 @@ std::string MainWindow::exec(MouseEvent * mevent)
     else if (selection == "e") { applyTags("Reinstall", mevent); }
     else if ( (selection.size() == 1) && (selection[0] == 0x13) )  // Ctrl-s
       quickSearch(); 
+    else if ( (selection.size() == 1) && (selection[0] == 0x06) )  // Ctrl-f
+      liveSearch(true); 
+    else if ( (selection.size() == 1) && (selection[0] == 0x0e) )  // Ctrl-n
+      liveSearch(false); 
     else if (selection == signals::keyF9)
     {
       activateMenubar();
@@ -148,13 +148,13 @@ void Menubar::redrawSingleItem(unsigned int idx)
   pos = menuColumn(idx);
   if ( (int(idx) == _highlight) && (_activated) )
   {
-    color_pair1 = colors.getPair("fg_highlight_active", "bg_highlight_active");
-    color_pair2 = colors.getPair("hotkey", "bg_highlight_active");
+    color_pair1 = _highlight_active_pair;
+    color_pair2 = _hotkey_active_pair;
   }
   else
   {
-    color_pair1 = colors.getPair(_fg_color, _bg_color);
-    color_pair2 = colors.getPair("hotkey", _bg_color);
+    color_pair1 = _color_pair;
+    color_pair2 = _hotkey_pair;
   }
 
   // Save highlight idx for redrawing later.
@@ -240,7 +240,7 @@ std::string Menubar::execList(MouseEvent * mevent)
   retval = _lists[_highlight].exec(mevent);
 
   wresize(_listwins[_highlight], 0, 0);
-  wrefresh(_listwins[_highlight]);
+  wnoutrefresh(_listwins[_highlight]);
 
   if (_parent)
     _parent->draw(true);
@@ -261,8 +261,7 @@ Menubar::Menubar()
   _activated = false;
   _lists.resize(0);
   _listwins.resize(0);
-  _fg_color = "fg_title";
-  _bg_color = "bg_title";
+  setColor("fg_title", "bg_title");
   _redraw_type = "all";
   _pad = 0;
   _outerpad = 0;
@@ -277,8 +276,7 @@ Menubar::Menubar(WINDOW *win)
   _activated = false;
   _lists.resize(0);
   _listwins.resize(0);
-  _fg_color = "fg_title";
-  _bg_color = "bg_title";
+  setColor("fg_title", "bg_title");
   _redraw_type = "all";
   _pad = 0;
   _outerpad = 0;
@@ -505,14 +503,14 @@ void Menubar::draw(bool force)
 
     getmaxyx(_win, rows, cols);
     wmove(_win, 0, 0);
-    colors.turnOn(_win, _fg_color, _bg_color);
+    colors.turnOn(_win, _color_pair);
     printToEol("", cols);
     colors.turnOff(_win);
     redrawAllItems();
   }
   else
     redrawChangedItems();
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -43,7 +43,6 @@ screen or not.
 *******************************************************************************/
 void MenubarList::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
   int rows, cols, rowsavail, lastrow, nspaces, i, hidx, len;
   int color_pair1, color_pair2;
 
@@ -61,16 +60,14 @@ void MenubarList::redrawSingleItem(unsigned int idx)
   {
     if (_activated) 
     { 
-      fg = "fg_highlight_active"; 
-      bg = "bg_highlight_active"; 
+      color_pair1 = _highlight_active_pair;
+      color_pair2 = _hotkey_active_pair;
     }
     else
     {
-      fg = "fg_highlight_inactive"; 
-      bg = "bg_highlight_inactive"; 
+      color_pair1 = _highlight_inactive_pair;
+      color_pair2 = _hotkey_inactive_pair;
     }
-    color_pair1 = colors.getPair(fg, bg);
-    color_pair2 = colors.getPair("hotkey", bg);
     if (colors.turnOn(_win, color_pair1) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
@@ -78,8 +75,8 @@ void MenubarList::redrawSingleItem(unsigned int idx)
   } 
   else
   {
-    color_pair1 = colors.getPair("fg_combobox", "bg_combobox");
-    color_pair2 = colors.getPair("hotkey", "bg_combobox");
+    color_pair1 = _color_pair;
+    color_pair2 = _hotkey_pair;
   }
 
   // Save highlight idx for redrawing later.
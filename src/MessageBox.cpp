@@ -32,7 +32,7 @@ void MessageBox::redrawFrame()
   wmove(_win, 1, 1);
   wclrtoeol(_win);
   if ( (! _header_colorize) ||
-       (colors.turnOn(_win, "fg_title", "bg_title") != 0) )
+       (colors.turnOn(_win, _title_pair) != 0) )
     wattron(_win, A_BOLD);
   printSpaces(left-1);
   printToEol(_name);
@@ -303,11 +303,11 @@ void MessageBox::draw(bool force)
   else
   {
     clearWindow();
-    colors.setBackground(_win, _fg_color, _bg_color);
+    colors.setBackground(_win, _color_pair);
     redrawFrame();
     redrawMessage();
   }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -337,7 +337,7 @@ std::string MessageBox::exec(MouseEvent * mevent)
 
     // Get user input
 
-    switch (ch = getch()) {
+    switch (ch = readKey()) {
   
       // Enter key
 
@@ -0,0 +1,630 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>         // remove
+#include <cstdlib>        // getenv, mkdtemp, mkstemp, realpath, free
+#include <ctime>          // timespec
+#include <ftw.h>          // nftw
+#include <unistd.h>       // close, access
+#include <utime.h>        // utime
+#include <sys/stat.h>     // stat, chmod
+#include "BuildListItem.h"
+#include "DirListing.h"
+#include "InstalledPackages.h"
+#include "ShellReader.h"
+#include "string_util.h"
+#include "settings.h"     // repo_dir
+#include "backend.h"      // get_sources, run_command, installed_packages
+#include "NativeBackend.h"
+
+#ifndef CONFDIR
+  #define CONFDIR "/etc/sboui"
+#endif
+
+/*******************************************************************************
+
+File helpers
+
+*******************************************************************************/
+int copy_file(const std::string & src, const std::string & dest)
+{
+  std::ifstream in;
+  std::ofstream out;
+
+  in.open(src.c_str(), std::ios::binary);
+  if (! in.is_open()) { return 1; }
+  out.open(dest.c_str(), std::ios::binary | std::ios::trunc);
+  if (! out.is_open()) { return 1; }
+  out << in.rdbuf();
+  out.close();
+  if (out.fail()) { return 1; }
+
+  return 0;
+}
+
+bool file_exists(const std::string & path)
+{
+  return (access(path.c_str(), F_OK) == 0);
+}
+
+std::string real_path(const std::string & path)
+{
+  char *resolved;
+  std::string result;
+
+  resolved = realpath(path.c_str(), NULL);
+  if (resolved == NULL) { return path; }
+  result = resolved;
+  free(resolved);
+
+  return result;
+}
+
+bool later(const timespec & t1, const timespec & t2)
+{
+  if (t1.tv_sec != t2.tv_sec) { return (t1.tv_sec > t2.tv_sec); }
+  return (t1.tv_nsec > t2.tv_nsec);
+}
+
+/*******************************************************************************
+
+Removes a directory and everything in it, like rm -rf
+
+*******************************************************************************/
+int remove_tree_entry(const char *path, const struct stat *, int,
+                      struct FTW *)
+{
+  std::remove(path);
+  return 0;
+}
+
+void remove_tree(const std::string & path)
+{
+  nftw(path.c_str(), remove_tree_entry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+/*******************************************************************************
+
+Marks the time before a build, with the clock file times use. Same as the
+temporary file sboui-backend compares new packages and directories against.
+
+*******************************************************************************/
+int mark_time(timespec & start)
+{
+  char marker[] = "/tmp/sboui.XXXXXX";
+  struct stat sb;
+  int fd;
+
+  fd = mkstemp(marker);
+  if (fd == -1) { return 1; }
+  if (fstat(fd, &sb) != 0)
+  {
+    close(fd);
+    std::remove(marker);
+    return 1;
+  }
+  start = sb.st_ctim;
+  close(fd);
+  std::remove(marker);
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Asks a y/n question. As in sboui-backend, the answer is no if there is no
+input, e.g. for builds run by sboui in parallel.
+
+*******************************************************************************/
+bool NativeBackend::askYesNo(const std::string & msg) const
+{
+  std::string response;
+
+  while (true)
+  {
+    std::cout << msg << " (y/n): " << std::flush;
+    if (! std::getline(std::cin, response))
+    {
+      std::cout << std::endl;
+      return false;
+    }
+    if ( (response == "y") || (response == "Y") ) { return true; }
+    else if ( (response == "n") || (response == "N") ) { return false; }
+    else { std::cout << "Please enter y or n." << std::endl; }
+  }
+}
+
+/*******************************************************************************
+
+Copies a source file from the source cache of sboui-backend to the SlackBuild
+directory. Returns true if it was cached. Misses are left to
+sboui-backend fetch-source, which downloads, checks, and adds the file to the
+cache, so that the cache is only ever written in one place.
+
+*******************************************************************************/
+bool NativeBackend::sourceFromCache(const std::string & source,
+                                    const std::string & md5,
+                                    const std::string & builddir) const
+{
+  DirListing listing;
+  direntry entry;
+  std::string entrydir, cached;
+  std::ofstream hits;
+  unsigned int i, nentries;
+
+  if ( (_source_cache == "") || (md5 == "") ) { return false; }
+  entrydir = _source_cache + "/" + md5;
+  if (listing.setFromPath(entrydir) != 0) { return false; }
+
+  nentries = listing.size();
+  for ( i = 0; i < nentries; i++ )
+  {
+    entry = listing(i);
+    if (entry.type != "reg") { continue; }
+    if (entry.name == source)
+    {
+      cached = entry.path + entry.name;
+      break;
+    }
+    else if (cached == "") { cached = entry.path + entry.name; }
+  }
+  if (cached == "") { return false; }
+  if (copy_file(cached, builddir + "/" + source) != 0) { return false; }
+
+  // Touch the entry, so that pruning removes least recently used ones first
+
+  utime(entrydir.c_str(), NULL);
+  hits.open((_source_cache + "/.hits").c_str(), std::ios::app);
+  if (hits.is_open()) { hits << std::endl; }
+  std::cout << "Using cached " << source << std::endl;
+
+  return true;
+}
+
+/*******************************************************************************
+
+Gets sources into the SlackBuild directory and checks their md5sums. Returns 0
+on success or 1 on error.
+
+*******************************************************************************/
+int NativeBackend::fetchSources(const std::vector<std::string> & urls,
+                                const std::vector<std::string> & md5sums,
+                                const std::string & builddir,
+                                const std::string & sourcedir) const
+{
+  unsigned int i, nurls;
+  std::string source, md5, cmd;
+  bool sourcerr, md5err, checked;
+  int check;
+
+  sourcerr = false;
+  md5err = false;
+  nurls = urls.size();
+  for ( i = 0; i < nurls; i++ )
+  {
+    source = urls[i].substr(urls[i].find_last_of('/')+1);
+    if (i < md5sums.size()) { md5 = md5sums[i]; }
+    else { md5 = ""; }
+    checked = false;
+
+    // Copy sources from specified directory
+
+    if (sourcedir != "")
+    {
+      if (! file_exists(sourcedir + "/" + source))
+      {
+        std::cout << "Error: source file " << source << " not present in "
+                  << sourcedir << "." << std::endl;
+        return 1;
+      }
+      if (real_path(sourcedir) != real_path(settings::repo_dir))
+        copy_file(sourcedir + "/" + source, builddir + "/" + source);
+    }
+
+    // Use cached copy, or download, check, and cache it
+
+    else if (sourceFromCache(source, md5, builddir)) { checked = true; }
+    else
+    {
+      cmd = "SOURCE_CACHE=" + shell_quote(_source_cache)
+          + " sboui-backend fetch-source " + shell_quote(urls[i]) + " "
+          + shell_quote(md5) + " " + shell_quote(builddir);
+      check = run_command(cmd);
+      if (check == 0) { checked = true; }
+      else if (check != 3)
+      {
+        std::cout << "There was an error downloading the source file."
+                  << std::endl;
+        sourcerr = true;
+        continue;
+      }
+    }
+
+    // Check MD5sum
+
+    if (! checked)
+    {
+      cmd = "cd " + shell_quote(builddir) + " && echo "
+          + shell_quote(md5 + "  " + source)
+          + " | md5sum -c --status 2>/dev/null";
+      if (run_command(cmd) != 0)
+      {
+        if (! askYesNo("Error: md5sum check failed on " + source +
+                       ". Continue anyway?"))
+          md5err = true;
+      }
+    }
+  }
+
+  if (sourcerr) { std::cout << "One or more sources failed to download."
+                            << std::endl; }
+  if (md5err) { std::cout << "One or more sources failed the md5sum check."
+                          << std::endl; }
+  if (sourcerr || md5err) { return 1; }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Removes source files from the SlackBuild directory
+
+*******************************************************************************/
+void NativeBackend::removeSources(const std::vector<std::string> & urls,
+                                  const std::string & builddir) const
+{
+  unsigned int i, nurls;
+
+  nurls = urls.size();
+  for ( i = 0; i < nurls; i++ )
+  {
+    std::remove((builddir + "/" +
+                 urls[i].substr(urls[i].find_last_of('/')+1)).c_str());
+  }
+}
+
+/*******************************************************************************
+
+Finds the package made by a build: the one in OUTPUT named after the
+SlackBuild and its version and changed since the build started. Note version
+string can contain trailing stuff like the kernel version. Returns 0 if exactly
+one is found.
+
+*******************************************************************************/
+int NativeBackend::findPackage(const BuildListItem & build,
+                               const timespec & start, std::string & pkg) const
+{
+  DirListing listing;
+  direntry entry;
+  std::string prefix, ext;
+  struct stat sb;
+  unsigned int i, nentries, npkgs;
+
+  pkg = "";
+  npkgs = 0;
+  prefix = build.name() + "-" + build.getProp("available_version");
+  if (listing.setFromPath(_output) == 0)
+  {
+    nentries = listing.size();
+    for ( i = 0; i < nentries; i++ )
+    {
+      entry = listing(i);
+      if ( (entry.type != "reg") ||
+           (entry.name.size() < prefix.size()+4) ||
+           (entry.name.substr(0, prefix.size()) != prefix) )
+        continue;
+      ext = entry.name.substr(entry.name.size()-4);
+      if ( (ext[0] != '.') || (ext[1] != 't') || (ext[3] != 'z') )
+        continue;
+      if (stat((entry.path + entry.name).c_str(), &sb) != 0) { continue; }
+      if (! later(sb.st_ctim, start)) { continue; }
+      pkg = entry.path + entry.name;
+      npkgs++;
+    }
+  }
+
+  if (npkgs == 0)
+  {
+    std::cout << "Error: build failed." << std::endl;
+    return 1;
+  }
+  else if (npkgs > 1)
+  {
+    // This is very unlikely to happen, since the package must be new
+
+    std::cout << "Error: more than one package in " << _output
+              << " matching " << prefix << " pattern." << std::endl;
+    std::cout << "Please remove unneeded packages and try again."
+              << std::endl;
+    pkg = "";
+    return 2;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Constructor. Defaults are those of sboui-backend when a setting is not given.
+
+*******************************************************************************/
+NativeBackend::NativeBackend()
+{
+  _tmp = "/tmp/lngn";
+  _output = "/tmp";
+  _source_cache = "/var/cache/sboui/sources";
+  _clean_package = false;
+  _clean_tmp = false;
+  _clean_source = false;
+}
+
+/*******************************************************************************
+
+Reads settings the way sboui-backend gets them: sboui-backend.conf, which it
+sources, takes precedence over its environment, which includes vars set before
+the command as well as the environment of sboui. Returns 1 if the
+configuration file could not be read, in which case only the environment is
+used.
+
+*******************************************************************************/
+int NativeBackend::readConfig(const std::string & vars)
+{
+  ShellReader reader;
+  std::vector<std::string> varnames, values, splitvars;
+  std::vector<bool> found;
+  std::string conf, value;
+  unsigned int i, j, nvarnames, nsplitvars;
+  char *env;
+  int retval;
+
+  varnames.push_back("TMP");
+  varnames.push_back("OUTPUT");
+  varnames.push_back("CLEAN_PACKAGE");
+  varnames.push_back("CLEAN_TMP");
+  varnames.push_back("CLEAN_SOURCE");
+  varnames.push_back("SOURCE_CACHE");
+  nvarnames = varnames.size();
+  values.assign(nvarnames, "");
+  found.assign(nvarnames, false);
+
+  // Environment, with vars taking precedence as the last assignment
+
+  splitvars = split(vars);
+  nsplitvars = splitvars.size();
+  for ( i = 0; i < nvarnames; i++ )
+  {
+    for ( j = nsplitvars; j > 0; j-- )
+    {
+      if (splitvars[j-1].substr(0, varnames[i].size()+1) != varnames[i] + "=")
+        continue;
+      value = splitvars[j-1].substr(varnames[i].size()+1);
+      if ( (value.size() >= 2) &&
+           ( (value[0] == '"') || (value[0] == '\'') ) &&
+           (value[value.size()-1] == value[0]) )
+        value = value.substr(1, value.size()-2);
+      values[i] = value;
+      found[i] = true;
+      break;
+    }
+    if (found[i]) { continue; }
+    env = std::getenv(varnames[i].c_str());
+    if (env != NULL)
+    {
+      values[i] = env;
+      found[i] = true;
+    }
+  }
+
+  // Configuration file
+
+  env = std::getenv("CONF");
+  if ( (env != NULL) && (std::string(env) != "") ) { conf = env; }
+  else { conf = CONFDIR "/sboui-backend.conf"; }
+  retval = 1;
+  if (reader.open(conf) == 0)
+  {
+    for ( i = 0; i < nvarnames; i++ )
+    {
+      if (reader.read(varnames[i], value) == 0)
+      {
+        values[i] = value;
+        found[i] = true;
+      }
+    }
+    reader.close();
+    retval = 0;
+  }
+
+  if (values[0] != "") { _tmp = values[0]; }
+  if (values[1] != "") { _output = values[1]; }
+  _clean_package = (values[2] == "yes");
+  _clean_tmp = (values[3] == "yes");
+  _clean_source = (values[4] == "yes");
+  if (found[5]) { _source_cache = values[5]; }
+
+  return retval;
+}
+
+/*******************************************************************************
+
+Builds a SlackBuild. Returns 0 on success.
+
+*******************************************************************************/
+int NativeBackend::buildSlackBuild(const BuildListItem & build,
+                                   const std::string & vars,
+                                   const std::string & sourcedir,
+                                   const std::string & pkgcache, bool force,
+                                   bool buildonly, std::string & pkg) const
+{
+  const installed_pkg *installed;
+  std::string builddir, script, buildtmp, cmd;
+  std::vector<std::string> urls, md5sums;
+  DirListing tmplisting;
+  direntry entry;
+  struct stat sb;
+  mode_t perm;
+  timespec start;
+  char tmpdir[4096];
+  unsigned int i, nentries;
+  int check;
+
+  pkg = "";
+  builddir = settings::repo_dir + "/" + build.getProp("category") + "/"
+           + build.name();
+  script = build.name() + ".SlackBuild";
+  if (stat((builddir + "/" + script).c_str(), &sb) != 0)
+  {
+    std::cout << "Error: there is no SlackBuild named " << build.name()
+              << "." << std::endl;
+    return 1;
+  }
+  perm = sb.st_mode & 07777;
+
+  // Offer reinstallation if it is already installed
+
+  installed = installed_packages.find(build.name());
+  if ( (installed != NULL) && (! force) && (! buildonly) )
+  {
+    std::cout << build.name() << " is already installed." << std::endl;
+    std::cout << "Installed package: " << installed->pkg << std::endl;
+    std::cout << "Available version: " << build.getProp("available_version")
+              << std::endl;
+    if (! askYesNo("Do you want to remove the existing package and "
+                   "reinstall?"))
+      return 0;
+  }
+
+  // Some SlackBuilds are unsupported on 64-bit, but may work with multilib
+
+  check = get_sources(build, urls, md5sums);
+  if (check == 1)
+  {
+    std::cout << "Error: could not read " << build.name() << ".info."
+              << std::endl;
+    return 1;
+  }
+  else if (check == 2)
+  {
+    if (! askYesNo(build.name() + " is unsupported on x86_64, but it may "
+                   "work with mutlilib.\nTry installing 32-bit version?"))
+      return 0;
+    get_sources(build, urls, md5sums, true);
+  }
+
+  // Get sources
+
+  removeSources(urls, builddir);
+  if (fetchSources(urls, md5sums, builddir, sourcedir) != 0)
+  {
+    if ( _clean_source && ( (sourcedir == "") ||
+         (real_path(sourcedir) != real_path(settings::repo_dir)) ) )
+      removeSources(urls, builddir);
+    return 1;
+  }
+
+  // Builds run in parallel each get their own build location, so that
+  // cleaning up one does not remove files from another
+
+  cmd = "cd " + shell_quote(builddir) + " && ";
+  if (buildonly)
+  {
+    DirListing().createFromPath(_tmp);
+    buildtmp = _tmp + "/sboui-build.XXXXXX";
+    if (buildtmp.size() >= sizeof(tmpdir)) { return 1; }
+    buildtmp.copy(tmpdir, buildtmp.size());
+    tmpdir[buildtmp.size()] = '\0';
+    if (mkdtemp(tmpdir) == NULL)
+    {
+      std::cout << "Error: could not create build directory in " << _tmp
+                << "." << std::endl;
+      return 1;
+    }
+    buildtmp = tmpdir;
+  }
+  else { buildtmp = _tmp; }
+
+  // TMP and OUTPUT are passed explicitly, so that the package ends up where
+  // findPackage looks for it even if they were only set in sboui-backend.conf
+
+  cmd += vars + " " + build.buildOptionsEnv() + " TMP=" + shell_quote(buildtmp)
+       + " OUTPUT=" + shell_quote(_output) + " ./" + script;
+
+  // Execute build script
+
+  if (mark_time(start) != 0)
+  {
+    std::cout << "Error: could not create temporary file in /tmp."
+              << std::endl;
+    return 1;
+  }
+  chmod((builddir + "/" + script).c_str(), perm | S_IXUSR | S_IXGRP | S_IXOTH);
+  run_command(cmd);
+  chmod((builddir + "/" + script).c_str(), perm);
+
+  // Check if package was built successfully, and keep a copy for sboui to
+  // reuse
+
+  check = findPackage(build, start, pkg);
+  if ( (check == 0) && (pkgcache != "") )
+  {
+    DirListing().createFromPath(pkgcache);
+    copy_file(pkg, pkgcache + "/" + pkg.substr(pkg.find_last_of('/')+1));
+  }
+  if (buildonly && (check == 0))
+    std::cout << "Built package: " << pkg << std::endl;
+
+  // Remove temporary files and source code
+
+  if (_clean_tmp && buildonly) { remove_tree(buildtmp); }
+  else if (_clean_tmp && (tmplisting.setFromPath(_tmp) == 0))
+  {
+    nentries = tmplisting.size();
+    for ( i = 0; i < nentries; i++ )
+    {
+      entry = tmplisting(i);
+      if (entry.type != "dir") { continue; }
+      if (stat((entry.path + entry.name).c_str(), &sb) != 0) { continue; }
+      if (later(sb.st_ctim, start)) { remove_tree(entry.path + entry.name); }
+    }
+  }
+  if ( _clean_source && ( (sourcedir == "") ||
+       (real_path(sourcedir) != real_path(settings::repo_dir)) ) )
+    removeSources(urls, builddir);
+  if (check != 0) { return 1; }
+
+  // Notify of any special Slackware instructions
+
+  if ( file_exists(builddir + "/README.SLACKWARE") ||
+       file_exists(builddir + "/README.Slackware") )
+  {
+    std::cout << "Note: Slackware notes found. You should read them with "
+              << "'sboui-backend info " << build.name() << "'" << std::endl;
+    std::cout << "or with the Browse Files function of sboui." << std::endl;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Installs or upgrades a package. Returns exit status of upgradepkg, or 1 if the
+package does not exist.
+
+*******************************************************************************/
+int NativeBackend::installPackage(const std::string & pkg, bool keep) const
+{
+  int check;
+
+  if (! file_exists(pkg))
+  {
+    std::cout << "Error: package " << pkg << " not found." << std::endl;
+    return 1;
+  }
+  check = run_command("upgradepkg --reinstall --install-new "
+                      + shell_quote(pkg));
+  if ( (check == 0) && _clean_package && (! keep) )
+    std::remove(pkg.c_str());
+
+  return check;
+}
@@ -367,6 +367,20 @@ OptionsWindow::OptionsWindow()
   _items[count]->setName("Display a warning for invalid package names");
   _items[count]->setPosition(line,1);
   _items[count]->setWidth(_items[count]->name().size()+4);
+  count++;
+  line += 1;
+
+  addItem(&_watch_toggle);
+  _items[count]->setName("Watch for changes made outside of sboui");
+  _items[count]->setPosition(line,1);
+  _items[count]->setWidth(_items[count]->name().size()+4);
+  count++;
+  line += 1;
+
+  addItem(&_prefetch_toggle);
+  _items[count]->setName("Download sources ahead of builds");
+  _items[count]->setPosition(line,1);
+  _items[count]->setWidth(_items[count]->name().size()+4);
 }
 
 OptionsWindow::~OptionsWindow()
@@ -417,6 +431,8 @@ void OptionsWindow::readSettings()
   _uvars_inp.setText(upgrade_vars);
 
   _warninval_toggle.setEnabled(warn_invalid_pkgnames);
+  _watch_toggle.setEnabled(watch_changes);
+  _prefetch_toggle.setEnabled(prefetch_sources);
 }
 
 void OptionsWindow::applySettings(int & check_color, int & check_write,
@@ -449,6 +465,8 @@ void OptionsWindow::applySettings(int & check_color, int & check_write,
   upgrade_vars = _uvars_inp.text();
 
   warn_invalid_pkgnames = _warninval_toggle.enabled();
+  watch_changes = _watch_toggle.enabled();
+  prefetch_sources = _prefetch_toggle.enabled();
 
   // Write configuration to appropriate configuration file
 
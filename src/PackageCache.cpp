@@ -0,0 +1,226 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>      // find
+#include <cstdio>         // remove, snprintf
+#include <stdint.h>
+#include <sys/utsname.h>  // uname
+#include "BuildListItem.h"
+#include "DirListing.h"
+#include "InstalledPackages.h"
+#include "string_util.h"
+#include "index_util.h"   // index_hash_bytes
+#include "settings.h"     // repo_dir
+#include "backend.h"      // get_sources, indexed_reqs_order, installed_packages
+#include "PackageCache.h"
+
+/*******************************************************************************
+
+Adds a string, with its terminating null, to the hash of build inputs
+
+*******************************************************************************/
+void package_hash_string(uint64_t & hash, const std::string & str)
+{
+  index_hash_bytes(hash, str.c_str(), str.size()+1);
+}
+
+/*******************************************************************************
+
+Adds names and contents of files in a directory to the hash, recursing into
+subdirectories. Downloaded sources are left out, since they are checked by
+md5sum and may or may not be left in the SlackBuild directory.
+
+*******************************************************************************/
+void PackageCache::hashDir(uint64_t & hash, const std::string & path,
+                           const std::string & relpath,
+                           const std::vector<std::string> & sources) const
+{
+  DirListing listing;
+  direntry entry;
+  std::ifstream file;
+  char buffer[65536];
+  unsigned int i, nentries;
+
+  if (listing.setFromPath(path) != 0) { return; }
+  nentries = listing.size();
+  for ( i = 0; i < nentries; i++ )
+  {
+    entry = listing(i);
+    if (entry.type == "dir")
+      hashDir(hash, entry.path + entry.name, relpath + entry.name + "/",
+              sources);
+    else if (entry.type == "reg")
+    {
+      if (std::find(sources.begin(), sources.end(), entry.name) !=
+          sources.end())
+        continue;
+      package_hash_string(hash, relpath + entry.name);
+      file.open((entry.path + entry.name).c_str(), std::ios::binary);
+      while (file.read(buffer, sizeof(buffer)) || (file.gcount() > 0))
+      {
+        index_hash_bytes(hash, buffer, file.gcount());
+      }
+      file.close();
+      file.clear();
+    }
+  }
+}
+
+/*******************************************************************************
+
+Directory for one SlackBuild's cached package
+
+*******************************************************************************/
+std::string PackageCache::entryDir(const BuildListItem & build,
+                                   const std::string & key) const
+{
+  return _dir + "/" + build.name() + "/" + key;
+}
+
+/*******************************************************************************
+
+Constructors
+
+*******************************************************************************/
+PackageCache::PackageCache() { _dir = settings::package_cache; }
+PackageCache::PackageCache(const std::string & dir) { _dir = dir; }
+
+/*******************************************************************************
+
+Hash of build inputs, as hex string
+
+*******************************************************************************/
+std::string PackageCache::inputKey(const BuildListItem & build,
+                                   const std::string & vars) const
+{
+  uint64_t hash;
+  std::vector<std::string> urls, md5sums, sources, reqs, direct;
+  std::vector<BuildListItem *> reqlist;
+  const installed_pkg *entry;
+  struct utsname sysinfo;
+  unsigned int i, nurls, nreqs, ndirect;
+  std::size_t pos;
+  char key[17];
+
+  hash = index_hash_basis;
+  package_hash_string(hash, build.name());
+  if (uname(&sysinfo) == 0) { package_hash_string(hash, sysinfo.machine); }
+  package_hash_string(hash, trim(vars));
+  package_hash_string(hash, trim(build.buildOptionsEnv()));
+
+  // SlackBuild directory
+
+  get_sources(build, urls, md5sums);
+  nurls = urls.size();
+  for ( i = 0; i < nurls; i++ )
+  {
+    pos = urls[i].find_last_of('/');
+    if (pos == std::string::npos) { sources.push_back(urls[i]); }
+    else { sources.push_back(urls[i].substr(pos+1)); }
+  }
+  hashDir(hash, settings::repo_dir + "/" + build.getProp("category") + "/" +
+                build.name(), "", sources);
+
+  // Installed versions of requirements, including indirect ones, so that
+  // upgrading anything below a SlackBuild in the dependency chain changes its
+  // key. Direct requirements missing from the repository are still counted.
+
+  indexed_reqs_order(build, reqlist);
+  nreqs = reqlist.size();
+  for ( i = 0; i < nreqs; i++ )
+  {
+    reqs.push_back(reqlist[i]->name());
+  }
+  direct = split(build.getProp("requires"));
+  ndirect = direct.size();
+  for ( i = 0; i < ndirect; i++ )
+  {
+    if ( (direct[i] != "%README%") &&
+         (std::find(reqs.begin(), reqs.end(), direct[i]) == reqs.end()) )
+      reqs.push_back(direct[i]);
+  }
+  nreqs = reqs.size();
+  for ( i = 0; i < nreqs; i++ )
+  {
+    entry = installed_packages.find(reqs[i]);
+    if (entry == NULL) { package_hash_string(hash, reqs[i]); }
+    else { package_hash_string(hash, entry->pkg); }
+  }
+
+  std::snprintf(key, sizeof(key), "%016llx", (unsigned long long) hash);
+
+  return std::string(key);
+}
+
+/*******************************************************************************
+
+Cached package built from the given inputs, or "" if there is none
+
+*******************************************************************************/
+std::string PackageCache::find(const BuildListItem & build,
+                               const std::string & key) const
+{
+  DirListing listing;
+  direntry entry;
+  std::string ext;
+  unsigned int i, nentries;
+
+  if (listing.setFromPath(entryDir(build, key)) != 0) { return ""; }
+  nentries = listing.size();
+  for ( i = 0; i < nentries; i++ )
+  {
+    entry = listing(i);
+    if ( (entry.type != "reg") || (entry.name.size() < 4) ) { continue; }
+    ext = entry.name.substr(entry.name.size()-4);
+    if ( (ext[0] == '.') && (ext[1] == 't') && (ext[3] == 'z') &&
+         (entry.name.substr(0, build.name().size()+1) == build.name() + "-") )
+      return entry.path + entry.name;
+  }
+
+  return "";
+}
+
+/*******************************************************************************
+
+Directory in which to store the package built from the given inputs
+
+*******************************************************************************/
+std::string PackageCache::storeDir(const BuildListItem & build,
+                                   const std::string & key) const
+{
+  return entryDir(build, key);
+}
+
+/*******************************************************************************
+
+Removes packages cached for other inputs. Nothing is removed until the package
+built from the given inputs is in the cache, so that a failed build does not
+lose the last good package.
+
+*******************************************************************************/
+void PackageCache::prune(const BuildListItem & build,
+                         const std::string & key) const
+{
+  DirListing listing, entrylisting;
+  direntry entry, file;
+  unsigned int i, j, nentries, nfiles;
+
+  if (find(build, key) == "") { return; }
+  if (listing.setFromPath(_dir + "/" + build.name()) != 0) { return; }
+
+  nentries = listing.size();
+  for ( i = 0; i < nentries; i++ )
+  {
+    entry = listing(i);
+    if ( (entry.type != "dir") || (entry.name == key) ) { continue; }
+    if (entrylisting.setFromPath(entry.path + entry.name, true, true) != 0)
+      continue;
+    nfiles = entrylisting.size();
+    for ( j = 0; j < nfiles; j++ )
+    {
+      file = entrylisting(j);
+      std::remove((file.path + file.name).c_str());
+    }
+    std::remove((entry.path + entry.name).c_str());
+  }
+}
@@ -2,6 +2,7 @@
 #include <curses.h>
 #include "settings.h"
 #include "signals.h"
+#include "CursesWidget.h"
 #include "TextInput.h"
 #include "QuickSearch.h"
 #include "MouseEvent.h"
@@ -38,7 +39,7 @@ std::string QuickSearch::exec(int y_offset, MouseEvent * mevent)
 
     // Get user input
 
-    switch (ch = getch()) {
+    switch (ch = CursesWidget::readKey()) {
 
       // Enter key: return Enter signal
 
@@ -0,0 +1,597 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>    // sort, search, min
+#include <cctype>       // tolower
+#include <cstdio>       // rename, remove
+#include <cstring>      // memcpy, memcmp, memset
+#include <stdint.h>
+#include <fcntl.h>      // open
+#include <unistd.h>     // close
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>
+#include "settings.h"   // repo_dir
+#include "string_util.h"   // trim
+#include "index_util.h"
+#include "RepoIndex.h"
+#include "RepoScanner.h"
+#include "ReadmeIndex.h"
+
+/*******************************************************************************
+
+On-disk layout, following RepoIndex: header, key, build table, term table
+(sorted by term), postings, and a blob holding all strings. Each term refers to
+a range of postings, and each posting to an entry in the build table.
+
+*******************************************************************************/
+const char readme_magic[8] = {'S','B','O','U','I','R','D','X'};
+const uint32_t readme_version = 1;
+
+struct readme_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_len;
+  uint32_t nbuilds;
+  uint32_t nterms;
+  uint64_t npostings;
+  uint64_t strings_len;
+};
+
+struct readme_build {
+  index_string category;
+  index_string name;
+};
+
+struct readme_term {
+  index_string term;
+  uint32_t first_posting;
+  uint32_t npostings;
+};
+
+struct readme_posting {
+  uint32_t build;
+  uint32_t count;
+};
+
+/*******************************************************************************
+
+Adds words in README text to term counts. Like find_in_file, comment lines are
+skipped, and lines are split into words at spaces and trimmed. A word ending in
+one of the punctuation characters that find_in_file allows in whole-word
+searches is also counted without it.
+
+*******************************************************************************/
+void readme_add_terms(const std::string & text,
+                      std::unordered_map<std::string, unsigned int> & counts)
+{
+  std::size_t pos, eol, wordstart, wordend, len;
+  std::string word;
+  char last;
+
+  len = text.size();
+  pos = 0;
+  while (pos < len)
+  {
+    eol = text.find('\n', pos);
+    if (eol == std::string::npos) { eol = len; }
+    if (text[pos] == '#')
+    {
+      pos = eol+1;
+      continue;
+    }
+
+    wordstart = pos;
+    while (wordstart < eol)
+    {
+      wordend = text.find(' ', wordstart);
+      if ( (wordend == std::string::npos) || (wordend > eol) )
+        wordend = eol;
+      if (wordend > wordstart)
+      {
+        word.assign(text, wordstart, wordend-wordstart);
+        word = trim(word);
+        if (word.size() == 0)
+        {
+          wordstart = wordend+1;
+          continue;
+        }
+        for ( std::size_t k = 0; k < word.size(); k++ )
+        {
+          word[k] = std::tolower(word[k]);
+        }
+        counts[word]++;
+        last = word[word.size()-1];
+        if ( (word.size() > 1) &&
+             ( (last == '.') || (last == ',') || (last == ';') ||
+               (last == ':') || (last == ')') || (last == '?') ||
+               (last == '!') ) )
+          counts[word.substr(0, word.size()-1)]++;
+      }
+      wordstart = wordend+1;
+    }
+    pos = eol+1;
+  }
+}
+
+/*******************************************************************************
+
+Constructors and destructor
+
+*******************************************************************************/
+ReadmeIndex::ReadmeIndex()
+{
+  _path = "/var/lib/sboui/readme.index";
+  _map = NULL;
+  _size = 0;
+}
+
+ReadmeIndex::ReadmeIndex(const std::string & path)
+{
+  _path = path;
+  _map = NULL;
+  _size = 0;
+}
+
+ReadmeIndex::~ReadmeIndex() { unload(); }
+
+/*******************************************************************************
+
+Location of index file
+
+*******************************************************************************/
+void ReadmeIndex::setPath(const std::string & path) { _path = path; }
+const std::string & ReadmeIndex::path() const { return _path; }
+
+/*******************************************************************************
+
+Returns true if the index file can be written (i.e., its directory exists and
+is writable)
+
+*******************************************************************************/
+bool ReadmeIndex::writable() const { return index_writable(_path); }
+
+/*******************************************************************************
+
+Reads all READMEs in the repository and writes the index file. READMEs are read
+in parallel. The file is written to a temporary location first and then
+renamed. Returns 0 on success or 1 on error.
+
+*******************************************************************************/
+int ReadmeIndex::build() const
+{
+  RepoScanner scanner(settings::repo_dir);
+  RepoIndex repo_index;
+  std::vector<repo_category> categories;
+  std::vector<readme_build> buildtable;
+  std::vector<std::string> paths;
+  std::vector<std::unordered_map<std::string, unsigned int> > counts;
+  std::unordered_map<std::string, std::vector<readme_posting> > postings;
+  std::unordered_map<std::string, std::vector<readme_posting> >::iterator it;
+  std::unordered_map<std::string, unsigned int>::const_iterator cit;
+  std::vector<std::string> terms;
+  std::vector<readme_term> termtable;
+  std::vector<readme_posting> postingtable;
+  std::string key, blob, tmppath;
+  std::ofstream file;
+  readme_header header;
+  readme_posting posting;
+  unsigned int i, j, ncategories, nbuilds, nterms;
+  int k, nreadmes;
+
+  key = repo_index.computeKey();
+  if (key == "") { return 1; }
+  if (scanner.scan(categories) != 0) { return 1; }
+
+  // Build table
+
+  ncategories = categories.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = categories[i].builds.size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      readme_build rec;
+
+      rec.category = index_add_string(blob, categories[i].name);
+      rec.name = index_add_string(blob, categories[i].builds[j]);
+      buildtable.push_back(rec);
+      paths.push_back(settings::repo_dir + "/" + categories[i].name + "/" +
+                      categories[i].builds[j] + "/README");
+    }
+  }
+
+  // Count words in each README
+
+  nreadmes = paths.size();
+  counts.resize(nreadmes);
+#pragma omp parallel for schedule(dynamic,16)
+  for ( k = 0; k < nreadmes; k++ )
+  {
+    std::ifstream readme(paths[k].c_str());
+    std::stringstream ss;
+
+    if (! readme.is_open()) { continue; }
+    ss << readme.rdbuf();
+    readme_add_terms(ss.str(), counts[k]);
+  }
+
+  // Invert
+
+  for ( k = 0; k < nreadmes; k++ )
+  {
+    for ( cit = counts[k].begin(); cit != counts[k].end(); cit++ )
+    {
+      posting.build = k;
+      posting.count = cit->second;
+      postings[cit->first].push_back(posting);
+    }
+    counts[k].clear();
+  }
+
+  terms.reserve(postings.size());
+  for ( it = postings.begin(); it != postings.end(); it++ )
+  {
+    terms.push_back(it->first);
+  }
+  std::sort(terms.begin(), terms.end());
+
+  nterms = terms.size();
+  termtable.resize(nterms);
+  for ( i = 0; i < nterms; i++ )
+  {
+    std::vector<readme_posting> & termpostings = postings[terms[i]];
+
+    termtable[i].term = index_add_string(blob, terms[i]);
+    termtable[i].first_posting = postingtable.size();
+    termtable[i].npostings = termpostings.size();
+    postingtable.insert(postingtable.end(), termpostings.begin(),
+                        termpostings.end());
+  }
+
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, readme_magic, sizeof(readme_magic));
+  header.version = readme_version;
+  header.key_len = key.size();
+  header.nbuilds = buildtable.size();
+  header.nterms = termtable.size();
+  header.npostings = postingtable.size();
+  header.strings_len = blob.size();
+
+  // Write to temporary file and move into place
+
+  tmppath = _path + ".tmp";
+  file.open(tmppath.c_str(), std::ios::out | std::ios::binary |
+                             std::ios::trunc);
+  if (! file.is_open()) { return 1; }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(key.data(), key.size());
+  if (buildtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&buildtable[0]),
+               buildtable.size()*sizeof(readme_build));
+  if (termtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&termtable[0]),
+               termtable.size()*sizeof(readme_term));
+  if (postingtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&postingtable[0]),
+               postingtable.size()*sizeof(readme_posting));
+  file.write(blob.data(), blob.size());
+  file.close();
+  if (file.fail())
+  {
+    std::remove(tmppath.c_str());
+    return 1;
+  }
+
+  if (std::rename(tmppath.c_str(), _path.c_str()) != 0)
+  {
+    std::remove(tmppath.c_str());
+    return 1;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Maps index file. Returns 0 on success, 1 if the index file is missing or
+unreadable, 2 if it is stale, or 3 if it is corrupt.
+
+*******************************************************************************/
+int ReadmeIndex::load()
+{
+  RepoIndex repo_index;
+  int fd, retval;
+  struct stat sb;
+  const char *data;
+  readme_header header;
+  uint64_t tables_len;
+  std::string key;
+
+  unload();
+
+  fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0) { return 1; }
+  if ( (fstat(fd, &sb) != 0) || (sb.st_size < off_t(sizeof(header))) )
+  {
+    close(fd);
+    return 1;
+  }
+  _size = sb.st_size;
+  _map = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (_map == MAP_FAILED)
+  {
+    _map = NULL;
+    return 1;
+  }
+  data = static_cast<const char *>(_map);
+
+  // Check header and key
+
+  retval = 0;
+  std::memcpy(&header, data, sizeof(header));
+  tables_len = uint64_t(header.nbuilds)*sizeof(readme_build)
+             + uint64_t(header.nterms)*sizeof(readme_term)
+             + header.npostings*sizeof(readme_posting);
+  key = repo_index.computeKey();
+  if ( (std::memcmp(header.magic, readme_magic, sizeof(readme_magic)) != 0) ||
+       (header.version != readme_version) ||
+       (sizeof(header) + header.key_len + tables_len + header.strings_len
+        != _size) )
+    retval = 3;
+  else if ( (key == "") ||
+            (std::string(data + sizeof(header), header.key_len) != key) )
+    retval = 2;
+  if (retval != 0)
+  {
+    unload();
+    return retval;
+  }
+
+  _key = key;
+  _nbuilds = header.nbuilds;
+  _nterms = header.nterms;
+  _npostings = header.npostings;
+  _strings_len = header.strings_len;
+  _builds = data + sizeof(header) + header.key_len;
+  _terms = _builds + _nbuilds*sizeof(readme_build);
+  _postings = _terms + _nterms*sizeof(readme_term);
+  _strings = _postings + _npostings*sizeof(readme_posting);
+
+  return 0;
+}
+
+void ReadmeIndex::unload()
+{
+  if (_map != NULL) { munmap(_map, _size); }
+  _map = NULL;
+  _size = 0;
+  _key = "";
+  _builds = NULL;
+  _terms = NULL;
+  _postings = NULL;
+  _strings = NULL;
+  _nbuilds = 0;
+  _nterms = 0;
+  _npostings = 0;
+  _strings_len = 0;
+}
+
+/*******************************************************************************
+
+Whether an index is loaded and still matches the repository
+
+*******************************************************************************/
+bool ReadmeIndex::current() const
+{
+  RepoIndex repo_index;
+
+  if (_map == NULL) { return false; }
+  return (repo_index.computeKey() == _key);
+}
+
+/*******************************************************************************
+
+Gets term by index in term table, as a pointer into the mapped string blob and
+a length. Terms out of bounds are returned empty.
+
+*******************************************************************************/
+void ReadmeIndex::termAt(unsigned int idx, const char *& term,
+                         std::size_t & len) const
+{
+  readme_term rec;
+
+  std::memcpy(&rec, _terms + idx*sizeof(readme_term), sizeof(rec));
+  if (uint64_t(rec.term.offset) + rec.term.len > _strings_len)
+  {
+    term = _strings;
+    len = 0;
+  }
+  else
+  {
+    term = _strings + rec.term.offset;
+    len = rec.term.len;
+  }
+}
+
+/*******************************************************************************
+
+Compares term in the index with a string, like std::string::compare
+
+*******************************************************************************/
+int readme_compare(const char *term, std::size_t len, const std::string & str)
+{
+  int cmp;
+
+  cmp = std::memcmp(term, str.data(), std::min(len, str.size()));
+  if (cmp != 0) { return cmp; }
+  if (len < str.size()) { return -1; }
+  else if (len > str.size()) { return 1; }
+  else { return 0; }
+}
+
+/*******************************************************************************
+
+Finds term by bisection in the sorted term table. Returns 0 if found, 1 if not
+found.
+
+*******************************************************************************/
+int ReadmeIndex::findTerm(const std::string & term, unsigned int & idx) const
+{
+  unsigned int lbound, rbound, mid;
+  const char *midterm;
+  std::size_t midlen;
+  int cmp;
+
+  lbound = 0;
+  rbound = _nterms;
+  while (lbound < rbound)
+  {
+    mid = lbound + (rbound-lbound)/2;
+    termAt(mid, midterm, midlen);
+    cmp = readme_compare(midterm, midlen, term);
+    if (cmp == 0)
+    {
+      idx = mid;
+      return 0;
+    }
+    else if (cmp < 0) { lbound = mid+1; }
+    else { rbound = mid; }
+  }
+
+  return 1;
+}
+
+/*******************************************************************************
+
+Adds postings of a term to per-build counts
+
+*******************************************************************************/
+void ReadmeIndex::addPostings(unsigned int idx,
+                              std::vector<unsigned int> & counts) const
+{
+  readme_term rec;
+  readme_posting posting;
+  uint64_t k;
+
+  std::memcpy(&rec, _terms + idx*sizeof(readme_term), sizeof(rec));
+  for ( k = rec.first_posting;
+        (k < uint64_t(rec.first_posting) + rec.npostings) && (k < _npostings);
+        k++ )
+  {
+    std::memcpy(&posting, _postings + k*sizeof(readme_posting),
+                sizeof(posting));
+    if (posting.build < _nbuilds) { counts[posting.build] += posting.count; }
+  }
+}
+
+/*******************************************************************************
+
+Orders matches by number of occurrences, most first
+
+*******************************************************************************/
+bool readme_match_ranks_higher(const readme_match & match1,
+                               const readme_match & match2)
+{
+  return (match1.count > match2.count);
+}
+
+/*******************************************************************************
+
+Searches index for a pattern, returning matching SlackBuilds sorted by how many
+times matching words appear in the README (most first).
+
+Case-insensitive searches are exact: a whole-word search looks up the word, and
+a substring search without spaces checks each word in the index, since such a
+match cannot extend past a word. For patterns with spaces, every space-separated
+piece must be found within some word, and for case-sensitive searches, the
+lower-case pattern must match; these only give candidates. Returns 0 if the
+matches are exact, or 1 if they must still be checked with find_in_file.
+
+*******************************************************************************/
+int ReadmeIndex::search(const std::string & pattern, bool whole_word,
+                        bool case_sensitive,
+                        std::vector<readme_match> & matches) const
+{
+  std::vector<unsigned int> counts, piececounts;
+  std::vector<std::string> pieces;
+  std::string lowerpattern, piece;
+  const char *term;
+  std::size_t pos, next, len;
+  unsigned int i, j, npieces, idx;
+  readme_build rec;
+  readme_match match;
+  int retval;
+
+  matches.resize(0);
+  if (_map == NULL) { return 1; }
+
+  lowerpattern = pattern;
+  for ( pos = 0; pos < lowerpattern.size(); pos++ )
+  {
+    lowerpattern[pos] = std::tolower(lowerpattern[pos]);
+  }
+  retval = case_sensitive ? 1 : 0;
+
+  counts.assign(_nbuilds, 0);
+  if (whole_word)
+  {
+    // Words never contain spaces, so such a pattern cannot match
+
+    if (lowerpattern.find(' ') != std::string::npos) { return 0; }
+    if (findTerm(lowerpattern, idx) == 0) { addPostings(idx, counts); }
+  }
+  else
+  {
+    pos = 0;
+    while (pos <= lowerpattern.size())
+    {
+      next = lowerpattern.find(' ', pos);
+      if (next == std::string::npos) { next = lowerpattern.size(); }
+      if (next > pos) { pieces.push_back(lowerpattern.substr(pos, next-pos)); }
+      pos = next+1;
+    }
+    npieces = pieces.size();
+    if ( (npieces != 1) || (lowerpattern.find(' ') != std::string::npos) )
+      retval = 1;
+    if (npieces == 0) { counts.assign(_nbuilds, 1); }
+
+    for ( j = 0; j < npieces; j++ )
+    {
+      piececounts.assign(_nbuilds, 0);
+      for ( i = 0; i < _nterms; i++ )
+      {
+        termAt(i, term, len);
+        if (std::search(term, term+len, pieces[j].begin(), pieces[j].end())
+            != term+len)
+          addPostings(i, piececounts);
+      }
+      for ( i = 0; i < _nbuilds; i++ )
+      {
+        if (j == 0) { counts[i] = piececounts[i]; }
+        else if (piececounts[i] == 0) { counts[i] = 0; }
+        else if (counts[i] > 0) { counts[i] += piececounts[i]; }
+      }
+    }
+  }
+
+  // Collect and rank matches
+
+  for ( i = 0; i < _nbuilds; i++ )
+  {
+    if (counts[i] == 0) { continue; }
+    std::memcpy(&rec, _builds + i*sizeof(readme_build), sizeof(rec));
+    if ( (uint64_t(rec.category.offset) + rec.category.len > _strings_len) ||
+         (uint64_t(rec.name.offset) + rec.name.len > _strings_len) )
+      continue;
+    match.category.assign(_strings + rec.category.offset, rec.category.len);
+    match.name.assign(_strings + rec.name.offset, rec.name.len);
+    match.count = counts[i];
+    matches.push_back(match);
+  }
+  std::stable_sort(matches.begin(), matches.end(), readme_match_ranks_higher);
+
+  return retval;
+}
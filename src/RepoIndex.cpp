@@ -0,0 +1,373 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>    // sort
+#include <cstdio>       // rename, remove
+#include <cstring>      // memcpy, memcmp
+#include <stdint.h>
+#include <dirent.h>
+#include <fcntl.h>      // open
+#include <unistd.h>     // close
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>
+#include "string_util.h"
+#include "settings.h"   // repo_dir
+#include "BuildListItem.h"
+#include "index_util.h"
+#include "RepoIndex.h"
+
+/*******************************************************************************
+
+On-disk layout. All integers are stored in native byte order, since the index
+is a local cache and is simply rebuilt if it cannot be read. The file consists
+of the header, the key, the category table, the build table, and finally a
+blob holding all strings. Offsets in the tables are relative to the start of
+the string blob.
+
+*******************************************************************************/
+const char index_magic[8] = {'S','B','O','U','I','I','D','X'};
+const uint32_t index_version = 1;
+
+struct index_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_len;
+  uint32_t ncategories;
+  uint32_t nbuilds;
+  uint64_t strings_len;
+};
+
+struct index_category {
+  index_string name;
+  uint32_t first_build;
+  uint32_t nbuilds;
+};
+
+struct index_build {
+  index_string name;
+  index_string version;
+  index_string reqs;
+  index_string buildnum;
+  int32_t check;
+};
+
+/*******************************************************************************
+
+Reads first line of a small file. Returns empty string if it can't be read.
+
+*******************************************************************************/
+std::string index_read_first_line(const std::string & path)
+{
+  std::ifstream file;
+  std::string line;
+
+  file.open(path.c_str());
+  if (! file.is_open()) { return ""; }
+  std::getline(file, line);
+  file.close();
+
+  return trim(line);
+}
+
+/*******************************************************************************
+
+Gets git commit checked out in repository, or empty string if the repository
+is not a git repository
+
+*******************************************************************************/
+std::string index_git_head(const std::string & repo)
+{
+  std::string head, ref, commit, line;
+  std::ifstream packed;
+  std::size_t len;
+
+  head = index_read_first_line(repo + "/.git/HEAD");
+  if (head.substr(0, 5) != "ref: ") { return head; }
+
+  // Loose ref, or else look it up in packed-refs
+
+  ref = head.substr(5);
+  commit = index_read_first_line(repo + "/.git/" + ref);
+  if (commit != "") { return commit; }
+
+  packed.open((repo + "/.git/packed-refs").c_str());
+  if (! packed.is_open()) { return head; }
+  len = ref.size();
+  while (std::getline(packed, line))
+  {
+    line = trim(line);
+    if ( (line.size() > len+1) && (line.substr(line.size()-len) == ref) )
+    {
+      commit = line.substr(0, line.size()-len-1);
+      break;
+    }
+  }
+  packed.close();
+
+  return head + " " + commit;
+}
+
+/*******************************************************************************
+
+Gets modification time of a path as string, or empty string on error
+
+*******************************************************************************/
+std::string index_mtime_string(const std::string & path)
+{
+  struct stat sb;
+  std::stringstream ss;
+
+  if (stat(path.c_str(), &sb) != 0) { return ""; }
+  ss << sb.st_mtim.tv_sec << "." << sb.st_mtim.tv_nsec;
+
+  return ss.str();
+}
+
+/*******************************************************************************
+
+Computes key describing the current state of the repository. Any sync through
+sboui updates /var/lib/sboui/last-sync.txt, git pulls change HEAD, and adding
+or removing SlackBuilds changes the mtime of the category directories.
+
+*******************************************************************************/
+std::string RepoIndex::computeKey() const
+{
+  DIR *pdir;
+  struct dirent *pent;
+  std::vector<std::string> subdirs;
+  std::string key, name;
+  unsigned int i, nsubdirs;
+
+  key = settings::repo_dir + "\n";
+  key += index_git_head(settings::repo_dir) + "\n";
+  key += index_mtime_string("/var/lib/sboui/last-sync.txt") + "\n";
+  key += index_mtime_string(settings::repo_dir) + "\n";
+
+  pdir = opendir(settings::repo_dir.c_str());
+  if (pdir == NULL) { return ""; }
+  while ((pent = readdir(pdir)))
+  {
+    name = pent->d_name;
+    if (name[0] == '.') { continue; }
+    subdirs.push_back(name);
+  }
+  closedir(pdir);
+  std::sort(subdirs.begin(), subdirs.end());
+
+  nsubdirs = subdirs.size();
+  for ( i = 0; i < nsubdirs; i++ )
+  {
+    key += subdirs[i] + " "
+         + index_mtime_string(settings::repo_dir + "/" + subdirs[i]) + "\n";
+  }
+
+  return key;
+}
+
+/*******************************************************************************
+
+Constructors
+
+*******************************************************************************/
+RepoIndex::RepoIndex() { _path = "/var/lib/sboui/repo.index"; }
+RepoIndex::RepoIndex(const std::string & path) { _path = path; }
+
+/*******************************************************************************
+
+Location of index file
+
+*******************************************************************************/
+void RepoIndex::setPath(const std::string & path) { _path = path; }
+const std::string & RepoIndex::path() const { return _path; }
+
+/*******************************************************************************
+
+Returns true if the index file can be written (i.e., its directory exists and
+is writable)
+
+*******************************************************************************/
+bool RepoIndex::writable() const { return index_writable(_path); }
+
+/*******************************************************************************
+
+Maps index file and loads SlackBuilds from it. Returns 0 on success, 1 if the
+index file is missing or unreadable, 2 if it is stale, or 3 if it is corrupt.
+
+*******************************************************************************/
+int RepoIndex::load(
+               std::vector<std::vector<BuildListItem> > & slackbuilds) const
+{
+  int fd, retval;
+  struct stat sb;
+  void *map;
+  const char *data, *pos, *blob;
+  uint64_t size, tables_len, nblob;
+  index_header header;
+  index_category cat;
+  index_build rec;
+  std::string category, name, version, reqs, buildnum;
+  unsigned int i, j;
+
+  fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0) { return 1; }
+  if ( (fstat(fd, &sb) != 0) || (sb.st_size < off_t(sizeof(header))) )
+  {
+    close(fd);
+    return 1;
+  }
+  size = sb.st_size;
+  map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) { return 1; }
+  data = static_cast<const char *>(map);
+
+  // Check header and key
+
+  retval = 0;
+  std::memcpy(&header, data, sizeof(header));
+  tables_len = uint64_t(header.ncategories)*sizeof(index_category)
+             + uint64_t(header.nbuilds)*sizeof(index_build);
+  if ( (std::memcmp(header.magic, index_magic, sizeof(index_magic)) != 0) ||
+       (header.version != index_version) ||
+       (sizeof(header) + header.key_len + tables_len + header.strings_len
+        != size) )
+    retval = 3;
+  else if (std::string(data + sizeof(header), header.key_len) != computeKey())
+    retval = 2;
+  if (retval != 0)
+  {
+    munmap(map, size);
+    return retval;
+  }
+
+  // Read categories and SlackBuilds
+
+  pos = data + sizeof(header) + header.key_len;
+  blob = pos + tables_len;
+  nblob = header.strings_len;
+  slackbuilds.resize(0);
+  for ( i = 0; i < header.ncategories; i++ )
+  {
+    std::memcpy(&cat, pos + i*sizeof(index_category), sizeof(cat));
+    if ( (index_get_string(blob, nblob, cat.name, category) != 0) ||
+         (uint64_t(cat.first_build) + cat.nbuilds > header.nbuilds) )
+    {
+      retval = 3;
+      break;
+    }
+
+    std::vector<BuildListItem> cat_builds(cat.nbuilds);
+    for ( j = 0; j < cat.nbuilds; j++ )
+    {
+      std::memcpy(&rec, pos + header.ncategories*sizeof(index_category)
+                            + (cat.first_build+j)*sizeof(index_build),
+                  sizeof(rec));
+      if ( (index_get_string(blob, nblob, rec.name, name) != 0) ||
+           (index_get_string(blob, nblob, rec.version, version) != 0) ||
+           (index_get_string(blob, nblob, rec.reqs, reqs) != 0) ||
+           (index_get_string(blob, nblob, rec.buildnum, buildnum) != 0) )
+      {
+        retval = 3;
+        break;
+      }
+      cat_builds[j].setName(name);
+      cat_builds[j].setProp("category", category);
+      cat_builds[j].setRepoInfo(version, reqs, buildnum, rec.check);
+    }
+    if (retval != 0) { break; }
+    slackbuilds.push_back(cat_builds);
+  }
+  munmap(map, size);
+
+  if (retval != 0) { slackbuilds.resize(0); }
+
+  return retval;
+}
+
+/*******************************************************************************
+
+Writes index file. The file is written to a temporary location first and then
+renamed, so readers never see a partially written index. Repo info must already
+have been read for every SlackBuild. Returns 0 on success or 1 on error.
+
+*******************************************************************************/
+int RepoIndex::write(
+                  const std::vector<std::vector<BuildListItem> > & slackbuilds,
+                  const std::vector<std::string> & categories) const
+{
+  std::ofstream file;
+  std::string key, blob, tmppath;
+  std::vector<index_category> cattable;
+  std::vector<index_build> buildtable;
+  index_header header;
+  unsigned int i, j, ncategories, nbuilds;
+
+  if (categories.size() != slackbuilds.size()) { return 1; }
+  key = computeKey();
+  if (key == "") { return 1; }
+
+  // Set up tables
+
+  ncategories = slackbuilds.size();
+  cattable.resize(ncategories);
+  for ( i = 0; i < ncategories; i++ )
+  {
+    cattable[i].name = index_add_string(blob, categories[i]);
+    cattable[i].first_build = buildtable.size();
+    cattable[i].nbuilds = slackbuilds[i].size();
+    nbuilds = slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      const BuildListItem & build = slackbuilds[i][j];
+      index_build rec;
+
+      if (build.repoInfoCheck() < 0) { return 1; }
+      rec.name = index_add_string(blob, build.name());
+      rec.version = index_add_string(blob,
+                                     build.getProp("available_version"));
+      rec.reqs = index_add_string(blob, build.getProp("requires"));
+      rec.buildnum = index_add_string(blob, build.getProp("available_buildnum"));
+      rec.check = build.repoInfoCheck();
+      buildtable.push_back(rec);
+    }
+  }
+
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, index_magic, sizeof(index_magic));
+  header.version = index_version;
+  header.key_len = key.size();
+  header.ncategories = cattable.size();
+  header.nbuilds = buildtable.size();
+  header.strings_len = blob.size();
+
+  // Write to temporary file and move into place
+
+  tmppath = _path + ".tmp";
+  file.open(tmppath.c_str(), std::ios::out | std::ios::binary |
+                             std::ios::trunc);
+  if (! file.is_open()) { return 1; }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(key.data(), key.size());
+  if (cattable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&cattable[0]),
+               cattable.size()*sizeof(index_category));
+  if (buildtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&buildtable[0]),
+               buildtable.size()*sizeof(index_build));
+  file.write(blob.data(), blob.size());
+  file.close();
+  if (file.fail())
+  {
+    std::remove(tmppath.c_str());
+    return 1;
+  }
+
+  if (std::rename(tmppath.c_str(), _path.c_str()) != 0)
+  {
+    std::remove(tmppath.c_str());
+    return 1;
+  }
+
+  return 0;
+}
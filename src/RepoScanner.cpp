@@ -0,0 +1,155 @@
+#include <string>
+#include <vector>
+#include <algorithm>    // sort
+#include <dirent.h>
+#include <fcntl.h>      // openat
+#include <unistd.h>     // close
+#include <sys/stat.h>
+#include "settings.h"   // repo_dir
+#include "RepoScanner.h"
+
+/*******************************************************************************
+
+Directory entry types that the scanner distinguishes
+
+*******************************************************************************/
+enum repo_entry_type { REPO_ENTRY_DIR, REPO_ENTRY_OTHER, REPO_ENTRY_UNKNOWN };
+
+/*******************************************************************************
+
+Gets entry type from dirent. Like DirListing, entries of unknown type are
+checked with stat (following symlinks) instead.
+
+*******************************************************************************/
+repo_entry_type repo_entry_type_from_dirent(int dirfd, const dirent *pent)
+{
+  struct stat sb;
+
+  switch (pent->d_type) {
+    case DT_DIR:
+      return REPO_ENTRY_DIR;
+    case DT_UNKNOWN:
+      if (fstatat(dirfd, pent->d_name, &sb, 0) != 0)
+        return REPO_ENTRY_UNKNOWN;
+      if (S_ISDIR(sb.st_mode)) { return REPO_ENTRY_DIR; }
+      else { return REPO_ENTRY_OTHER; }
+    default:
+      return REPO_ENTRY_OTHER;
+  }
+}
+
+/*******************************************************************************
+
+Lists non-hidden subdirectories of the directory name, relative to parentfd,
+sorted by name. Returns 1 if the directory cannot be read; 0 otherwise.
+
+*******************************************************************************/
+int repo_list_subdirs(int parentfd, const std::string & name,
+                      std::vector<std::string> & subdirs)
+{
+  int fd;
+  DIR *pdir;
+  struct dirent *pent;
+
+  subdirs.resize(0);
+
+  fd = openat(parentfd, name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) { return 1; }
+  pdir = fdopendir(fd);
+  if (pdir == NULL)
+  {
+    close(fd);
+    return 1;
+  }
+
+  while ((pent = readdir(pdir)))
+  {
+    if (pent->d_name[0] == '.') { continue; }
+    if (repo_entry_type_from_dirent(fd, pent) == REPO_ENTRY_DIR)
+      subdirs.push_back(pent->d_name);
+  }
+  closedir(pdir);   // Also closes fd
+
+  std::sort(subdirs.begin(), subdirs.end());
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Constructors
+
+*******************************************************************************/
+RepoScanner::RepoScanner()
+{
+  _path = settings::repo_dir;
+  _max_threads = 16;
+}
+
+RepoScanner::RepoScanner(const std::string & path)
+{
+  _path = path;
+  _max_threads = 16;
+}
+
+/*******************************************************************************
+
+Set repository directory and maximum number of threads. Reading directories is
+mostly I/O bound, especially on network filesystems, so the default allows more
+threads than there are cores on most machines.
+
+*******************************************************************************/
+void RepoScanner::setPath(const std::string & path) { _path = path; }
+void RepoScanner::setMaxThreads(int max_threads)
+{
+  if (max_threads < 1) { _max_threads = 1; }
+  else { _max_threads = max_threads; }
+}
+
+/*******************************************************************************
+
+Scans repository. Categories with no SlackBuilds are skipped. Returns 0 on
+success, 1 if the repository directory cannot be read.
+
+*******************************************************************************/
+int RepoScanner::scan(std::vector<repo_category> & categories) const
+{
+  int repofd, i, ncategories, nthreads;
+  std::vector<std::string> catnames;
+  std::vector<repo_category> scanned;
+  unsigned int j, nscanned;
+
+  categories.resize(0);
+
+  repofd = open(_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (repofd < 0) { return 1; }
+  if (repo_list_subdirs(repofd, ".", catnames) != 0)
+  {
+    close(repofd);
+    return 1;
+  }
+
+  // Scan categories in parallel
+
+  ncategories = catnames.size();
+  scanned.resize(ncategories);
+  nthreads = std::min(_max_threads, std::max(ncategories, 1));
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+  for ( i = 0; i < ncategories; i++ )
+  {
+    scanned[i].name = catnames[i];
+    repo_list_subdirs(repofd, catnames[i], scanned[i].builds);
+  }
+  close(repofd);
+
+  nscanned = scanned.size();
+  for ( j = 0; j < nscanned; j++ )
+  {
+    if (scanned[j].builds.size() == 0) { continue; }
+    categories.push_back(repo_category());
+    categories.back().name.swap(scanned[j].name);
+    categories.back().builds.swap(scanned[j].builds);
+  }
+
+  return 0;
+}
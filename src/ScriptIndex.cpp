@@ -0,0 +1,591 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>    // sort, unique, set_intersection
+#include <iterator>     // back_inserter
+#include <cstdio>       // rename, remove
+#include <cstring>      // memcpy, memcmp, memset
+#include <stdint.h>
+#include <fcntl.h>      // open
+#include <unistd.h>     // close
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>
+#include "settings.h"   // repo_dir
+#include "index_util.h"
+#include "RepoIndex.h"
+#include "RepoScanner.h"
+#include "ScriptSearch.h"
+#include "ScriptIndex.h"
+
+/*******************************************************************************
+
+On-disk layout, following RepoIndex: header, key, build table, trigram table
+(sorted by trigram), postings, and a blob holding all strings. Each trigram
+refers to a range of postings, which are build table entries in increasing
+order.
+
+*******************************************************************************/
+const char script_magic[8] = {'S','B','O','U','I','T','R','G'};
+const uint32_t script_version = 1;
+
+struct script_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_len;
+  uint32_t nbuilds;
+  uint32_t ntrigrams;
+  uint64_t npostings;
+  uint64_t strings_len;
+};
+
+struct script_build {
+  index_string category;
+  index_string name;
+  uint64_t signature;
+};
+
+struct script_trigram {
+  uint32_t trigram;
+  uint32_t first_posting;
+  uint32_t npostings;
+};
+
+/*******************************************************************************
+
+Signature of the files in a SlackBuild directory (FNV-1a hash of their paths,
+sizes, and modification times)
+
+*******************************************************************************/
+uint64_t script_signature(const std::vector<build_file> & files)
+{
+  uint64_t hash, size, sec, nsec;
+  unsigned int i, nfiles;
+
+  hash = index_hash_basis;
+  nfiles = files.size();
+  for ( i = 0; i < nfiles; i++ )
+  {
+    size = files[i].size;
+    sec = files[i].mtime_sec;
+    nsec = files[i].mtime_nsec;
+    index_hash_bytes(hash, files[i].path.c_str(), files[i].path.size()+1);
+    index_hash_bytes(hash, &size, sizeof(size));
+    index_hash_bytes(hash, &sec, sizeof(sec));
+    index_hash_bytes(hash, &nsec, sizeof(nsec));
+  }
+
+  return hash;
+}
+
+/*******************************************************************************
+
+Adds trigrams in text to a list. ASCII letters are converted to lower case, and
+trigrams spanning lines are skipped, since patterns are matched line by line.
+
+*******************************************************************************/
+uint32_t script_trigram_byte(char c)
+{
+  if ( (c >= 'A') && (c <= 'Z') ) { c = c - 'A' + 'a'; }
+  return (unsigned char)(c);
+}
+
+void script_add_trigrams(const std::string & text,
+                         std::vector<uint32_t> & trigrams)
+{
+  std::size_t i, len;
+  uint32_t trigram;
+
+  len = text.size();
+  if (len < 3) { return; }
+  trigram = (script_trigram_byte(text[0]) << 8) | script_trigram_byte(text[1]);
+  for ( i = 2; i < len; i++ )
+  {
+    trigram = ((trigram << 8) | script_trigram_byte(text[i])) & 0xffffff;
+    if ( (text[i] == '\n') || (text[i-1] == '\n') || (text[i-2] == '\n') )
+      continue;
+    trigrams.push_back(trigram);
+  }
+}
+
+/*******************************************************************************
+
+Constructors and destructor
+
+*******************************************************************************/
+ScriptIndex::ScriptIndex()
+{
+  _path = "/var/lib/sboui/script.index";
+  _map = NULL;
+  _size = 0;
+}
+
+ScriptIndex::ScriptIndex(const std::string & path)
+{
+  _path = path;
+  _map = NULL;
+  _size = 0;
+}
+
+ScriptIndex::~ScriptIndex() { unload(); }
+
+/*******************************************************************************
+
+Location of index file
+
+*******************************************************************************/
+void ScriptIndex::setPath(const std::string & path) { _path = path; }
+const std::string & ScriptIndex::path() const { return _path; }
+
+/*******************************************************************************
+
+Returns true if the index file can be written (i.e., its directory exists and
+is writable)
+
+*******************************************************************************/
+bool ScriptIndex::writable() const { return index_writable(_path); }
+
+/*******************************************************************************
+
+Writes index file. Trigrams of SlackBuilds whose signature is the same as in
+the existing index file are taken from it; other SlackBuilds are read in
+parallel. The file is written to a temporary location first and then renamed.
+Returns 0 on success or 1 on error.
+
+*******************************************************************************/
+int ScriptIndex::build() const
+{
+  RepoScanner scanner(settings::repo_dir);
+  RepoIndex repo_index;
+  ScriptIndex old_index(_path);
+  std::vector<repo_category> categories;
+  std::vector<script_build> buildtable;
+  std::vector<std::string> keys;
+  std::vector<std::vector<uint32_t> > trigrams;
+  std::vector<uint64_t> signatures, pairs;
+  std::vector<int> old_ids, reused;
+  std::vector<uint32_t> old_builds, postingtable;
+  std::vector<script_trigram> trigramtable;
+  std::unordered_map<std::string, unsigned int> old_lookup;
+  std::unordered_map<std::string, unsigned int>::const_iterator it;
+  std::string key, blob, tmppath;
+  std::ofstream file;
+  script_header header;
+  script_trigram rec;
+  unsigned int i, j, ncategories, nbuilds, nold;
+  uint64_t p, npairs;
+  int k, nkeys;
+
+  key = repo_index.computeKey();
+  if (key == "") { return 1; }
+  if (scanner.scan(categories) != 0) { return 1; }
+
+  // Build table
+
+  ncategories = categories.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = categories[i].builds.size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      script_build sbuild;
+
+      sbuild.category = index_add_string(blob, categories[i].name);
+      sbuild.name = index_add_string(blob, categories[i].builds[j]);
+      sbuild.signature = 0;
+      buildtable.push_back(sbuild);
+      keys.push_back(categories[i].name + "/" + categories[i].builds[j]);
+    }
+  }
+  nkeys = keys.size();
+
+  // Existing index, even if stale
+
+  old_ids.assign(nkeys, -1);
+  if (old_index.map(false) == 0)
+  {
+    nold = old_index._nbuilds;
+    for ( i = 0; i < nold; i++ )
+    {
+      old_lookup[old_index.buildKey(i)] = i;
+    }
+    for ( k = 0; k < nkeys; k++ )
+    {
+      it = old_lookup.find(keys[k]);
+      if (it != old_lookup.end()) { old_ids[k] = it->second; }
+    }
+  }
+
+  // Compute signatures and read SlackBuilds that changed
+
+  signatures.assign(nkeys, 0);
+  trigrams.resize(nkeys);
+  reused.assign(nkeys, 0);
+#pragma omp parallel for schedule(dynamic,16)
+  for ( k = 0; k < nkeys; k++ )
+  {
+    std::vector<build_file> files;
+    std::string builddir;
+    unsigned int f, nfiles;
+
+    builddir = settings::repo_dir + "/" + keys[k];
+    if (list_build_files(builddir, files) != 0) { continue; }
+    signatures[k] = script_signature(files);
+    if ( (old_ids[k] >= 0) &&
+         (old_index.signatureAt(old_ids[k]) == signatures[k]) )
+    {
+      reused[k] = 1;
+      continue;
+    }
+
+    nfiles = files.size();
+    for ( f = 0; f < nfiles; f++ )
+    {
+      std::ifstream contents((builddir + "/" + files[f].path).c_str());
+      std::stringstream ss;
+
+      if (! contents.is_open()) { continue; }
+      ss << contents.rdbuf();
+      script_add_trigrams(ss.str(), trigrams[k]);
+    }
+    std::sort(trigrams[k].begin(), trigrams[k].end());
+    trigrams[k].erase(std::unique(trigrams[k].begin(), trigrams[k].end()),
+                      trigrams[k].end());
+  }
+
+  // Take trigrams of unchanged SlackBuilds from existing index
+
+  for ( k = 0; k < nkeys; k++ )
+  {
+    buildtable[k].signature = signatures[k];
+    if (reused[k]) { continue; }
+    old_ids[k] = -1;
+  }
+  if (old_index._map != NULL)
+  {
+    std::vector<int> new_ids(old_index._nbuilds, -1);
+
+    for ( k = 0; k < nkeys; k++ )
+    {
+      if (old_ids[k] >= 0) { new_ids[old_ids[k]] = k; }
+    }
+    for ( i = 0; i < old_index._ntrigrams; i++ )
+    {
+      std::memcpy(&rec, old_index._trigrams + i*sizeof(script_trigram),
+                  sizeof(rec));
+      old_index.postingsAt(i, old_builds);
+      for ( j = 0; j < old_builds.size(); j++ )
+      {
+        if (new_ids[old_builds[j]] >= 0)
+          trigrams[new_ids[old_builds[j]]].push_back(rec.trigram);
+      }
+    }
+    old_index.unload();
+  }
+
+  // Invert: sort (trigram, build) pairs
+
+  for ( k = 0; k < nkeys; k++ )
+  {
+    for ( j = 0; j < trigrams[k].size(); j++ )
+    {
+      pairs.push_back((uint64_t(trigrams[k][j]) << 32) | uint64_t(k));
+    }
+    std::vector<uint32_t>().swap(trigrams[k]);
+  }
+  std::sort(pairs.begin(), pairs.end());
+
+  npairs = pairs.size();
+  postingtable.resize(npairs);
+  for ( p = 0; p < npairs; p++ )
+  {
+    postingtable[p] = uint32_t(pairs[p] & 0xffffffff);
+    if ( (p == 0) || ((pairs[p] >> 32) != (pairs[p-1] >> 32)) )
+    {
+      rec.trigram = uint32_t(pairs[p] >> 32);
+      rec.first_posting = p;
+      rec.npostings = 0;
+      trigramtable.push_back(rec);
+    }
+    trigramtable.back().npostings++;
+  }
+
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, script_magic, sizeof(script_magic));
+  header.version = script_version;
+  header.key_len = key.size();
+  header.nbuilds = buildtable.size();
+  header.ntrigrams = trigramtable.size();
+  header.npostings = postingtable.size();
+  header.strings_len = blob.size();
+
+  // Write to temporary file and move into place
+
+  tmppath = _path + ".tmp";
+  file.open(tmppath.c_str(), std::ios::out | std::ios::binary |
+                             std::ios::trunc);
+  if (! file.is_open()) { return 1; }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(key.data(), key.size());
+  if (buildtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&buildtable[0]),
+               buildtable.size()*sizeof(script_build));
+  if (trigramtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&trigramtable[0]),
+               trigramtable.size()*sizeof(script_trigram));
+  if (postingtable.size() > 0)
+    file.write(reinterpret_cast<const char *>(&postingtable[0]),
+               postingtable.size()*sizeof(uint32_t));
+  file.write(blob.data(), blob.size());
+  file.close();
+  if (file.fail())
+  {
+    std::remove(tmppath.c_str());
+    return 1;
+  }
+
+  if (std::rename(tmppath.c_str(), _path.c_str()) != 0)
+  {
+    std::remove(tmppath.c_str());
+    return 1;
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Maps index file. Returns 0 on success, 1 if the index file is missing or
+unreadable, 2 if it is stale (only checked if requested), or 3 if it is
+corrupt.
+
+*******************************************************************************/
+int ScriptIndex::map(bool check_key)
+{
+  RepoIndex repo_index;
+  int fd, retval;
+  struct stat sb;
+  const char *data;
+  script_header header;
+  uint64_t tables_len;
+  std::string key;
+
+  unload();
+
+  fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0) { return 1; }
+  if ( (fstat(fd, &sb) != 0) || (sb.st_size < off_t(sizeof(header))) )
+  {
+    close(fd);
+    return 1;
+  }
+  _size = sb.st_size;
+  _map = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (_map == MAP_FAILED)
+  {
+    _map = NULL;
+    return 1;
+  }
+  data = static_cast<const char *>(_map);
+
+  // Check header and key
+
+  retval = 0;
+  std::memcpy(&header, data, sizeof(header));
+  tables_len = uint64_t(header.nbuilds)*sizeof(script_build)
+             + uint64_t(header.ntrigrams)*sizeof(script_trigram)
+             + header.npostings*sizeof(uint32_t);
+  if (check_key) { key = repo_index.computeKey(); }
+  if ( (std::memcmp(header.magic, script_magic, sizeof(script_magic)) != 0) ||
+       (header.version != script_version) ||
+       (sizeof(header) + header.key_len + tables_len + header.strings_len
+        != _size) )
+    retval = 3;
+  else if ( (check_key) && ( (key == "") ||
+            (std::string(data + sizeof(header), header.key_len) != key) ) )
+    retval = 2;
+  if (retval != 0)
+  {
+    unload();
+    return retval;
+  }
+
+  _key = std::string(data + sizeof(header), header.key_len);
+  _nbuilds = header.nbuilds;
+  _ntrigrams = header.ntrigrams;
+  _npostings = header.npostings;
+  _strings_len = header.strings_len;
+  _builds = data + sizeof(header) + header.key_len;
+  _trigrams = _builds + _nbuilds*sizeof(script_build);
+  _postings = _trigrams + _ntrigrams*sizeof(script_trigram);
+  _strings = _postings + _npostings*sizeof(uint32_t);
+
+  return 0;
+}
+
+int ScriptIndex::load() { return map(true); }
+
+void ScriptIndex::unload()
+{
+  if (_map != NULL) { munmap(_map, _size); }
+  _map = NULL;
+  _size = 0;
+  _key = "";
+  _builds = NULL;
+  _trigrams = NULL;
+  _postings = NULL;
+  _strings = NULL;
+  _nbuilds = 0;
+  _ntrigrams = 0;
+  _npostings = 0;
+  _strings_len = 0;
+}
+
+/*******************************************************************************
+
+Whether an index is loaded and still matches the repository
+
+*******************************************************************************/
+bool ScriptIndex::current() const
+{
+  RepoIndex repo_index;
+
+  if (_map == NULL) { return false; }
+  return (repo_index.computeKey() == _key);
+}
+
+/*******************************************************************************
+
+Gets category/name and signature of an entry in the build table. Strings out of
+bounds are returned empty.
+
+*******************************************************************************/
+std::string ScriptIndex::buildKey(unsigned int idx) const
+{
+  script_build rec;
+
+  std::memcpy(&rec, _builds + idx*sizeof(script_build), sizeof(rec));
+  if ( (uint64_t(rec.category.offset) + rec.category.len > _strings_len) ||
+       (uint64_t(rec.name.offset) + rec.name.len > _strings_len) )
+    return "";
+
+  return std::string(_strings + rec.category.offset, rec.category.len) + "/"
+       + std::string(_strings + rec.name.offset, rec.name.len);
+}
+
+uint64_t ScriptIndex::signatureAt(unsigned int idx) const
+{
+  script_build rec;
+
+  std::memcpy(&rec, _builds + idx*sizeof(script_build), sizeof(rec));
+
+  return rec.signature;
+}
+
+/*******************************************************************************
+
+Finds trigram by bisection in the sorted trigram table. Returns 0 if found, 1
+if not found.
+
+*******************************************************************************/
+int ScriptIndex::findTrigram(uint32_t trigram, unsigned int & idx) const
+{
+  unsigned int lbound, rbound, mid;
+  script_trigram rec;
+
+  lbound = 0;
+  rbound = _ntrigrams;
+  while (lbound < rbound)
+  {
+    mid = lbound + (rbound-lbound)/2;
+    std::memcpy(&rec, _trigrams + mid*sizeof(script_trigram), sizeof(rec));
+    if (rec.trigram == trigram)
+    {
+      idx = mid;
+      return 0;
+    }
+    else if (rec.trigram < trigram) { lbound = mid+1; }
+    else { rbound = mid; }
+  }
+
+  return 1;
+}
+
+/*******************************************************************************
+
+Gets postings of an entry in the trigram table. Entries out of bounds are
+skipped.
+
+*******************************************************************************/
+void ScriptIndex::postingsAt(unsigned int idx,
+                             std::vector<uint32_t> & builds) const
+{
+  script_trigram rec;
+  uint32_t build;
+  uint64_t k;
+
+  builds.resize(0);
+  std::memcpy(&rec, _trigrams + idx*sizeof(script_trigram), sizeof(rec));
+  for ( k = rec.first_posting;
+        (k < uint64_t(rec.first_posting) + rec.npostings) && (k < _npostings);
+        k++ )
+  {
+    std::memcpy(&build, _postings + k*sizeof(uint32_t), sizeof(build));
+    if (build < _nbuilds) { builds.push_back(build); }
+  }
+}
+
+/*******************************************************************************
+
+SlackBuilds whose files contain every trigram of the strings that a match
+must contain
+
+*******************************************************************************/
+int ScriptIndex::candidates(const ScriptSearch & query,
+                            std::vector<std::string> & builds) const
+{
+  std::vector<std::string> strs;
+  std::vector<uint32_t> needed, result, postings, intersection;
+  unsigned int i, j, idx, nstrs;
+
+  builds.resize(0);
+  query.requiredStrings(strs);
+  nstrs = strs.size();
+  for ( i = 0; i < nstrs; i++ )
+  {
+    script_add_trigrams(strs[i], needed);
+  }
+  std::sort(needed.begin(), needed.end());
+  needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+
+  // Intersect postings of each trigram
+
+  for ( i = 0; i < needed.size(); i++ )
+  {
+    if (findTrigram(needed[i], idx) != 0) { return 0; }
+    postingsAt(idx, postings);
+    if (i == 0) { result.swap(postings); }
+    else
+    {
+      intersection.resize(0);
+      std::set_intersection(result.begin(), result.end(), postings.begin(),
+                            postings.end(), std::back_inserter(intersection));
+      result.swap(intersection);
+    }
+    if (result.size() == 0) { return 0; }
+  }
+
+  if (needed.size() == 0)
+  {
+    for ( j = 0; j < _nbuilds; j++ ) { builds.push_back(buildKey(j)); }
+    return 1;
+  }
+  for ( j = 0; j < result.size(); j++ )
+  {
+    builds.push_back(buildKey(result[j]));
+  }
+
+  return 0;
+}
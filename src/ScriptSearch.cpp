@@ -0,0 +1,389 @@
+#include <string>
+#include <vector>
+#include <regex>
+#include <fstream>
+#include <sstream>
+#include <algorithm>    // sort
+#include <dirent.h>
+#include <sys/stat.h>
+#include "string_util.h"   // string_to_lower
+#include "ScriptSearch.h"
+
+/*******************************************************************************
+
+Helpers for lower-case literals and whole-word checks. Only ASCII letters are
+converted, the same as for trigrams in ScriptIndex.
+
+*******************************************************************************/
+char script_ascii_lower(char c)
+{
+  if ( (c >= 'A') && (c <= 'Z') ) { return c - 'A' + 'a'; }
+  return c;
+}
+
+bool script_word_char(char c)
+{
+  return ( ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+           ((c >= '0') && (c <= '9')) || (c == '_') );
+}
+
+/*******************************************************************************
+
+Lists files in a directory recursively
+
+*******************************************************************************/
+void list_files_recursive(const std::string & dir, const std::string & prefix,
+                          std::vector<build_file> & files)
+{
+  DIR *pdir;
+  struct dirent *pent;
+  struct stat sb;
+  std::vector<std::string> names;
+  std::string path;
+  build_file file;
+  unsigned int i, nnames;
+
+  pdir = opendir(dir.c_str());
+  if (pdir == NULL) { return; }
+  while ((pent = readdir(pdir)))
+  {
+    if (pent->d_name[0] == '.') { continue; }
+    names.push_back(pent->d_name);
+  }
+  closedir(pdir);
+  std::sort(names.begin(), names.end());
+
+  nnames = names.size();
+  for ( i = 0; i < nnames; i++ )
+  {
+    path = dir + "/" + names[i];
+    if (lstat(path.c_str(), &sb) != 0) { continue; }
+    if (S_ISDIR(sb.st_mode))
+      list_files_recursive(path, prefix + names[i] + "/", files);
+    else if (S_ISREG(sb.st_mode))
+    {
+      file.path = prefix + names[i];
+      file.size = sb.st_size;
+      file.mtime_sec = sb.st_mtim.tv_sec;
+      file.mtime_nsec = sb.st_mtim.tv_nsec;
+      files.push_back(file);
+    }
+  }
+}
+
+int list_build_files(const std::string & builddir,
+                     std::vector<build_file> & files)
+{
+  struct stat sb;
+
+  files.resize(0);
+  if ( (stat(builddir.c_str(), &sb) != 0) || (! S_ISDIR(sb.st_mode)) )
+    return 1;
+  list_files_recursive(builddir, "", files);
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Constructors
+
+*******************************************************************************/
+ScriptSearch::ScriptSearch()
+{
+  _pattern = "";
+  _lowerpattern = "";
+  _whole_word = false;
+  _case_sensitive = false;
+  _use_regex = false;
+  _valid = false;
+}
+
+ScriptSearch::ScriptSearch(const std::string & pattern, bool whole_word,
+                           bool case_sensitive, bool use_regex)
+{
+  setPattern(pattern, whole_word, case_sensitive, use_regex);
+}
+
+/*******************************************************************************
+
+Sets pattern. For whole-word regex searches, the match must not be preceded or
+followed by a word character. Returns 1 if the regular expression is invalid.
+
+*******************************************************************************/
+int ScriptSearch::setPattern(const std::string & pattern, bool whole_word,
+                             bool case_sensitive, bool use_regex)
+{
+  std::regex::flag_type flags;
+  std::string expr;
+
+  _pattern = pattern;
+  _lowerpattern = string_to_lower(pattern);
+  _whole_word = whole_word;
+  _case_sensitive = case_sensitive;
+  _use_regex = use_regex;
+  _valid = true;
+  if (! _use_regex) { return 0; }
+
+  flags = std::regex::ECMAScript | std::regex::nosubs;
+  if (! _case_sensitive) { flags |= std::regex::icase; }
+  if (_whole_word)
+    expr = "(?:^|[^A-Za-z0-9_])(?:" + pattern + ")(?![A-Za-z0-9_])";
+  else { expr = pattern; }
+
+  try { _regex.assign(expr, flags); }
+  catch (const std::regex_error &) { _valid = false; }
+
+  return (_valid ? 0 : 1);
+}
+
+bool ScriptSearch::valid() const { return _valid; }
+
+/*******************************************************************************
+
+Lower-case strings that every match must contain. For a regular expression,
+these are runs of literal characters at the top level of the pattern. A
+character that may be repeated ends a run, one that may be absent is dropped,
+and groups, character classes, and escapes other than escaped punctuation are
+skipped. No strings are given if the pattern has a top-level alternation.
+
+*******************************************************************************/
+void ScriptSearch::requiredStrings(std::vector<std::string> & strs) const
+{
+  std::string run;
+  std::size_t i, len;
+  int depth;
+  bool in_class, literal;
+  char c, lit;
+
+  strs.resize(0);
+  if (! _valid) { return; }
+  if (! _use_regex)
+  {
+    run.resize(_pattern.size());
+    for ( i = 0; i < _pattern.size(); i++ )
+    {
+      run[i] = script_ascii_lower(_pattern[i]);
+    }
+    strs.push_back(run);
+    return;
+  }
+
+  // Check for top-level alternation
+
+  len = _pattern.size();
+  depth = 0;
+  in_class = false;
+  for ( i = 0; i < len; i++ )
+  {
+    c = _pattern[i];
+    if (c == '\\') { i++; }
+    else if (in_class) { in_class = (c != ']'); }
+    else if (c == '[') { in_class = true; }
+    else if (c == '(') { depth++; }
+    else if (c == ')') { depth--; }
+    else if ( (c == '|') && (depth == 0) ) { return; }
+  }
+
+  // Collect runs of literal characters
+
+  i = 0;
+  while (i < len)
+  {
+    c = _pattern[i];
+    literal = false;
+    lit = 0;
+    if (c == '\\')
+    {
+      if (i+1 >= len) { break; }
+      c = _pattern[i+1];
+      i += 2;
+      if (script_word_char(c))
+      {
+        // Character class, assertion, control, or backreference escape
+
+        if (c == 'x') { i += 2; }
+        else if (c == 'u') { i += 4; }
+        else if (c == 'c') { i += 1; }
+        else if ( (c >= '0') && (c <= '9') )
+        {
+          while ( (i < len) && (_pattern[i] >= '0') && (_pattern[i] <= '9') )
+            i++;
+        }
+      }
+      else
+      {
+        literal = true;
+        lit = c;
+      }
+    }
+    else if (c == '[')
+    {
+      i++;
+      if ( (i < len) && (_pattern[i] == '^') ) { i++; }
+      if ( (i < len) && (_pattern[i] == ']') ) { i++; }
+      while ( (i < len) && (_pattern[i] != ']') )
+      {
+        if (_pattern[i] == '\\') { i++; }
+        i++;
+      }
+      i++;
+    }
+    else if (c == '(')
+    {
+      depth = 1;
+      in_class = false;
+      i++;
+      while ( (i < len) && (depth > 0) )
+      {
+        c = _pattern[i];
+        if (c == '\\') { i++; }
+        else if (in_class) { in_class = (c != ']'); }
+        else if (c == '[') { in_class = true; }
+        else if (c == '(') { depth++; }
+        else if (c == ')') { depth--; }
+        i++;
+      }
+    }
+    else if (c == '{')
+    {
+      while ( (i < len) && (_pattern[i] != '}') ) { i++; }
+      i++;
+    }
+    else if ( (c == '*') || (c == '+') || (c == '?') || (c == '^') ||
+              (c == '$') || (c == '.') || (c == ')') )
+      i++;
+    else
+    {
+      literal = true;
+      lit = c;
+      i++;
+    }
+
+    // Quantifier following this element
+
+    c = (i < len) ? _pattern[i] : 0;
+    if ( literal && ((unsigned char)(lit) < 128) &&
+         (c != '*') && (c != '?') && (c != '{') )
+    {
+      run.push_back(script_ascii_lower(lit));
+      literal = (c != '+');
+    }
+    else { literal = false; }
+
+    if (! literal)
+    {
+      if (run.size() > 0) { strs.push_back(run); }
+      run = "";
+    }
+
+    if ( (c == '*') || (c == '+') || (c == '?') )
+    {
+      i++;
+      if ( (i < len) && (_pattern[i] == '?') ) { i++; }
+    }
+    else if (c == '{')
+    {
+      while ( (i < len) && (_pattern[i] != '}') ) { i++; }
+      i++;
+      if ( (i < len) && (_pattern[i] == '?') ) { i++; }
+    }
+  }
+  if (run.size() > 0) { strs.push_back(run); }
+}
+
+/*******************************************************************************
+
+Checks file contents for a substring match. A pattern without line breaks
+can't match across lines, so the contents are searched as a whole.
+
+*******************************************************************************/
+bool ScriptSearch::substringMatches(const std::string & contents) const
+{
+  std::string text;
+  const std::string *pattern;
+  std::size_t pos, end;
+
+  if (_case_sensitive)
+  {
+    text = contents;
+    pattern = &_pattern;
+  }
+  else
+  {
+    text = string_to_lower(contents);
+    pattern = &_lowerpattern;
+  }
+
+  pos = text.find(*pattern);
+  while (pos != std::string::npos)
+  {
+    if (! _whole_word) { return true; }
+    end = pos + pattern->size();
+    if ( ( (pos == 0) || (! script_word_char(text[pos-1])) ) &&
+         ( (end >= text.size()) || (! script_word_char(text[end])) ) )
+      return true;
+    pos = text.find(*pattern, pos+1);
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+
+Checks file contents for a regular expression match, line by line
+
+*******************************************************************************/
+bool ScriptSearch::regexMatches(const std::string & contents) const
+{
+  std::size_t pos, eol, len;
+
+  len = contents.size();
+  pos = 0;
+  while (pos < len)
+  {
+    eol = contents.find('\n', pos);
+    if (eol == std::string::npos) { eol = len; }
+    if (std::regex_search(contents.begin()+pos, contents.begin()+eol, _regex))
+      return true;
+    pos = eol+1;
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+
+Checks a file or all files in a SlackBuild directory for a match
+
+*******************************************************************************/
+bool ScriptSearch::matchesFile(const std::string & filename) const
+{
+  std::ifstream file;
+  std::stringstream ss;
+
+  if (! _valid) { return false; }
+  file.open(filename.c_str());
+  if (! file.is_open()) { return false; }
+  ss << file.rdbuf();
+  file.close();
+
+  if (_use_regex) { return regexMatches(ss.str()); }
+  else { return substringMatches(ss.str()); }
+}
+
+bool ScriptSearch::matchesBuild(const std::string & builddir) const
+{
+  std::vector<build_file> files;
+  unsigned int i, nfiles;
+
+  if (! _valid) { return false; }
+  if (list_build_files(builddir, files) != 0) { return false; }
+  nfiles = files.size();
+  for ( i = 0; i < nfiles; i++ )
+  {
+    if (matchesFile(builddir + "/" + files[i].path)) { return true; }
+  }
+
+  return false;
+}
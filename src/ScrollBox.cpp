@@ -394,7 +394,7 @@ std::string ScrollBox::exec(MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = readKey()) {
 
     // Enter key: accept selection
 
@@ -27,7 +27,7 @@ void SearchBox::redrawFrame()
   left = std::floor(mid - double(msglen)/2.0) + 1;
   wmove(_win, 1, 1);
   wclrtoeol(_win);
-  if (colors.turnOn(_win, "fg_title", "bg_title") != 0)
+  if (colors.turnOn(_win, _title_pair) != 0)
     wattron(_win, A_BOLD);
   printSpaces(left-1);
   printToEol(_msg);
@@ -127,11 +127,29 @@ SearchBox::SearchBox()
   _readmeitem.setWidth(30);
   _readmeitem.setPosition(8,1);
 
+  addItem(&_scriptitem);
+  _scriptitem.setName("Search SlackBuild files");
+  _scriptitem.setEnabled(false);
+  _scriptitem.setWidth(30);
+  _scriptitem.setPosition(9,1);
+
+  addItem(&_regexitem);
+  _regexitem.setName("Regular expression");
+  _regexitem.setEnabled(false);
+  _regexitem.setWidth(30);
+  _regexitem.setPosition(10,1);
+
+  addItem(&_fuzzyitem);
+  _fuzzyitem.setName("Fuzzy match names");
+  _fuzzyitem.setEnabled(false);
+  _fuzzyitem.setWidth(30);
+  _fuzzyitem.setPosition(11,1);
+
   addItem(&_currentlistitem);
   _currentlistitem.setName("Current list only");
   _currentlistitem.setEnabled(false);
   _currentlistitem.setWidth(30);
-  _currentlistitem.setPosition(9,1);
+  _currentlistitem.setPosition(12,1);
 }
 
 SearchBox::~SearchBox() { delete _items[0]; }
@@ -152,4 +170,7 @@ std::string SearchBox::searchString() const { return _entryitem.text(); }
 bool SearchBox::caseSensitive() const { return _caseitem.enabled(); }
 bool SearchBox::wholeWord() const { return _wholeitem.enabled(); }
 bool SearchBox::searchREADMEs() const { return _readmeitem.enabled(); }
+bool SearchBox::searchScripts() const { return _scriptitem.enabled(); }
+bool SearchBox::regex() const { return _regexitem.enabled(); }
+bool SearchBox::fuzzy() const { return _fuzzyitem.enabled(); }
 bool SearchBox::currentList() const { return _currentlistitem.enabled(); }
@@ -0,0 +1,219 @@
+#include <string>
+#include <vector>
+#include <algorithm>    // upper_bound
+#include <cstring>      // memchr, memcmp
+#include "BuildListItem.h"
+#include "string_util.h"
+#include "SearchSession.h"
+
+/*******************************************************************************
+
+Checks whether a name contains a pattern
+
+*******************************************************************************/
+bool name_contains(const char *name, unsigned int len,
+                   const std::string & pattern)
+{
+  const char *pos, *last;
+  unsigned int plen;
+
+  plen = pattern.size();
+  if (plen == 0) { return true; }
+  if (plen > len) { return false; }
+  last = name + len - plen;
+  pos = name;
+  while (pos <= last)
+  {
+    pos = static_cast<const char *>(
+          std::memchr(pos, pattern[0], last - pos + 1));
+    if (pos == NULL) { return false; }
+    if (std::memcmp(pos, pattern.data(), plen) == 0) { return true; }
+    pos++;
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+
+Searches all names. Names are separated by newlines in the buffer, so a match
+cannot span two names.
+
+*******************************************************************************/
+void SearchSession::searchAll(const std::string & query,
+                              std::vector<unsigned int> & result) const
+{
+  std::string::size_type pos;
+  unsigned int idx;
+
+  result.resize(0);
+  if (query.size() == 0)
+  {
+    result.resize(_categories.size());
+    for ( idx = 0; idx < result.size(); idx++ ) { result[idx] = idx; }
+    return;
+  }
+  pos = _names.find(query);
+  while (pos != std::string::npos)
+  {
+    idx = std::upper_bound(_offsets.begin(), _offsets.end(), (unsigned int)pos)
+        - _offsets.begin() - 1;
+    result.push_back(idx);
+    pos = _names.find(query, _offsets[idx+1]);
+  }
+}
+
+/*******************************************************************************
+
+Searches only names that matched a prefix of the query
+
+*******************************************************************************/
+void SearchSession::narrow(const std::string & query,
+                           const std::vector<unsigned int> & parent,
+                           std::vector<unsigned int> & result) const
+{
+  unsigned int i, nparent, idx;
+
+  result.resize(0);
+  nparent = parent.size();
+  for ( i = 0; i < nparent; i++ )
+  {
+    idx = parent[i];
+    if (name_contains(_names.data() + _offsets[idx],
+                      _offsets[idx+1] - _offsets[idx] - 1, query))
+      result.push_back(idx);
+  }
+}
+
+/*******************************************************************************
+
+Constructor
+
+*******************************************************************************/
+SearchSession::SearchSession() { clear(); }
+
+/*******************************************************************************
+
+Starts a new session: stores lower-case names and clears cached results
+
+*******************************************************************************/
+void SearchSession::start(
+                      const std::vector<std::vector<BuildListItem *> > & lists)
+{
+  unsigned int i, j, ncategories, nbuilds;
+
+  clear();
+  ncategories = lists.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = lists[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      _names += string_to_lower(lists[i][j]->name());
+      _names.push_back('\n');
+      _offsets.push_back(_names.size());
+      _categories.push_back(i);
+      _indices.push_back(j);
+    }
+  }
+
+  // All names are shown before the first update
+
+  searchAll("", _last);
+}
+
+void SearchSession::clear()
+{
+  _names.clear();
+  _offsets.assign(1, 0);
+  _categories.resize(0);
+  _indices.resize(0);
+  _queries.resize(0);
+  _results.resize(0);
+  _last.resize(0);
+}
+
+/*******************************************************************************
+
+Updates matches for query. Cached results that are not prefixes of the query
+are dropped; the query is then taken from the cache, narrowed from the longest
+cached prefix, or searched in all names.
+
+*******************************************************************************/
+int SearchSession::update(const std::string & query)
+{
+  std::string lquery;
+  std::vector<unsigned int> result;
+  unsigned int ncached;
+
+  lquery = string_to_lower(query);
+  while ( (_queries.size() > 0) &&
+          (lquery.compare(0, _queries.back().size(), _queries.back()) != 0) )
+  {
+    _queries.pop_back();
+    _results.pop_back();
+  }
+
+  ncached = _queries.size();
+  if ( (ncached == 0) || (_queries.back() != lquery) )
+  {
+    if (ncached == 0) { searchAll(lquery, result); }
+    else { narrow(lquery, _results.back(), result); }
+    _queries.push_back(lquery);
+    _results.push_back(result);
+  }
+
+  if (_results.back() == _last) { return 0; }
+  _last = _results.back();
+
+  return 1;
+}
+
+/*******************************************************************************
+
+Matches from the last update
+
+*******************************************************************************/
+unsigned int SearchSession::numMatches() const { return _last.size(); }
+
+unsigned int SearchSession::category(unsigned int match) const
+{
+  return _categories[_last[match]];
+}
+
+unsigned int SearchSession::index(unsigned int match) const
+{
+  return _indices[_last[match]];
+}
+
+/*******************************************************************************
+
+Returns the best of the last matches for query: an exact name match, else the
+first name starting with query, else the first match. Returns -1 if there are
+no matches.
+
+*******************************************************************************/
+int SearchSession::bestMatch(const std::string & query) const
+{
+  std::string lquery;
+  unsigned int i, nmatches, idx, len;
+  int best;
+
+  nmatches = _last.size();
+  if (nmatches == 0) { return -1; }
+  lquery = string_to_lower(query);
+  best = -1;
+  for ( i = 0; i < nmatches; i++ )
+  {
+    idx = _last[i];
+    len = _offsets[idx+1] - _offsets[idx] - 1;
+    if ( (len < lquery.size()) ||
+         (_names.compare(_offsets[idx], lquery.size(), lquery) != 0) )
+      continue;
+    if (len == lquery.size()) { return i; }
+    if (best == -1) { best = i; }
+  }
+  if (best == -1) { best = 0; }
+
+  return best;
+}
@@ -85,7 +85,7 @@ std::string SelectionBox::exec(MouseEvent * mevent)
 
     // Get user input
 
-    switch (ch = getch()) {
+    switch (ch = readKey()) {
 
       // Enter key: accept selection
 
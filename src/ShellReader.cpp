@@ -1,26 +1,85 @@
 #include <string>
 #include <vector>
-#include <fstream>
-#include "string_util.h"
+#include <cstring>      // memchr
+#include <fcntl.h>      // open
+#include <unistd.h>     // close
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>
 #include "ShellReader.h"
 
 /*******************************************************************************
 
-Checks variable name and removes 'varname=' if it is found
+Helpers operating on [begin, end) ranges, equivalent to remove_comment,
+remove_leading_whitespace, and trim in string_util but without copying
 
 *******************************************************************************/
-bool ShellReader::checkVarname(std::string & line,
+void range_remove_comment(const char *begin, const char *& end)
+{
+  const char *comment;
+
+  comment = static_cast<const char *>(std::memchr(begin, '#', end-begin));
+  if (comment != NULL) { end = comment; }
+}
+
+void range_remove_leading_whitespace(const char *& begin, const char *end)
+{
+  while ( (begin < end) && (*begin == ' ') ) { begin++; }
+}
+
+void range_trim(const char *begin, const char *& end)
+{
+  while ( (end > begin) &&
+          ((end[-1] == ' ') || (end[-1] == '\n') || (end[-1] == '\0')) )
+    end--;
+}
+
+const char * range_find(const char *begin, const char *end, char ch)
+{
+  const char *pos;
+
+  if (end <= begin) { return end; }
+  pos = static_cast<const char *>(std::memchr(begin, ch, end-begin));
+  if (pos == NULL) { return end; }
+  else { return pos; }
+}
+
+/*******************************************************************************
+
+Gets the next line as the range [begin, end), not including the newline.
+Returns false if the end of the file has been reached.
+
+*******************************************************************************/
+bool ShellReader::nextLine(const char *& begin, const char *& end)
+{
+  if (_pos >= _size) { return false; }
+
+  begin = _data + _pos;
+  end = range_find(begin, _data + _size, '\n');
+  _pos = (end - _data) + 1;
+
+  return true;
+}
+
+/*******************************************************************************
+
+Checks variable name and moves begin past 'varname=' if it is found
+
+*******************************************************************************/
+bool ShellReader::checkVarname(const char *& begin, const char *& end,
                                const std::string & varname) const
 {
-  unsigned int len;
+  const char *line;
+  std::size_t len;
 
-  line = remove_comment(line, '#');
-  line = remove_leading_whitespace(line);
+  range_remove_comment(begin, end);
+  range_remove_leading_whitespace(begin, end);
 
+  line = begin;
   len = varname.size();
-  if (line.substr(0, len+1) == varname + "=")
+  if ( (std::size_t(end-line) >= len+1) &&
+       (varname.compare(0, len, line, len) == 0) && (line[len] == '=') )
   {
-    line = line.substr(len+1, line.size()-len-1);
+    begin = line + len + 1;
     return true;
   }
   else { return false; }
@@ -32,78 +91,80 @@ Reads the value of a variable given the first line. It is assumed that
 checkVarname has been called first so that VARNAME= has already been removed.
 
 *******************************************************************************/
-int ShellReader::readVariable(std::string & line, std::string & value)
+int ShellReader::readVariable(const char *begin, const char *end,
+                              std::string & value)
 {
-  bool readnext, endvalue;
-  unsigned int len;
+  const char *quote_pos, *token_end;
   char quote;
-  std::size_t quote_pos;
 
   // Read the first line
 
-  line = trim(line);
-  len = line.size();
-  readnext = false;
-  if ( (line[0] == '"') || (line[0] == '\'') )
+  range_trim(begin, end);
+  if (begin == end)
   {
-    quote = line[0];                        // Get quote character
-    quote_pos = line.substr(1,len-1).find_first_of(quote);
-    if (quote_pos != std::string::npos)
+    value = "";
+    return 0;
+  }
+  if ( (*begin == '"') || (*begin == '\'') )
+  {
+    quote = *begin;                         // Get quote character
+    quote_pos = range_find(begin+1, end, quote);
+    if (quote_pos != end)
     {
-      value = line.substr(1,quote_pos);     // Value between quotes
+      value.assign(begin+1, quote_pos);     // Value between quotes
       return 0;
-    } 
-    else if (line[len-1] == '\\')
-    { 
-      value = trim(line.substr(1,len-2));   // Line continuation
-      readnext = true;
+    }
+    else if (end[-1] == '\\')
+    {
+      token_end = end-1;                    // Line continuation
+      range_trim(begin+1, token_end);
+      value.assign(begin+1, token_end);
     }
     else
     {
-      value = trim(line.substr(1,len-1));   // Unclosed quote: go to next line
-      readnext = true;
+      value.assign(begin+1, end);           // Unclosed quote: go to next line
     }
   }
   else
   {
     // Just read the thing right after the equal sign
-    value = split(line)[0];
+    value.assign(begin, range_find(begin, end, ' '));
     return 0;
   }
 
   // Keep reading subsequent lines until the quote is closed
 
-  if (readnext)
+  while (1)
   {
-    endvalue = false;
-    while (! endvalue)
+    if (! nextLine(begin, end))
     {
-      if (_file.eof())
-      {
-        rewind();
-        return 1;
-      }
-      std::getline(_file, line);
-      line = remove_leading_whitespace(line);
-      if (line[0] == '#') { continue; }     // Comment line
-      line = remove_comment(line, '#');
-      line = trim(line);
-
-      len = line.size();
-      quote_pos = line.substr(1,len-1).find_first_of(quote);
-      if (quote_pos != std::string::npos)   // End value
-      {
-        endvalue = true;
-        value += " " + trim(line.substr(0,quote_pos+1));
-      }
-      else if (line[len-1] == '\\')         // Line continuation
-      {
-        value += " " + trim(line.substr(0,len-2));
-      }
-      else                                  // Unclosed quote: go to next line
-      {
-        value += " " + trim(line);
-      }
+      rewind();
+      return 1;
+    }
+    range_remove_leading_whitespace(begin, end);
+    if ( (begin < end) && (*begin == '#') ) { continue; }  // Comment line
+    range_remove_comment(begin, end);
+    range_trim(begin, end);
+
+    quote_pos = range_find(begin, end, quote);
+    if (quote_pos != end)                   // End value
+    {
+      range_trim(begin, quote_pos);
+      value += " ";
+      value.append(begin, quote_pos);
+      break;
+    }
+    else if ( (begin < end) && (end[-1] == '\\') )  // Line continuation
+    {
+      token_end = end-1;
+      range_trim(begin, token_end);
+      value += " ";
+      value.append(begin, token_end);
+    }
+    else                                    // Unclosed quote: go to next line
+    {
+      value += " ";
+      value.append(begin, end);
     }
   }
 
@@ -116,32 +177,33 @@ Reads the value of a default variable given the line. Default variables may not
 span multiple lines.
 
 *******************************************************************************/
-int ShellReader::readDefaultVariable(std::string & line, std::string & value)
+int ShellReader::readDefaultVariable(const char *begin, const char *end,
+                                     std::string & value) const
 {
-  std::size_t dollarpos, brace0pos, colonpos, dashpos, brace1pos;
+  const char *dollarpos, *brace0pos, *colonpos, *dashpos, *brace1pos;
 
-  line = trim(line);
+  range_trim(begin, end);
 
   // Check to make sure there is a ${VAR:-DEFAULT_VAL} construct
-  
-  dollarpos = line.find_first_of('$');
-  if (dollarpos == std::string::npos)
+
+  dollarpos = range_find(begin, end, '$');
+  if (dollarpos == end)
     return 1;
 
-  brace0pos = line.find_first_of('{');
-  if (brace0pos == std::string::npos)
+  brace0pos = range_find(begin, end, '{');
+  if (brace0pos == end)
     return 1;
 
-  colonpos = line.find_first_of(':');
-  if (colonpos == std::string::npos)
+  colonpos = range_find(begin, end, ':');
+  if (colonpos == end)
     return 1;
 
-  dashpos = line.find_first_of('-');
-  if (dashpos == std::string::npos)
+  dashpos = range_find(begin, end, '-');
+  if (dashpos == end)
     return 1;
 
-  brace1pos = line.find_first_of('}');
-  if (brace1pos == std::string::npos)
+  brace1pos = range_find(begin, end, '}');
+  if (brace1pos == end)
     return 1;
 
   if (brace0pos < dollarpos)
@@ -158,7 +220,7 @@ int ShellReader::readDefaultVariable(std::string & line, std::string & value)
 
   // Pick out the value
 
-  value = line.substr(dashpos+1,brace1pos-dashpos-1); 
+  value.assign(dashpos+1, brace1pos);
 
   return 0;
 }
@@ -168,8 +230,15 @@ int ShellReader::readDefaultVariable(std::string & line, std::string & value)
 Constructor and destructor
 
 *******************************************************************************/
-ShellReader::ShellReader() { _file_open = false; }
-ShellReader::~ShellReader() { if (_file_open) { _file.close(); } }
+ShellReader::ShellReader()
+{
+  _data = NULL;
+  _size = 0;
+  _pos = 0;
+  _file_open = false;
+}
+
+ShellReader::~ShellReader() { close(); }
 
 /*******************************************************************************
 
@@ -178,9 +247,36 @@ Opens or closes a file. Returns 1 on error or 0 on success.
 *******************************************************************************/
 int ShellReader::open(const std::string & filename)
 {
-  _file.open(filename.c_str());
-  if (not _file.is_open()) { return 1; }
-  else { _file_open = true; }
+  int fd;
+  struct stat sb;
+  void *map;
+
+  if (_file_open) { close(); }
+
+  fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) { return 1; }
+  if (fstat(fd, &sb) != 0)
+  {
+    ::close(fd);
+    return 1;
+  }
+
+  _size = sb.st_size;
+  _pos = 0;
+  if (_size > 0)
+  {
+    map = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+      ::close(fd);
+      _size = 0;
+      return 1;
+    }
+    _data = static_cast<const char *>(map);
+  }
+  else { _data = NULL; }
+  ::close(fd);
+  _file_open = true;
 
   return 0;
 }
@@ -188,9 +284,12 @@ int ShellReader::open(const std::string & filename)
 int ShellReader::close()
 {
   if (! _file_open) { return 1; }
-  else 
+  else
   {
-    _file.close();
+    if (_data != NULL) { munmap(const_cast<char *>(_data), _size); }
+    _data = NULL;
+    _size = 0;
+    _pos = 0;
     _file_open = false;
   }
 
@@ -207,35 +306,72 @@ Returns 1 on error or 0 on success.
 int ShellReader::read(const std::string & varname, std::string & value,
                       bool default_var)
 {
-  int check;
-  bool reading;
-  std::string line;
+  const char *begin, *end;
 
   if (! _file_open) { return 1; }
 
-  reading = true;
-  check = 0;
   rewind();
-  while (reading)
+  while (nextLine(begin, end))
   {
-    if (_file.eof())
+    if (checkVarname(begin, end, varname))
     {
-      rewind();
-      return 1;
-    }
-
-    std::getline(_file, line);
-    if (checkVarname(line, varname))
-    { 
       if (default_var)
-        check = readDefaultVariable(line, value);
+        return readDefaultVariable(begin, end, value);
       else
-        check = readVariable(line, value); 
-      reading = false;
+        return readVariable(begin, end, value);
+    }
+  }
+  rewind();
+
+  return 1;
+}
+
+/*******************************************************************************
+
+Reads several variables in a single pass through the file. default_vars flags
+which variables are set as default values (see above). Values of variables that
+are not found are set to empty strings. Returns 0 if all variables were read
+successfully, or 1 otherwise.
+
+*******************************************************************************/
+int ShellReader::read(const std::vector<std::string> & varnames,
+                      std::vector<std::string> & values,
+                      const std::vector<bool> & default_vars)
+{
+  const char *begin, *end;
+  std::vector<bool> found;
+  unsigned int i, nvars, nfound;
+  int check, retval;
+
+  nvars = varnames.size();
+  values.assign(nvars, "");
+  if (! _file_open) { return 1; }
+
+  found.assign(nvars, false);
+  nfound = 0;
+  retval = 0;
+  rewind();
+  while ( (nfound < nvars) && nextLine(begin, end) )
+  {
+    for ( i = 0; i < nvars; i++ )
+    {
+      if (found[i]) { continue; }
+      if (checkVarname(begin, end, varnames[i]))
+      {
+        if ( (i < default_vars.size()) && (default_vars[i]) )
+          check = readDefaultVariable(begin, end, values[i]);
+        else
+          check = readVariable(begin, end, values[i]);
+        if (check != 0) { retval = 1; }
+        found[i] = true;
+        nfound++;
+        break;
+      }
     }
   }
+  if (nfound < nvars) { retval = 1; }
 
-  return check;
+  return retval;
 }
 
 /*******************************************************************************
@@ -247,8 +383,7 @@ int ShellReader::rewind()
 {
   if (! _file_open) { return 1; }
 
-  _file.clear();
-  _file.seekg(0);
+  _pos = 0;
 
   return 0;
 }
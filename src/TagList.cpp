@@ -19,8 +19,7 @@ screen or not.
 *******************************************************************************/
 void TagList::redrawSingleItem(unsigned int idx)
 {
-  std::string fg, bg;
-  int rows, cols; 
+  int rows, cols, color_pair;
 
   getmaxyx(_win, rows, cols);
 
@@ -32,22 +31,14 @@ void TagList::redrawSingleItem(unsigned int idx)
 
   if (int(idx) == _highlight)
   {
-    if (_activated) 
-    { 
-      fg = "fg_highlight_active";
-      bg = "bg_highlight_active"; 
-    }
-    else
-    {
-      fg = "fg_highlight_inactive";
-      bg = "bg_highlight_inactive"; 
-    }
-    if (colors.turnOn(_win, fg, bg) != 0)
+    if (_activated) { color_pair = _highlight_active_pair; }
+    else { color_pair = _highlight_inactive_pair; }
+    if (colors.turnOn(_win, color_pair) != 0)
     { 
       if (_activated) { wattron(_win, A_REVERSE); }
     }
   } 
-  else { colors.turnOn(_win, "fg_popup", "bg_popup"); }
+  else { colors.turnOn(_win, _color_pair); }
 
   // Save highlight idx for redrawing later.
   // Note: prevents this method from being const.
@@ -246,7 +237,7 @@ std::string TagList::exec(MouseEvent * mevent)
 
   // Get user input
 
-  switch (ch = getch()) {
+  switch (ch = readKey()) {
 
     // Enter key: accept selection
 
@@ -3,6 +3,7 @@
 #include "Color.h"
 #include "settings.h"
 #include "signals.h"
+#include "CursesWidget.h"
 #include "InputItem.h"
 #include "TextInput.h"
 #include "MouseEvent.h"
@@ -159,7 +160,7 @@ void TextInput::draw(int y_offset, bool force, bool highlight)
 
   if (highlight)
     if (colors.turnOff(_win) != 0) { wattroff(_win, A_REVERSE); }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -192,7 +193,7 @@ std::string TextInput::exec(int y_offset, MouseEvent * mevent)
 
     // Get user input
 
-    switch (ch = getch()) {
+    switch (ch = CursesWidget::readKey()) {
 
       // Enter key: return Enter signal
 
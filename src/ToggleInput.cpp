@@ -3,6 +3,7 @@
 #include "Color.h"
 #include "settings.h"
 #include "signals.h"
+#include "CursesWidget.h"
 #include "InputItem.h"
 #include "ToggleInput.h"
 #include "MouseEvent.h"
@@ -105,7 +106,7 @@ void ToggleInput::draw(int y_offset, bool force, bool highlight)
 
   if (highlight)
     if (colors.turnOff(_win) != 0) { wattroff(_win, A_REVERSE); }
-  wrefresh(_win);
+  wnoutrefresh(_win);
 }
 
 /*******************************************************************************
@@ -136,7 +137,7 @@ std::string ToggleInput::exec(int y_offset, MouseEvent * mevent)
 
     // Get user input
 
-    switch (ch = getch()) {
+    switch (ch = CursesWidget::readKey()) {
 
       // Enter key: return enter signal
 
@@ -1,12 +1,14 @@
 #include <iostream>
 #include <stdlib.h>   // system
 #include <sys/wait.h> // WEXITSTATUS, WIFEXITED
+#include <sys/utsname.h> // uname
 #include <vector>
 #include <string>
 #include <sstream>
 #include <algorithm>  // sort
 #include <fstream>
-#include <atomic>
+#include <unordered_map>
+#include <utility>    // pair
 #include <ctime>      // strftime
 #include "DirListing.h"
 #include "ListItem.h"
@@ -15,82 +17,152 @@
 #include "ShellReader.h"
 #include "settings.h"
 #include "Blacklist.h"
+#include "RepoIndex.h"
+#include "ReadmeIndex.h"
+#include "ScriptIndex.h"
+#include "RepoScanner.h"
+#include "InstalledPackages.h"
+#include "PackageCache.h"
+#include "NativeBackend.h"
+#include "requirements.h"   // reset_dep_graph
 #include "backend.h"
 
-#ifndef PACKAGE_DIR
-  #define PACKAGE_DIR "/var/lib/pkgtools/packages"
-#endif
-
 using namespace settings;
 
 Blacklist blacklist;
+InstalledPackages installed_packages;
+
+// Hash table mapping SlackBuild names to (category, index) in the list of
+// SlackBuilds, built in read_repo and used by find_slackbuild
+
+std::unordered_map<std::string, std::pair<int,int> > slackbuild_index;
+std::vector<std::vector<BuildListItem> > *indexed_slackbuilds = NULL;
 
 /*******************************************************************************
 
-Gets list of SlackBuilds by reading repo directory. Returns 0 if successful,
-1 if directory cannot be read, 2 if directory is empty.
+Gets list of SlackBuilds from the repository index if it is up to date, or else
+by reading repo directory. In the latter case, repo info is read for every
+SlackBuild and the index is rewritten, if possible. Returns 0 if successful, 1
+if directory cannot be read, 2 if directory is empty.
 
 *******************************************************************************/
 int read_repo(std::vector<std::vector<BuildListItem> > & slackbuilds)
 {
-  DirListing top_dir, category_dir;
-  int stat;
+  RepoScanner scanner(repo_dir);
+  RepoIndex index;
+  int stat, k, nallbuilds;
   unsigned int i, j, ncategories, nbuilds;
-  direntry cat_entry, build_entry;
+  std::vector<repo_category> repo_categories;
+  std::vector<std::string> categories;
+  std::vector<BuildListItem *> allbuilds;
 
-  // Open top directory
+  // Use the index if it is up to date
 
-  stat = top_dir.setFromPath(repo_dir);
+  if (index.load(slackbuilds) == 0)
+  {
+    ncategories = slackbuilds.size();
+    if (ncategories == 0) { return 2; }
+    for ( i = 0; i < ncategories; i++ )
+    {
+      nbuilds = slackbuilds[i].size();
+      for ( j = 0; j < nbuilds; j++ )
+      {
+        slackbuilds[i][j].setBoolProp("blacklisted",
+                          blacklist.nameBlacklisted(slackbuilds[i][j].name()));
+      }
+    }
+    index_slackbuilds(slackbuilds);
+    return 0;
+  }
+
+  // Scan repo directory
+
+  stat = scanner.scan(repo_categories);
   if (stat == 1) { return stat; }
   
-  // Read SlackBuilds from each category
+  // Set up SlackBuilds from each category
 
   slackbuilds.resize(0); 
-  ncategories = top_dir.size();
+  ncategories = repo_categories.size();
   if (ncategories == 0) { return 2; }
+  slackbuilds.resize(ncategories);
   for ( i = 0; i < ncategories; i++ )
   {
-    cat_entry = top_dir(i);
-    if (cat_entry.type == "dir")
+    nbuilds = repo_categories[i].builds.size();
+    slackbuilds[i].resize(nbuilds);
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      BuildListItem & build = slackbuilds[i][j];
+      build.setName(repo_categories[i].builds[j]);
+      build.setProp("category", repo_categories[i].name);
+      // Check if blacklisted by name at this point
+      build.setBoolProp("blacklisted", blacklist.nameBlacklisted(build.name()));
+    }
+    categories.push_back(repo_categories[i].name);
+  }  
+  index_slackbuilds(slackbuilds);
+
+  // Read repo info for all SlackBuilds and save the index for next time.
+  // Installed status is not known yet, so upgradable status gets set later in
+  // determine_installed.
+
+  if (index.writable())
+  {
+    ncategories = slackbuilds.size();
+    for ( i = 0; i < ncategories; i++ )
     {
-      std::vector<BuildListItem> cat_builds;
-      category_dir.setFromPath(cat_entry.path + "/" + cat_entry.name);
-      nbuilds = category_dir.size();
+      nbuilds = slackbuilds[i].size();
       for ( j = 0; j < nbuilds; j++ )
       {
-        build_entry = category_dir(j);
-        if (build_entry.type == "dir")
-        {
-          BuildListItem build;
-          build.setName(build_entry.name);
-          build.setProp("category", cat_entry.name);
-          // Check if blacklisted by name at this point
-          build.setBoolProp("blacklisted",
-                            blacklist.nameBlacklisted(build.name()));
-          cat_builds.push_back(build);
-        }
-        else { break; }   // Directories are listed first, so we're done
+        allbuilds.push_back(&slackbuilds[i][j]);
       }
-      slackbuilds.push_back(cat_builds);
     }
-    else { break; }       // Directories are listed first, so we're done
-  }  
+    nallbuilds = allbuilds.size();
+#pragma omp parallel for schedule(dynamic,64)
+    for ( k = 0; k < nallbuilds; k++ ) { allbuilds[k]->readPropsFromRepo(); }
+    index.write(slackbuilds, categories);
+  }
 
   return 0;
 } 
 
 /*******************************************************************************
 
+Reads build options file, joining lines with semicolons. A missing file gives
+no build options.
+
+*******************************************************************************/
+std::string read_buildopts_file(const std::string & fpath)
+{
+  std::ifstream file;
+  std::string buildopts, opt;
+
+  file.open(fpath.c_str());
+  buildopts = "";
+  if (! file.is_open()) { return buildopts; }
+  while (1)
+  { 
+    std::getline(file, opt);
+    buildopts += opt;
+    if (file.eof()) { break; }
+    else { buildopts += ";"; }
+  }
+  file.close();
+
+  return buildopts;
+}
+
+/*******************************************************************************
+
 Reads build options in /var/lib/sboui/buildopts
 
 *******************************************************************************/
 int read_buildopts(std::vector<std::vector<BuildListItem> > & slackbuilds)
 {
   DirListing listing;
-  std::string buildopts_dir, fpath, buildopts, opt, buildname;
+  std::string buildopts_dir, fpath, buildname;
   unsigned int k, nbuilds_opts, stat;
   int i, j;
-  std::ifstream file;
   std::size_t ext_idx;
 
   // Open directory
@@ -107,19 +179,9 @@ int read_buildopts(std::vector<std::vector<BuildListItem> > & slackbuilds)
     fpath = buildopts_dir + "/" + listing(k).name;
     ext_idx = listing(k).name.find(".buildopts");
     if (ext_idx == std::string::npos) { continue; }
-    file.open(fpath.c_str());
-    buildopts = "";
-    while (1)
-    { 
-      std::getline(file, opt);
-      buildopts += opt;
-      if (file.eof()) { break; }
-      else { buildopts += ";"; }
-    }
     buildname = listing(k).name.substr(0,ext_idx);
-    find_slackbuild(buildname, slackbuilds, i, j);
-    slackbuilds[i][j].setProp("build_options", buildopts);
-    file.close();
+    if (find_slackbuild(buildname, slackbuilds, i, j) == 0)
+      slackbuilds[i][j].setProp("build_options", read_buildopts_file(fpath));
   }
 
   return 0;
@@ -127,51 +189,106 @@ int read_buildopts(std::vector<std::vector<BuildListItem> > & slackbuilds)
 
 /*******************************************************************************
 
+Re-reads build options for one SlackBuild, e.g. after the file was changed
+outside of sboui
+
+*******************************************************************************/
+void update_buildopts(BuildListItem & build)
+{
+  std::string fpath;
+
+  fpath = "/var/lib/sboui/buildopts/" + build.name() + ".buildopts";
+  build.setProp("build_options", read_buildopts_file(fpath));
+}
+
+/*******************************************************************************
+
+Builds hash table of SlackBuild names for find_slackbuild. Must be called again
+whenever the list of SlackBuilds is re-read. Also marks the dependency graph as
+out of date.
+
+*******************************************************************************/
+void index_slackbuilds(std::vector<std::vector<BuildListItem> > & slackbuilds)
+{
+  unsigned int i, j, ncategories, nbuilds;
+
+  slackbuild_index.clear();
+  indexed_slackbuilds = &slackbuilds;
+  reset_dep_graph();
+  ncategories = slackbuilds.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    nbuilds = slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      slackbuild_index[slackbuilds[i][j].name()] = std::make_pair(i, j);
+    }
+  }
+}
+
+/*******************************************************************************
+
+Computes list of all requirements of a SlackBuild, direct and indirect, in
+build order, using the list of SlackBuilds last indexed. Returns 1 if there is
+no such list, or else the same as compute_reqs_order.
+
+*******************************************************************************/
+int indexed_reqs_order(const BuildListItem & build,
+                       std::vector<BuildListItem *> & reqlist)
+{
+  reqlist.resize(0);
+  if (indexed_slackbuilds == NULL) { return 1; }
+
+  return compute_reqs_order(build, reqlist, *indexed_slackbuilds);
+}
+
+/*******************************************************************************
+
 Finds a SlackBuild by name in the _slackbuilds list. Returns 0 if found, 1 if
-not found, and also sets indices in list where it was found.
+not found, and also sets indices in list where it was found. Uses the hash
+table built by index_slackbuilds, falling back to searching each category if
+the table was built for a different list or is out of date.
  
 *******************************************************************************/
 int find_slackbuild(const std::string & name,
                     std::vector<std::vector<BuildListItem> > & slackbuilds,
                     int & idx0, int & idx1)
 {
-  int i, ncategories, nbuilds, check, lbound, rbound;
-  std::atomic<bool> found(false);
+  int i, j, ncategories, nbuilds, check, lbound, rbound;
+  std::unordered_map<std::string, std::pair<int,int> >::const_iterator it;
+
+  it = slackbuild_index.find(name);
+  if (it != slackbuild_index.end())
+  {
+    i = it->second.first;
+    j = it->second.second;
+    if ( (i < int(slackbuilds.size())) && (j < int(slackbuilds[i].size())) &&
+         (slackbuilds[i][j].name() == name) )
+    {
+      idx0 = i;
+      idx1 = j;
+      return 0;
+    }
+  }
+  else if (indexed_slackbuilds == &slackbuilds) { return 1; }
 
   ncategories = slackbuilds.size();
-#pragma omp parallel for private(i,nbuilds,lbound,rbound,check)
   for ( i = 0; i < ncategories; i++ )
   {
-    if (found)
-      continue;
     nbuilds = slackbuilds[i].size();
+    if (nbuilds == 0) { continue; }
     lbound = 0;
     rbound = nbuilds-1;
-    check = find_name_in_list(name, slackbuilds[i], idx1, lbound, rbound);
+    check = find_name_in_list(name, slackbuilds[i], j, lbound, rbound);
     if (check == 0)
     {
       idx0 = i;
-      found = true;
+      idx1 = j;
+      return 0;
     }
   }
 
-  if (found)
-    return 0;
-  else
-    return 1;
-}
-
-/*******************************************************************************
-
-Gets basename of a file (removes path)
-
-*******************************************************************************/
-std::string basename(const std::string & fullpath)
-{
-  std::vector<std::string> splitpkg;
-
-  splitpkg = split(fullpath, '/');
-  return splitpkg[splitpkg.size()-1];
+  return 1;
 }
 
 /*******************************************************************************
@@ -208,46 +325,24 @@ int get_pkg_info(const std::string & pkg, std::string & name,
 
 /*******************************************************************************
 
-Returns list of all installed packages (not just the ones from the repo)
-
-*******************************************************************************/
-std::vector<std::string> list_installed_packages()
-{
-  std::vector<std::string> pkglist;
-  DirListing packages_dir(std::string(PACKAGE_DIR), false, false);
-  unsigned int npackages, i;
-
-  npackages = packages_dir.size();
-  for ( i = 0; i < npackages; i++ )
-  {
-    pkglist.push_back(basename(packages_dir(i).path + packages_dir(i).name));
-  }
-
-  return pkglist;
-}
-
-/*******************************************************************************
-
 Checks if a SlackBuild is installed and sets info if so.
 
 *******************************************************************************/
 bool check_installed(const BuildListItem & build,
-                     const std::vector<std::string> & installedpkgs,
+                     const InstalledPackages & installedpkgs,
                      std::string & pkg, std::string & version,
                      std::string & arch, std::string & pkgbuild)
 {
-  std::string name;
-  unsigned int ninstalled, i;
+  const installed_pkg *entry;
 
-  ninstalled = installedpkgs.size();
-  for ( i = 0; i < ninstalled; i++ )
+  entry = installedpkgs.find(build.name());
+  if (entry != NULL)
   {
-    get_pkg_info(installedpkgs[i], name, version, arch, pkgbuild);
-    if (name == build.name())
-    {
-      pkg = installedpkgs[i];
-      return true;
-    }
+    pkg = entry->pkg;
+    version = entry->version;
+    arch = entry->arch;
+    pkgbuild = entry->build;
+    return true;
   }
     
   pkg = "";
@@ -285,8 +380,55 @@ int get_reqs(const BuildListItem & build, std::string & reqs)
 
 /*******************************************************************************
 
+Gets source URLs and md5sums for a SlackBuild, using the x86_64 ones on that
+architecture if there are any, unless force32 is set. Returns 1 if the .info
+file cannot be read, or 2 if the SlackBuild is unsupported on this
+architecture.
+
+*******************************************************************************/
+int get_sources(const BuildListItem & build, std::vector<std::string> & urls,
+                std::vector<std::string> & md5sums, bool force32)
+{
+  ShellReader reader;
+  std::string info_file;
+  std::vector<std::string> varnames(4), values;
+  std::vector<bool> default_vars(4, false);
+  struct utsname sysinfo;
+  int check;
+
+  info_file = repo_dir + "/" + build.getProp("category") + "/" +
+              build.name() + "/" + build.name() + ".info";
+  check = reader.open(info_file);
+  if (check != 0) { return 1; }
+  varnames[0] = "DOWNLOAD";
+  varnames[1] = "MD5SUM";
+  varnames[2] = "DOWNLOAD_x86_64";
+  varnames[3] = "MD5SUM_x86_64";
+  reader.read(varnames, values, default_vars);
+  reader.close();
+
+  // Same choice as sources_from_info in sboui-backend
+
+  if ( (! force32) && (uname(&sysinfo) == 0) &&
+       (std::string(sysinfo.machine) == "x86_64") && (trim(values[2]) != "") )
+  {
+    if (trim(values[2]) == "UNSUPPORTED") { return 2; }
+    urls = split(trim(values[2]));
+    md5sums = split(trim(values[3]));
+  }
+  else
+  {
+    if ( (! force32) && (trim(values[0]) == "UNSUPPORTED") ) { return 2; }
+    urls = split(trim(values[0]));
+    md5sums = split(trim(values[1]));
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+
 Gets SlackBuild version and reqs from repository
-Note: this function seems to be the biggest bottleneck for speed.
 
 *******************************************************************************/
 int get_repo_info(const BuildListItem & build, std::string & available_version,
@@ -294,17 +436,22 @@ int get_repo_info(const BuildListItem & build, std::string & available_version,
 {
   ShellReader reader;
   std::string info_file, slackbuild_file;
+  std::vector<std::string> varnames(2), values;
+  std::vector<bool> default_vars(2, false);
   int check;
 
-  // Read available version and requirements from .info file
+  // Read available version and requirements from .info file in one pass
 
   info_file = repo_dir + "/" + build.getProp("category") + "/" +
               build.name() + "/" + build.name() + ".info";
   check = reader.open(info_file);
   if (check == 0)
   { 
-    reader.read("VERSION", available_version);
-    reader.read("REQUIRES", reqs);
+    varnames[0] = "VERSION";
+    varnames[1] = "REQUIRES";
+    reader.read(varnames, values, default_vars);
+    available_version = values[0];
+    reqs = values[1];
     reader.close();
   }
   else { return check; }
@@ -357,43 +504,35 @@ void determine_installed(std::vector<std::vector<BuildListItem> > & slackbuilds,
                          std::vector<std::string> & pkg_errors,
                          std::vector<std::string> & missing_info)
 {
-  std::vector<std::string> installedpkgs;
-  std::string name, version, arch, build, curcategory, response;
-  unsigned int ninstalled, k;
-  int i, j, check, pkgcheck, infocheck;
+  std::vector<const installed_pkg *> installedpkgs;
+  const installed_pkg *entry;
+  int i, j, check, infocheck, ninstalled, k;
 
-  pkg_errors.resize(0);
+  reset_dep_graph();
+  installed_packages.read();
+  pkg_errors = installed_packages.invalid();
   missing_info.resize(0);
-  installedpkgs = list_installed_packages();
+  installedpkgs = installed_packages.list();
   ninstalled = installedpkgs.size();
-#pragma omp parallel for private(k,pkgcheck,name,version,arch,build,check,i,j,\
-                                 infocheck)
+#pragma omp parallel for private(k,entry,check,i,j,infocheck)
   for ( k = 0; k < ninstalled; k++ )
   {
-    // Check for invalid package names
-
-    pkgcheck = get_pkg_info(installedpkgs[k], name, version, arch, build);
-    if (pkgcheck != 0)
-    {
-#pragma omp critical
-      { pkg_errors.push_back(installedpkgs[k]); }
-      continue;
-    }
-    check = find_slackbuild(name, slackbuilds, i, j);
+    entry = installedpkgs[k];
+    check = find_slackbuild(entry->name, slackbuilds, i, j);
     if (check == 0)
     {
       slackbuilds[i][j].setBoolProp("installed", true);
-      slackbuilds[i][j].setProp("installed_version", version);
-      slackbuilds[i][j].parseBuildNum(build);
-      slackbuilds[i][j].setProp("package_name", installedpkgs[k]);
+      slackbuilds[i][j].setProp("installed_version", entry->version);
+      slackbuilds[i][j].parseBuildNum(entry->build);
+      slackbuilds[i][j].setProp("package_name", entry->pkg);
 
       slackbuilds[i][j].setBoolProp("blacklisted",
-                        blacklist.blacklisted(installedpkgs[k], name, version,
-                                              arch, build));
+                                    blacklist.blacklisted(*entry));
 
-      // Read props, set upgradable status, and check for missing .info file
+      // Read props (unless already read from the repository index), set
+      // upgradable status, and check for missing .info file
 
-      infocheck = slackbuilds[i][j].readPropsFromRepo();
+      infocheck = slackbuilds[i][j].readPropsFromRepo(true);
       if (infocheck != 0)
 #pragma omp critical
         { missing_info.push_back(slackbuilds[i][j].name()); }
@@ -431,24 +570,176 @@ int run_command(const std::string & cmd)
 
 /*******************************************************************************
 
+Returns the package name expected after building a SlackBuild from the repo,
+or an empty string if it cannot be guessed. The arch and tag are taken from the
+currently installed package, since they are not known otherwise.
+
+*******************************************************************************/
+std::string expected_package(const BuildListItem & build)
+{
+  const installed_pkg *entry;
+  std::size_t tagpos;
+
+  entry = installed_packages.find(build.name());
+  if ( (entry == NULL) || (build.getProp("available_version") == "") )
+    return "";
+
+  tagpos = entry->build.find_first_not_of("0123456789");
+  if (tagpos == std::string::npos) { tagpos = entry->build.size(); }
+
+  return build.name() + "-" + build.getProp("available_version") + "-" +
+         entry->arch + "-" + build.getProp("available_buildnum") +
+         entry->build.substr(tagpos);
+}
+
+/*******************************************************************************
+
+Returns true if a command to install a SlackBuild can be run by NativeBackend
+instead of sboui-backend: only with the built-in package manager, and only if
+the command has not been changed to something else.
+
+*******************************************************************************/
+bool native_command(const std::string & cmd)
+{
+  std::vector<std::string> words;
+
+  if ( (! native_backend) || (package_manager != "built-in") ) { return false; }
+  words = split(trim(cmd));
+
+  return ( (words.size() >= 2) && (words[0] == "sboui-backend") &&
+           (words[1] == "install") );
+}
+
+/*******************************************************************************
+
+Builds and installs a SlackBuild with NativeBackend, taking the same options as
+sboui-backend install. Returns 0 on success.
+
+*******************************************************************************/
+int run_native_backend(const BuildListItem & build, const std::string & vars,
+                       const std::string & opts)
+{
+  NativeBackend backend;
+  std::vector<std::string> words;
+  std::string sourcedir, pkgcache, pkg;
+  unsigned int i, nwords;
+  std::size_t pos;
+  bool force;
+  int check;
+
+  // Parse options like sboui-backend does
+
+  force = false;
+  words = split(opts);
+  nwords = words.size();
+  for ( i = 0; i < nwords; i++ )
+  {
+    pos = words[i].find('=');
+    if (words[i] == "") { continue; }
+    else if (words[i][0] == '-')
+    {
+      if ( (words[i] == "-f") || (words[i] == "--force") ) { force = true; }
+      else
+      {
+        std::cout << "Unrecognized install option " << words[i] << "."
+                  << std::endl;
+        return 1;
+      }
+    }
+    else if (pos == std::string::npos) { continue; }
+    else if (words[i].substr(0, pos) == "sourcedir")
+      sourcedir = words[i].substr(pos+1);
+    else if (words[i].substr(0, pos) == "pkgcache")
+      pkgcache = words[i].substr(pos+1);
+  }
+
+  backend.readConfig(vars);
+  check = backend.buildSlackBuild(build, vars, sourcedir, pkgcache, force,
+                                  false, pkg);
+  if ( (check != 0) || (pkg == "") ) { return check; }
+
+  return backend.installPackage(pkg);
+}
+
+/*******************************************************************************
+
+Looks up a SlackBuild in the package cache, when using the built-in package
+manager. Returns the package built before from the same inputs, if any.
+Otherwise, returns "" and sets cacheopt to the option telling sboui-backend
+where to store the package it builds, or to "" if the cache is not used. If
+rebuild is set, as for a reinstall chosen by the user, the cached package is
+not used, but the newly built one is still stored.
+
+*******************************************************************************/
+std::string find_cached_package(const BuildListItem & build,
+                                const std::string & vars,
+                                std::string & cacheopt, bool rebuild)
+{
+  PackageCache cache;
+  std::string key, pkg;
+
+  cacheopt = "";
+  if ( (package_manager != "built-in") || (package_cache == "") )
+    return "";
+
+  key = cache.inputKey(build, vars);
+  if (! rebuild) { pkg = cache.find(build, key); }
+  if (pkg == "") { cacheopt = "pkgcache=" + cache.storeDir(build, key); }
+
+  return pkg;
+}
+
+/*******************************************************************************
+
+Removes older packages of a SlackBuild from the package cache after it has been
+built. cacheopt is the option set by find_cached_package; its directory name is
+the input key of the new package.
+
+*******************************************************************************/
+void prune_cached_packages(const BuildListItem & build,
+                           const std::string & cacheopt)
+{
+  PackageCache cache;
+  std::size_t pos;
+
+  if (cacheopt == "") { return; }
+  pos = cacheopt.find_last_of('/');
+  if (pos == std::string::npos) { return; }
+  cache.prune(build, cacheopt.substr(pos+1));
+}
+
+/*******************************************************************************
+
 Installs a SlackBuild
 
 *******************************************************************************/
 int install_slackbuild(BuildListItem & build)
 {
-  std::string cmd;
+  std::string cmd, expected, pkg, cacheopt;
   int check;
-  std::vector<std::string> installedpkgs;
 
-  cmd = install_vars + " " + build.buildOptionsEnv() + " " + install_cmd
-      + " " + build.name() + " " + install_clos;
-  check = run_command(cmd);
+  pkg = find_cached_package(build, install_vars, cacheopt);
+  if (pkg != "") { return install_built_package(build, pkg, true); }
+
+  expected = expected_package(build);
+  if (native_command(install_cmd))
+  {
+    cmd = install_cmd + " " + install_clos + " " + cacheopt;
+    check = run_native_backend(build, install_vars, cmd);
+  }
+  else
+  {
+    cmd = install_vars + " " + build.buildOptionsEnv() + " " + install_cmd
+        + " " + build.name() + " " + install_clos + " " + cacheopt;
+    check = run_command(cmd);
+  }
   if (check != 0) { return check; }
+  prune_cached_packages(build, cacheopt);
 
   // Check to make sure it was actually installed and update properties
 
-  installedpkgs = list_installed_packages();
-  build.readInstalledProps(installedpkgs);
+  installed_packages.update(build.name(), expected);
+  build.readInstalledProps(installed_packages);
   if (build.getBoolProp("installed"))
   {
     build.readPropsFromRepo();
@@ -464,20 +755,32 @@ Upgrades a SlackBuild
 *******************************************************************************/
 int upgrade_slackbuild(BuildListItem & build)
 {
-  std::string cmd;
+  std::string cmd, expected, pkg, cacheopt;
   int check;
-  std::vector<std::string> installedpkgs;
 
-  cmd = upgrade_vars + " " + build.buildOptionsEnv() + " " + upgrade_cmd
-      + " " + build.name() + " " + upgrade_clos;
-  check = run_command(cmd);
+  pkg = find_cached_package(build, upgrade_vars, cacheopt);
+  if (pkg != "") { return install_built_package(build, pkg, true); }
+
+  expected = expected_package(build);
+  if (native_command(upgrade_cmd))
+  {
+    cmd = upgrade_cmd + " " + upgrade_clos + " " + cacheopt;
+    check = run_native_backend(build, upgrade_vars, cmd);
+  }
+  else
+  {
+    cmd = upgrade_vars + " " + build.buildOptionsEnv() + " " + upgrade_cmd
+        + " " + build.name() + " " + upgrade_clos + " " + cacheopt;
+    check = run_command(cmd);
+  }
   if (check != 0) { return check; }
+  prune_cached_packages(build, cacheopt);
 
   // If upgrade didn't work (maybe package manager doesn't think it's 
   //  upgradable), reinstall instead
 
-  installedpkgs = list_installed_packages();
-  build.readInstalledProps(installedpkgs);
+  installed_packages.update(build.name(), expected);
+  build.readInstalledProps(installed_packages);
   build.readPropsFromRepo();
   if (build.getBoolProp("upgradable"))
   {
@@ -495,19 +798,131 @@ Reinstalls a SlackBuild
 *******************************************************************************/
 int reinstall_slackbuild(BuildListItem & build)
 {
-  std::string cmd;
+  std::string cmd, expected, pkg, cacheopt;
   int check;
-  std::vector<std::string> installedpkgs;
 
-  cmd = install_vars + " " + build.buildOptionsEnv() + " " + reinstall_cmd
-      + " " + build.name() + " " + install_clos;
-  check = run_command(cmd);
+  // Unless the user asked for this reinstall (see InstallBox::create), a
+  // package built from the same inputs can be reinstalled from the cache
+
+  pkg = find_cached_package(build, install_vars, cacheopt,
+                            build.getBoolProp("rebuild"));
+  if (pkg != "") { return install_built_package(build, pkg, true); }
+
+  expected = expected_package(build);
+  if (native_command(reinstall_cmd))
+  {
+    cmd = reinstall_cmd + " " + install_clos + " " + cacheopt;
+    check = run_native_backend(build, install_vars, cmd);
+  }
+  else
+  {
+    cmd = install_vars + " " + build.buildOptionsEnv() + " " + reinstall_cmd
+        + " " + build.name() + " " + install_clos + " " + cacheopt;
+    check = run_command(cmd);
+  }
+  if (check != 0) { return check; }
+  prune_cached_packages(build, cacheopt);
+
+  // Check to make sure it was actually installed and update properties
+
+  installed_packages.update(build.name(), expected);
+  build.readInstalledProps(installed_packages);
+  if (build.getBoolProp("installed"))
+  {
+    build.readPropsFromRepo();
+    return 0;
+  }
+  else { return 1; }
+}
+
+/*******************************************************************************
+
+Environment variables and command-line options for building a SlackBuild with
+the built-in package manager
+
+*******************************************************************************/
+void build_vars_clos(const BuildListItem & build, const std::string & sourcedir,
+                     const std::string & cacheopt, std::string & vars,
+                     std::string & clos)
+{
+  if (build.getProp("action") == "Upgrade")
+  {
+    vars = upgrade_vars;
+    clos = upgrade_clos;
+  }
+  else
+  {
+    vars = install_vars;
+    clos = install_clos;
+  }
+
+  if (sourcedir != "") { clos += " sourcedir=" + sourcedir; }
+  if (cacheopt != "") { clos += " " + cacheopt; }
+}
+
+/*******************************************************************************
+
+Returns the command to build a SlackBuild with the built-in package manager
+without installing it. The path of the package is appended to pkgfile. If
+sourcedir is given, sources are copied from there instead of downloaded.
+cacheopt is the package cache option from find_cached_package.
+
+*******************************************************************************/
+std::string build_slackbuild_cmd(const BuildListItem & build,
+                                 const std::string & pkgfile,
+                                 const std::string & sourcedir,
+                                 const std::string & cacheopt)
+{
+  std::string vars, clos;
+
+  build_vars_clos(build, sourcedir, cacheopt, vars, clos);
+
+  return vars + " " + build.buildOptionsEnv() + " sboui-backend build "
+       + build.name() + " " + clos + " pkgfile=" + pkgfile;
+}
+
+/*******************************************************************************
+
+Installs a package made by the command from build_slackbuild_cmd, or one from
+the package cache. Cached packages are installed directly, so that
+sboui-backend does not remove them when CLEAN_PACKAGE is set.
+
+*******************************************************************************/
+int install_built_package(BuildListItem & build, const std::string & pkg,
+                          bool cached)
+{
+  NativeBackend backend;
+  std::string cmd, expected;
+  std::size_t pos;
+  int check;
+
+  // Package name is the file name without directory and extension
+
+  pos = pkg.find_last_of('/');
+  if (pos == std::string::npos) { expected = pkg; }
+  else { expected = pkg.substr(pos+1); }
+  pos = expected.find_last_of('.');
+  if (pos != std::string::npos) { expected = expected.substr(0, pos); }
+
+  if (cached)
+    std::cout << "Installing cached package " << pkg << std::endl;
+  if (native_command(install_cmd))
+  {
+    backend.readConfig();
+    check = backend.installPackage(pkg, cached);
+  }
+  else
+  {
+    if (cached) { cmd = "upgradepkg --reinstall --install-new " + pkg; }
+    else { cmd = "sboui-backend install-package " + pkg; }
+    check = run_command(cmd);
+  }
   if (check != 0) { return check; }
 
   // Check to make sure it was actually installed and update properties
 
-  installedpkgs = list_installed_packages();
-  build.readInstalledProps(installedpkgs);
+  installed_packages.update(build.name(), expected);
+  build.readInstalledProps(installed_packages);
   if (build.getBoolProp("installed"))
   {
     build.readPropsFromRepo();
@@ -525,7 +940,6 @@ int remove_slackbuild(BuildListItem & build)
 {
   std::string cmd;
   int check;
-  std::vector<std::string> installedpkgs;
 
   cmd = "removepkg " + build.getProp("package_name");
   check = run_command(cmd);
@@ -533,8 +947,8 @@ int remove_slackbuild(BuildListItem & build)
 
   // Check to make sure it was actually removed
 
-  installedpkgs = list_installed_packages();
-  build.readInstalledProps(installedpkgs);
+  installed_packages.updateRemoved(build.name());
+  build.readInstalledProps(installed_packages);
   if (build.getBoolProp("installed")) { return 1; }
   else { return 0; }
 }
@@ -644,6 +1058,27 @@ int sync_repo(bool interactive)
       std::string timestr(buffer);
       file << timestr << std::endl;
       file.close();
+
+      // Index READMEs and SlackBuild files now, so searches don't have to read
+      // them all
+
+      ReadmeIndex readme_index;
+      if (readme_index.writable())
+      {
+        std::cout << "Indexing READMEs ..." << std::endl;
+        if (readme_index.build() != 0)
+          std::cout << "Warning: unable to write README index to "
+                    << readme_index.path() << "." << std::endl;
+      }
+
+      ScriptIndex script_index;
+      if (script_index.writable())
+      {
+        std::cout << "Indexing SlackBuild files ..." << std::endl;
+        if (script_index.build() != 0)
+          std::cout << "Warning: unable to write SlackBuild file index to "
+                    << script_index.path() << "." << std::endl;
+      }
     }
     else
     {
@@ -660,3 +1095,11 @@ int sync_repo(bool interactive)
 
   return retval;
 }
+
+/*******************************************************************************
+
+Shows or prunes the source cache of the built-in package manager
+
+*******************************************************************************/
+int source_cache_stats() { return run_command("sboui-backend cache-stats"); }
+int prune_source_cache() { return run_command("sboui-backend cache-prune"); }
@@ -1,12 +1,23 @@
 #include <vector>
 #include <string>
+#include <unordered_set>
+#include <unordered_map>
+#include <utility>    // pair
+#include <algorithm>  // stable_sort
 #include <curses.h>
 #include "BuildListItem.h"
 #include "CategoryListItem.h"
 #include "CategoryListBox.h"
-#include "BuildListBox.h"
+#include "BuildListView.h"
 #include "string_util.h"
 #include "settings.h"   // repo_dir
+#include "requirements.h"   // get_dep_graph
+#include "ReadmeIndex.h"
+#include "ScriptSearch.h"
+#include "ScriptIndex.h"
+#include "FuzzyMatcher.h"
+#include "SearchSession.h"
+#include "BuildSet.h"
 #include "filters.h"
 
 /*******************************************************************************
@@ -17,19 +28,19 @@ Filtering functions that may be passed to filter_by_func
 bool any_build(const BuildListItem & build) { return true; }
 bool build_is_installed(const BuildListItem & build)
 {
-  return build.getBoolProp("installed");
+  return build.installed();
 }
 bool build_is_upgradable(const BuildListItem & build)
 {
-  return build.getBoolProp("upgradable");
+  return build.upgradable();
 }
 bool build_is_tagged(const BuildListItem & build)
 {
-  return build.getBoolProp("tagged");
+  return build.tagged();
 }
 bool build_is_blacklisted(const BuildListItem & build)
 {
-  return build.getBoolProp("blacklisted");
+  return build.blacklisted();
 }
 bool build_has_buildoptions(const BuildListItem & build)
 {
@@ -54,7 +65,7 @@ std::vector<BuildListItem *> list_installed(
     nbuilds = slackbuilds[i].size();
     for ( j = 0; j < nbuilds; j++ )
     {
-      if (slackbuilds[i][j].getBoolProp("installed"))
+      if (slackbuilds[i][j].installed())
         installedlist.push_back(&slackbuilds[i][j]);
     }
   }
@@ -65,73 +76,102 @@ std::vector<BuildListItem *> list_installed(
 /*******************************************************************************
 
 Creates list of installed SlackBuilds that are not required by any other
-installed SlackBuild
+installed SlackBuild, using the dependency graph
 
 *******************************************************************************/
 std::vector<BuildListItem *> list_nondeps(
                          std::vector<std::vector<BuildListItem> > & slackbuilds)
 {
-  std::vector<BuildListItem *> installedlist, nondeplist;
-  unsigned int i, j, k, ninstalled, ndeps;
-  bool isdep;
-  std::vector<std::string> deplist;
+  std::vector<BuildListItem *> nondeplist;
 
-  installedlist = list_installed(slackbuilds);
-
-  // N^2 (max) loop through installed packages to see which are dependencies
-
-  ninstalled = installedlist.size();
-  for ( i = 0; i < ninstalled; i++ )
-  {
-    isdep = false;
-    for ( j = 0; j < ninstalled; j++ )
-    {
-      if (j == i) { continue; }
-      deplist = split(installedlist[j]->getProp("requires"));
-      ndeps = deplist.size();
-      for ( k = 0; k < ndeps; k++ )
-      {
-        if (deplist[k] == installedlist[i]->name())
-        {
-          isdep = true;
-          break;
-        }
-      }
-      if (isdep) { break; }
-    } 
-    if (! isdep) { nondeplist.push_back(installedlist[i]); }
-  } 
+  get_dep_graph(slackbuilds).nonDeps(nondeplist);
 
   return nondeplist;
 }
 
 /*******************************************************************************
 
-Overwrites input lists using the contents of BuildListBoxes and CategoryListBox.
+Overwrites input lists using the contents of a list view
 
 *******************************************************************************/
 void overwrite_lists(std::vector<std::vector<BuildListItem *> > & slackbuilds,
                      std::vector<CategoryListItem *> & categories,
-                     std::vector<BuildListBox> & blistboxes,
-                     CategoryListBox & clistbox)
+                     const BuildListView & view)
 {
   unsigned int i, j, nbuilds, ncategories;
 
-  categories.clear();
-  slackbuilds.clear();
-  ncategories = clistbox.numItems();
+  ncategories = view.numCategories();
   categories.resize(ncategories);
   slackbuilds.resize(ncategories);
   for ( i = 0; i < ncategories; i++ )
   {
-    categories[i] = static_cast<CategoryListItem *>(clistbox.itemByIdx(i));
-    nbuilds = blistboxes[i].numItems();
+    categories[i] = view.category(i);
+    nbuilds = view.numBuilds(i);
     slackbuilds[i].resize(nbuilds);
-    for ( j = 0; j < nbuilds; j++ )
+    for ( j = 0; j < nbuilds; j++ ) { slackbuilds[i][j] = view.build(i, j); }
+  }
+}
+
+/*******************************************************************************
+
+Reorders a list view and the category list by rank: categories in order of
+their best-ranked SlackBuild, and SlackBuilds within each category in rank
+order. ranked must hold every SlackBuild in the view. The input lists are not
+changed, since patchLists and further filters rely on them being in name order.
+
+*******************************************************************************/
+void rank_view(const std::vector<BuildListItem *> & ranked,
+               CategoryListBox & clistbox, BuildListView & view)
+{
+  unsigned int i, ncategories, nranked, idx;
+  std::unordered_map<std::string, CategoryListItem *> category_items;
+  std::unordered_map<std::string, unsigned int> category_order;
+  std::unordered_map<std::string, unsigned int>::const_iterator it;
+  std::vector<CategoryListItem *> categories;
+  std::vector<std::vector<BuildListItem *> > builds;
+
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    category_items[view.category(i)->name()] = view.category(i);
+  }
+
+  nranked = ranked.size();
+  for ( i = 0; i < nranked; i++ )
+  {
+    it = category_order.find(ranked[i]->getProp("category"));
+    if (it == category_order.end())
     {
-      slackbuilds[i][j] = static_cast<BuildListItem *>(blistboxes[i].itemByIdx(j));
+      idx = categories.size();
+      category_order[ranked[i]->getProp("category")] = idx;
+      categories.push_back(category_items[ranked[i]->getProp("category")]);
+      builds.resize(idx+1);
     }
+    else { idx = it->second; }
+    builds[idx].push_back(ranked[i]);
   }
+
+  view.clear();
+  clistbox.clearList();
+  ncategories = categories.size();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    clistbox.addItem(categories[i]);
+    view.addCategory(categories[i]);
+    nranked = builds[i].size();
+    for ( idx = 0; idx < nranked; idx++ ) { view.addBuild(builds[i][idx]); }
+  }
+}
+
+/*******************************************************************************
+
+Orders README matches by number of occurrences, most first
+
+*******************************************************************************/
+bool more_occurrences(const std::pair<unsigned int, BuildListItem *> & a,
+                      const std::pair<unsigned int, BuildListItem *> & b)
+{
+  return (a.first > b.first);
 }
 
 /*******************************************************************************
@@ -142,20 +182,17 @@ Filters lists by bool function taking BuildListItem as parameter.
 void filter_by_func(std::vector<std::vector<BuildListItem *> > & slackbuilds,
                     bool (*func)(const BuildListItem &),
                     std::vector<CategoryListItem *> & categories,
-                    WINDOW *blistboxwin, CategoryListBox & clistbox,
-                    std::vector<BuildListBox> & blistboxes,
+                    CategoryListBox & clistbox, BuildListView & view,
                     unsigned int & nfiltered, bool overwrite)
 {
-  unsigned int i, j, ncategories, nbuilds, nfiltered_categories;
+  unsigned int i, j, ncategories, nbuilds;
   bool category_found;
-  BuildListBox initlistbox;
 
   ncategories = categories.size();
-  blistboxes.resize(0);
+  view.clear();
   clistbox.clearList();
   clistbox.setActivated(true);
   nfiltered = 0; 
-  nfiltered_categories = 0;
 
   for ( i = 0; i < ncategories; i++ )
   {
@@ -169,14 +206,9 @@ void filter_by_func(std::vector<std::vector<BuildListItem *> > & slackbuilds,
         {
           category_found = true;
           clistbox.addItem(categories[i]);
-          BuildListBox blistbox;
-          blistbox.setWindow(blistboxwin);
-          blistbox.setName(categories[i]->name());
-          blistbox.setActivated(false);
-          nfiltered_categories++;
-          blistboxes.push_back(blistbox);
+          view.addCategory(categories[i]);
         }
-        blistboxes[nfiltered_categories-1].addItem(slackbuilds[i][j]);
+        view.addBuild(slackbuilds[i][j]);
         nfiltered++;
       }
     }
@@ -184,152 +216,145 @@ void filter_by_func(std::vector<std::vector<BuildListItem *> > & slackbuilds,
 
   // Check whether categories should be tagged
 
-  for ( i = 0; i < nfiltered_categories; i++ )
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
   {
-    if (blistboxes[i].allTagged()) 
+    if (view.allTagged(i))
       clistbox.itemByIdx(i)->setBoolProp("tagged", true);
     else 
       clistbox.itemByIdx(i)->setBoolProp("tagged", false);
   }
 
-  // Initialize with empty lists if filter is empty
-
-  if (nfiltered == 0)
-  {
-    initlistbox.setWindow(blistboxwin);
-    initlistbox.setActivated(false);
-    initlistbox.setName("SlackBuilds");
-    blistboxes.push_back(initlistbox);
-  }
-
   // Overwrite input lists if requested
   if (overwrite)
-    overwrite_lists(slackbuilds, categories, blistboxes, clistbox);
+    overwrite_lists(slackbuilds, categories, view);
 }
 
 /*******************************************************************************
 
-Filters lists by non-dependencies. all_slackbuilds is the list of all
-slackbuilds in the repo; slackbuilds is the input list (which could
-be the same as all_slackbuilds).
+Index of README words used for searches. It is loaded the first time it is
+needed and reloaded or rebuilt when the repository changes. Returns true if
+the index can be used.
 
 *******************************************************************************/
-void filter_nondeps(std::vector<std::vector<BuildListItem> > & all_slackbuilds,
-                    std::vector<std::vector<BuildListItem *> > & slackbuilds,
-                    std::vector<CategoryListItem *> & categories,
-                    WINDOW *blistboxwin, CategoryListBox & clistbox,
-                    std::vector<BuildListBox> & blistboxes,
-                    unsigned int & nnondeps, bool overwrite)
+ReadmeIndex readme_index;
+
+bool readme_index_ready()
 {
-  unsigned int i, j, k, ncategories, nbuilds, nfiltered_categories;
-  std::vector<std::string> filtered_categories;
-  bool category_found;
-  BuildListBox initlistbox;
-  std::vector<BuildListItem *> allnondeplist, nondeplist;
+  if (readme_index.current()) { return true; }
+  if (readme_index.load() == 0) { return true; }
+  if (! readme_index.writable()) { return false; }
+  if (readme_index.build() != 0) { return false; }
 
-  // Get a list of all nondeps
-  allnondeplist = list_nondeps(all_slackbuilds);
-  nnondeps = allnondeplist.size();
-  ncategories = categories.size();
-  blistboxes.resize(0);
-  clistbox.clearList();
-  clistbox.setActivated(true);
-  filtered_categories.resize(0);
+  return (readme_index.load() == 0);
+}
 
-  // Recreate nondeplist based only on slackbuilds in the input list
-  for ( i = 0; i < ncategories; i++ )
+/*******************************************************************************
+
+Trigram index of SlackBuild files, used the same way as the README index. It
+is rebuilt incrementally when the repository changes.
+
+*******************************************************************************/
+ScriptIndex script_index;
+
+bool script_index_ready()
+{
+  if (script_index.current()) { return true; }
+  if (script_index.load() == 0) { return true; }
+  if (! script_index.writable()) { return false; }
+  if (script_index.build() != 0) { return false; }
+
+  return (script_index.load() == 0);
+}
+
+/*******************************************************************************
+
+Checks files of SlackBuilds in lists for a match. Only candidates from the
+trigram index are read, if it is available, and they are checked in parallel.
+
+*******************************************************************************/
+void find_in_scripts(const ScriptSearch & query,
+                     std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                     std::vector<std::vector<char> > & matches)
+{
+  std::vector<std::string> candidates;
+  std::unordered_set<std::string> candidate_set;
+  std::vector<BuildListItem *> tocheck;
+  std::vector<std::pair<unsigned int, unsigned int> > positions;
+  std::string key;
+  unsigned int i, j, ncategories, nbuilds;
+  bool use_index;
+  int k, ncheck;
+
+  use_index = false;
+  if (script_index_ready())
   {
-      nbuilds = slackbuilds[i].size();
-      for ( j = 0; j < nbuilds; j++ )
-      {
-          for ( k = 0; k < nnondeps; k++ )
-          {
-              if (slackbuilds[i][j]->name() == allnondeplist[k]->name())
-              {
-                  nondeplist.push_back(slackbuilds[i][j]);
-                  break;
-              }
-          }
-      }
+    use_index = true;
+    script_index.candidates(query, candidates);
+    candidate_set.insert(candidates.begin(), candidates.end());
   }
-  nnondeps = nondeplist.size();
 
-  for ( i = 0; i < nnondeps; i++ )
+  ncategories = slackbuilds.size();
+  matches.resize(ncategories);
+  for ( i = 0; i < ncategories; i++ )
   {
-    category_found = false;
-    nfiltered_categories = filtered_categories.size();
-    for ( j = 0; j < nfiltered_categories; j++ )
-    {
-      if (nondeplist[i]->getProp("category") == filtered_categories[j])
-      {
-        blistboxes[j].addItem(nondeplist[i]);
-        category_found = true;
-        break;
-      }
-    }
-    if (! category_found)
+    nbuilds = slackbuilds[i].size();
+    matches[i].assign(nbuilds, 0);
+    for ( j = 0; j < nbuilds; j++ )
     {
-      for ( j = 0; j < ncategories; j++ )
-      {
-        if (nondeplist[i]->getProp("category") == categories[j]->name())
-        {
-          clistbox.addItem(categories[j]);
-          BuildListBox blistbox;
-          blistbox.setWindow(blistboxwin);
-          blistbox.setName(categories[j]->name());
-          blistbox.setActivated(false);
-          blistbox.addItem(nondeplist[i]);
-          blistboxes.push_back(blistbox);
-          filtered_categories.push_back(nondeplist[i]->getProp("category"));
-          break;
-        }
-      }
+      key = slackbuilds[i][j]->getProp("category") + "/"
+          + slackbuilds[i][j]->name();
+      if ( use_index && (candidate_set.find(key) == candidate_set.end()) )
+        continue;
+      tocheck.push_back(slackbuilds[i][j]);
+      positions.push_back(std::make_pair(i, j));
     }
   }
 
-  // Check whether categories should be tagged
-
-  nfiltered_categories = filtered_categories.size();
-  for ( j = 0; j < nfiltered_categories; j++ )
+  ncheck = tocheck.size();
+#pragma omp parallel for schedule(dynamic,8)
+  for ( k = 0; k < ncheck; k++ )
   {
-    if (blistboxes[j].allTagged()) 
-      clistbox.itemByIdx(j)->setBoolProp("tagged", true);
-    else 
-      clistbox.itemByIdx(j)->setBoolProp("tagged", false);
-  }
-
-  // Initialize with empty lists if filter is empty
+    std::string builddir;
 
-  if (nnondeps == 0)
-  {
-    initlistbox.setWindow(blistboxwin);
-    initlistbox.setActivated(false);
-    initlistbox.setName("SlackBuilds");
-    blistboxes.push_back(initlistbox);
+    builddir = settings::repo_dir + "/" + tocheck[k]->getProp("category")
+             + "/" + tocheck[k]->name();
+    if (query.matchesBuild(builddir))
+      matches[positions[k].first][positions[k].second] = 1;
   }
-
-  // Overwrite input lists if requested
-  if (overwrite)
-    overwrite_lists(slackbuilds, categories, blistboxes, clistbox);
 }
 
 /*******************************************************************************
 
-Filters lists by search term
+Filters lists by search term. READMEs are searched using the README index
+when possible. Results are shown ranked: name matches first, then README
+matches by how often the README mentions the search term (when the index gives
+counts). If given, best_match is set to the top-ranked SlackBuild. If
+search_scripts is set, all files in SlackBuild directories are searched
+instead of names and READMEs, optionally for a regular expression, and results
+are shown in name order.
 
 *******************************************************************************/
 void filter_search(std::vector<std::vector<BuildListItem *> > & slackbuilds,
                    std::vector<CategoryListItem *> & categories,
-                   WINDOW *blistboxwin, CategoryListBox & clistbox,
-                   std::vector<BuildListBox> & blistboxes,
+                   CategoryListBox & clistbox, BuildListView & view,
                    unsigned int & nsearch, const std::string & searchterm,
                    bool case_sensitive, bool whole_word, bool search_readmes,
-                   bool overwrite)
+                   bool search_scripts, bool use_regex, bool overwrite,
+                   BuildListItem **best_match)
 {
-  unsigned int i, j, nbuilds, ncategories, nsearch_categories;
-  std::string term, tomatch, readme_file;
-  bool match, category_found;
-  BuildListBox initlistbox;
+  unsigned int i, j, k, nbuilds, ncategories, nreadmes, count;
+  std::string term, tomatch, key;
+  bool match, category_found, use_index, check_readmes;
+  std::vector<BuildListItem *> ranked;
+  std::vector<std::pair<unsigned int, BuildListItem *> > readme_ranked;
+  std::vector<readme_match> readme_matches;
+  std::unordered_map<std::string, unsigned int> readme_counts;
+  std::unordered_map<std::string, unsigned int>::const_iterator it;
+  std::vector<std::vector<char> > script_matches, hits;
+  std::vector<std::string> readme_files;
+  std::vector<std::pair<unsigned int, unsigned int> > readme_positions;
+  std::vector<char> readme_found;
 
   // For case insensitive search, convert both to lower case
 
@@ -337,75 +362,367 @@ void filter_search(std::vector<std::vector<BuildListItem *> > & slackbuilds,
   else { term = string_to_lower(searchterm); }
 
   ncategories = categories.size();
-  blistboxes.resize(0);
+  view.clear();
   clistbox.clearList();
   clistbox.setActivated(true);
   nsearch = 0;
-  nsearch_categories = 0;
 
+  // Look up README matches in index. If the index only gives candidates,
+  // READMEs of candidates are still checked.
+
+  use_index = false;
+  check_readmes = true;
+  if (search_scripts)
+  {
+    search_readmes = false;
+    find_in_scripts(ScriptSearch(searchterm, whole_word, case_sensitive,
+                    use_regex), slackbuilds, script_matches);
+  }
+  else if ( (search_readmes) && (readme_index_ready()) )
+  {
+    use_index = true;
+    check_readmes = (readme_index.search(searchterm, whole_word,
+                                         case_sensitive, readme_matches) != 0);
+    nreadmes = readme_matches.size();
+    for ( i = 0; i < nreadmes; i++ )
+    {
+      key = readme_matches[i].category + "/" + readme_matches[i].name;
+      readme_counts[key] = readme_matches[i].count;
+    }
+  }
+
+  // Check names, and list READMEs that must be read
+
+  hits.resize(ncategories);
   for ( i = 0; i < ncategories; i++ )
   {
-    category_found = false;
     nbuilds = slackbuilds[i].size();
+    hits[i].assign(nbuilds, 0);
     for ( j = 0; j < nbuilds; j++ )
     {
-      // Check for search term in SlackBuild name
+      // Check for search term in SlackBuild name, or in all its files
 
       if (case_sensitive) { tomatch = slackbuilds[i][j]->name(); }
       else { tomatch = string_to_lower(slackbuilds[i][j]->name()); }
-      if (whole_word) { match = (term == tomatch); }
+      if (search_scripts) { match = script_matches[i][j]; }
+      else if (whole_word) { match = (term == tomatch); }
       else { match = (tomatch.find(term) != std::string::npos); }
+      if (match)
+      {
+        hits[i][j] = 1;
+        continue;
+      }
+      if (! search_readmes) { continue; }
 
-      // Check for search term in README
+      // README matches from index, or READMEs to check
 
-      if ( (! match) && (search_readmes) )
+      key = slackbuilds[i][j]->getProp("category") + "/"
+          + slackbuilds[i][j]->name();
+      if (use_index)
       {
-        readme_file = settings::repo_dir + "/" + 
-                    slackbuilds[i][j]->getProp("category") + "/"  +
-                    slackbuilds[i][j]->name() + "/README";
-        match = find_in_file(searchterm, readme_file, whole_word,
-                             case_sensitive);
+        if (readme_counts.find(key) == readme_counts.end()) { continue; }
+        if (! check_readmes)
+        {
+          hits[i][j] = 2;
+          continue;
+        }
       }
+      readme_files.push_back(settings::repo_dir + "/" + key + "/README");
+      readme_positions.push_back(std::make_pair(i, j));
+    }
+  }
+
+  // Search READMEs in parallel
 
+  find_in_files(searchterm, readme_files, readme_found, whole_word,
+                case_sensitive);
+  nreadmes = readme_files.size();
+  for ( k = 0; k < nreadmes; k++ )
+  {
+    if (readme_found[k])
+      hits[readme_positions[k].first][readme_positions[k].second] = 2;
+  }
+
+  for ( i = 0; i < ncategories; i++ )
+  {
+    category_found = false;
+    nbuilds = slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      match = (hits[i][j] != 0);
       if (! match) { continue; }
 
+      // Rank README matches by number of occurrences
+
+      if (hits[i][j] == 1) { ranked.push_back(slackbuilds[i][j]); }
+      else
+      {
+        count = 0;
+        if (use_index)
+        {
+          key = slackbuilds[i][j]->getProp("category") + "/"
+              + slackbuilds[i][j]->name();
+          it = readme_counts.find(key);
+          if (it != readme_counts.end()) { count = it->second; }
+        }
+        readme_ranked.push_back(std::make_pair(count, slackbuilds[i][j]));
+      }
+
       if (! category_found)
       {
         category_found = true;
         clistbox.addItem(categories[i]);
-        BuildListBox blistbox; 
-        blistbox.setWindow(blistboxwin);
-        blistbox.setName(categories[i]->name());
-        blistbox.setActivated(false);
-        nsearch_categories++;
-        blistboxes.push_back(blistbox);
+        view.addCategory(categories[i]);
       }
-      blistboxes[nsearch_categories-1].addItem(slackbuilds[i][j]);
+      view.addBuild(slackbuilds[i][j]);
       nsearch++;
     } 
   }
+  std::stable_sort(readme_ranked.begin(), readme_ranked.end(),
+                   more_occurrences);
+  nreadmes = readme_ranked.size();
+  for ( k = 0; k < nreadmes; k++ )
+  {
+    ranked.push_back(readme_ranked[k].second);
+  }
+  if (best_match)
+  {
+    if (ranked.size() > 0) { *best_match = ranked[0]; }
+    else { *best_match = NULL; }
+  }
+
+  // Overwrite input lists if requested, in name order, then show ranked
+  if (overwrite)
+    overwrite_lists(slackbuilds, categories, view);
+  if (! search_scripts) { rank_view(ranked, clistbox, view); }
+
+  // Check whether categories should be tagged
+
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    if (view.allTagged(i))
+      clistbox.itemByIdx(i)->setBoolProp("tagged", true);
+    else 
+      clistbox.itemByIdx(i)->setBoolProp("tagged", false);
+  }
+}
+
+/*******************************************************************************
+
+Filters lists to the best fuzzy matches of a query by name, shown in order of
+decreasing score. The matcher must have been set up from the same lists. At
+most max_results are kept, but nmatches is set to the number of names that
+match. If overwritten, the input lists stay in name order. best_match (if
+given) is set to the highest-scoring SlackBuild.
+
+*******************************************************************************/
+void filter_fuzzy(std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                  std::vector<CategoryListItem *> & categories,
+                  CategoryListBox & clistbox, BuildListView & view,
+                  unsigned int & nmatches, const FuzzyMatcher & matcher,
+                  const std::string & query, unsigned int max_results,
+                  bool overwrite, BuildListItem **best_match)
+{
+  unsigned int i, j, ncategories, nbuilds, nkept;
+  bool category_found;
+  std::vector<fuzzy_match> matches;
+  std::vector<std::vector<char> > matched;
+  std::vector<BuildListItem *> ranked;
+
+  nmatches = matcher.match(query, max_results, matches);
+  nkept = matches.size();
+  ncategories = categories.size();
+  matched.resize(ncategories);
+  for ( i = 0; i < ncategories; i++ )
+  {
+    matched[i].assign(slackbuilds[i].size(), 0);
+  }
+  for ( i = 0; i < nkept; i++ )
+  {
+    matched[matches[i].category][matches[i].index] = 1;
+    ranked.push_back(slackbuilds[matches[i].category][matches[i].index]);
+  }
+  if (best_match)
+  {
+    if (nkept > 0) { *best_match = ranked[0]; }
+    else { *best_match = NULL; }
+  }
+
+  view.clear();
+  clistbox.clearList();
+  clistbox.setActivated(true);
+
+  for ( i = 0; i < ncategories; i++ )
+  {
+    category_found = false;
+    nbuilds = slackbuilds[i].size();
+    for ( j = 0; j < nbuilds; j++ )
+    {
+      if (! matched[i][j]) { continue; }
+      if (! category_found)
+      {
+        category_found = true;
+        clistbox.addItem(categories[i]);
+        view.addCategory(categories[i]);
+      }
+      view.addBuild(slackbuilds[i][j]);
+    }
+  }
+
+  // Overwrite input lists if requested, in name order, then show ranked
+  if (overwrite)
+    overwrite_lists(slackbuilds, categories, view);
+  rank_view(ranked, clistbox, view);
+
+  // Check whether categories should be tagged
+
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    if (view.allTagged(i))
+      clistbox.itemByIdx(i)->setBoolProp("tagged", true);
+    else 
+      clistbox.itemByIdx(i)->setBoolProp("tagged", false);
+  }
+}
+
+/*******************************************************************************
+
+Filters SlackBuilds by the matches of an incremental search session. Only the
+matches are visited, not the whole input list.
+
+*******************************************************************************/
+void filter_session(std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                    std::vector<CategoryListItem *> & categories,
+                    CategoryListBox & clistbox, BuildListView & view,
+                    unsigned int & nmatches, const SearchSession & session,
+                    const std::string & query, bool overwrite,
+                    BuildListItem **best_match)
+{
+  unsigned int i, j, ncategories, category, prev_category;
+  int best;
+
+  nmatches = session.numMatches();
+  if (best_match)
+  {
+    best = session.bestMatch(query);
+    if (best >= 0)
+      *best_match = slackbuilds[session.category(best)][session.index(best)];
+    else { *best_match = NULL; }
+  }
+
+  view.clear();
+  clistbox.clearList();
+  clistbox.setActivated(true);
+  prev_category = categories.size();
+
+  for ( i = 0; i < nmatches; i++ )
+  {
+    category = session.category(i);
+    j = session.index(i);
+    if (category != prev_category)
+    {
+      prev_category = category;
+      clistbox.addItem(categories[category]);
+      view.addCategory(categories[category]);
+    }
+    view.addBuild(slackbuilds[category][j]);
+  }
 
   // Check whether categories should be tagged
 
-  for ( i = 0; i < nsearch_categories; i++ )
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
   {
-    if (blistboxes[i].allTagged()) 
+    if (view.allTagged(i))
       clistbox.itemByIdx(i)->setBoolProp("tagged", true);
     else 
       clistbox.itemByIdx(i)->setBoolProp("tagged", false);
   }
 
-  // Initialize with empty lists if filter is empty
+  // Overwrite input lists if requested
+  if (overwrite)
+    overwrite_lists(slackbuilds, categories, view);
+}
+
+/*******************************************************************************
+
+Filters lists by a BuildSet. Lists are built from all_slackbuilds, the master
+list, so the set alone decides what is shown.
+
+*******************************************************************************/
+void filter_by_set(std::vector<std::vector<BuildListItem> > & all_slackbuilds,
+                   std::vector<CategoryListItem> & all_categories,
+                   const BuildSet & set,
+                   std::vector<std::vector<BuildListItem *> > & slackbuilds,
+                   std::vector<CategoryListItem *> & categories,
+                   CategoryListBox & clistbox, BuildListView & view,
+                   unsigned int & nfiltered, bool overwrite)
+{
+  unsigned int i, j, ncategories, nbuilds, first, id;
+  bool category_found;
+
+  ncategories = all_categories.size();
+  view.clear();
+  clistbox.clearList();
+  clistbox.setActivated(true);
+  nfiltered = 0;
+
+  for ( i = 0; i < ncategories; i++ )
+  {
+    category_found = false;
+    nbuilds = all_slackbuilds[i].size();
+    if (nbuilds == 0) { continue; }
+
+    // IDs are consecutive within a category, so only set bits are visited
+
+    first = all_slackbuilds[i][0].id();
+    for ( id = set.next(first); id < first + nbuilds; id = set.next(id+1) )
+    {
+      j = id - first;
+      if (! category_found)
+      {
+        category_found = true;
+        clistbox.addItem(&all_categories[i]);
+        view.addCategory(&all_categories[i]);
+      }
+      view.addBuild(&all_slackbuilds[i][j]);
+      nfiltered++;
+    }
+  }
+
+  // Check whether categories should be tagged
 
-  if (nsearch == 0)
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
   {
-    initlistbox.setWindow(blistboxwin);
-    initlistbox.setActivated(false);
-    initlistbox.setName("SlackBuilds");
-    blistboxes.push_back(initlistbox);
+    if (view.allTagged(i))
+      clistbox.itemByIdx(i)->setBoolProp("tagged", true);
+    else 
+      clistbox.itemByIdx(i)->setBoolProp("tagged", false);
   }
 
   // Overwrite input lists if requested
   if (overwrite)
-    overwrite_lists(slackbuilds, categories, blistboxes, clistbox);
+    overwrite_lists(slackbuilds, categories, view);
+}
+
+/*******************************************************************************
+
+Gets the set of SlackBuilds in a list view
+
+*******************************************************************************/
+void list_build_set(const BuildListView & view, unsigned int nbuilds,
+                    BuildSet & set)
+{
+  unsigned int i, j, ncategories, ncatbuilds;
+
+  set.reset(nbuilds, false);
+  ncategories = view.numCategories();
+  for ( i = 0; i < ncategories; i++ )
+  {
+    ncatbuilds = view.numBuilds(i);
+    for ( j = 0; j < ncatbuilds; j++ ) { set.set(view.build(i, j)->id()); }
+  }
 }
@@ -0,0 +1,71 @@
+#include <string>
+#include <cstddef>      // size_t
+#include <stdint.h>
+#include <unistd.h>     // access
+#include "index_util.h"
+
+/*******************************************************************************
+
+Appends a string to the string blob and returns its location
+
+*******************************************************************************/
+index_string index_add_string(std::string & blob, const std::string & str)
+{
+  index_string istr;
+
+  istr.offset = blob.size();
+  istr.len = str.size();
+  blob += str;
+
+  return istr;
+}
+
+/*******************************************************************************
+
+Gets a string from the string blob. Returns 1 if it is out of bounds.
+
+*******************************************************************************/
+int index_get_string(const char *blob, uint64_t blob_len,
+                     const index_string & istr, std::string & str)
+{
+  if (uint64_t(istr.offset) + uint64_t(istr.len) > blob_len) { return 1; }
+  str.assign(blob + istr.offset, istr.len);
+
+  return 0;
+}
+
+/*******************************************************************************
+
+Returns true if an index file can be written at path (i.e., its directory
+exists and is writable)
+
+*******************************************************************************/
+bool index_writable(const std::string & path)
+{
+  std::size_t lastsep;
+  std::string dir;
+
+  lastsep = path.find_last_of('/');
+  if (lastsep == std::string::npos) { dir = "."; }
+  else { dir = path.substr(0, lastsep); }
+
+  return (access(dir.c_str(), W_OK) == 0);
+}
+
+/*******************************************************************************
+
+Adds bytes to an FNV-1a hash. Start from index_hash_basis.
+
+*******************************************************************************/
+void index_hash_bytes(uint64_t & hash, const void *data, std::size_t len)
+{
+  const unsigned char *bytes;
+  std::size_t i;
+
+  bytes = static_cast<const unsigned char *>(data);
+  for ( i = 0; i < len; i++ )
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+}
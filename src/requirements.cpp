@@ -1,132 +1,66 @@
 #include <string>
 #include <vector>
-#include <algorithm>       // reverse, max
 #include "BuildListItem.h"
-#include "backend.h"       // get_reqs, find_slackbuild, list_installed
-#include "string_util.h"   // split
+#include "DepGraph.h"
 #include "requirements.h"
 
+// Dependency graph of the SlackBuilds list, built the first time it is needed
+// after the list has been (re-)read
+
+DepGraph dep_graph;
+const std::vector<std::vector<BuildListItem> > *graphed_slackbuilds = NULL;
+
 /*******************************************************************************
 
-Adds required SlackBuild to dependency list, removing any instance already
-present in the list
+Marks dependency graph as out of date. Must be called whenever the list of
+SlackBuilds is re-read.
 
 *******************************************************************************/
-void add_req(BuildListItem * build,
-             std::vector<BuildListItem *> & reqlist)
+void reset_dep_graph()
 {
-  unsigned int i, nreqs;
-
-  nreqs = reqlist.size();
-  for ( i = 0; i < nreqs; i++ )
-  {
-    if (reqlist[i]->name() == build->name()) 
-    { 
-      reqlist.erase(reqlist.begin()+i); 
-      break;
-    }
-  }
-  reqlist.push_back(build);
+  dep_graph.clear();
+  graphed_slackbuilds = NULL;
 }
 
 /*******************************************************************************
 
-Recursively computes list of requirements for a SlackBuild. List must be
-reversed after calling this to get the proper build order. Returns 1 if a
-requirement is not found in the list, 2 if a .info file is missing, or 0
-otherwise
+Returns dependency graph for the list of SlackBuilds, building it if needed
 
 *******************************************************************************/
-int get_reqs_recursive(const BuildListItem & build,
-                       std::vector<BuildListItem *> & reqlist,
-                       std::vector<std::vector<BuildListItem> > & slackbuilds)
+const DepGraph & get_dep_graph(
+                         std::vector<std::vector<BuildListItem> > & slackbuilds)
 {
-  unsigned int i, ndeps;
-  std::vector<std::string> deplist;
-  std::string reqs;
-  int idx0, idx1, check, maxcheck;
-
-  if (build.getBoolProp("installed")) { deplist = 
-                                        split(build.getProp("requires")); }
-  else 
+  if (graphed_slackbuilds != &slackbuilds)
   {
-    check = get_reqs(build, reqs);
-    if (check == 0) { deplist = split(reqs); }
-    else { return 2; }
-  }
-  
-  maxcheck = 0;
-  check = 0;
-  ndeps = deplist.size();
-  for ( i = 0; i < ndeps; i++ )
-  { 
-    if (deplist[i] != "%README%")
-    { 
-      check = find_slackbuild(deplist[i], slackbuilds, idx0, idx1);
-      if (check == 0)
-      {
-        add_req(&slackbuilds[idx0][idx1], reqlist);
-        check = get_reqs_recursive(slackbuilds[idx0][idx1], reqlist, slackbuilds); 
-      }
-      else { check = 1; }
-      maxcheck = std::max(check, maxcheck);
-    }
+    dep_graph.build(slackbuilds);
+    graphed_slackbuilds = &slackbuilds;
   }
 
-  return maxcheck;
+  return dep_graph;
 }
 
 /*******************************************************************************
 
 Computes list of requirements needed for a SlackBuild in the correct build
-order. 
+order. Returns 1 if a requirement is not found in the list, 2 if a .info file
+is missing, or 0 otherwise.
 
 *******************************************************************************/
 int compute_reqs_order(const BuildListItem & build,
                        std::vector<BuildListItem *> & reqlist,
                        std::vector<std::vector<BuildListItem> > & slackbuilds)
 {
-  int check;
+  const DepGraph & graph = get_dep_graph(slackbuilds);
+  unsigned int node;
 
   reqlist.resize(0);
-  check = get_reqs_recursive(build, reqlist, slackbuilds);
-  std::reverse(reqlist.begin(), reqlist.end());
+  if (graph.nodeID(build.name(), slackbuilds, node) != 0) { return 1; }
 
-  return check;
+  return graph.reqsOrder(node, reqlist);
 }  
 
 /*******************************************************************************
 
-Recursively finds installed SlackBuilds that depend on a given SlackBuild
-
-*******************************************************************************/
-void get_inverse_reqs_recursive(const BuildListItem & build,
-                      std::vector<BuildListItem *> & invreqlist,
-                      std::vector<BuildListItem *> & installedlist)
-{
-  unsigned int i, j, ninstalled, ndeps;
-  std::vector<std::string> deplist;
-
-  ninstalled = installedlist.size();
-  for ( i = 0; i < ninstalled; i++ )
-  {
-    deplist = split(installedlist[i]->getProp("requires"));
-    ndeps = deplist.size();
-    for ( j = 0; j < ndeps; j++ )
-    {
-      if (deplist[j] == build.name())
-      {
-        add_req(installedlist[i], invreqlist);
-        get_inverse_reqs_recursive(*installedlist[i], invreqlist, 
-                                   installedlist);
-        break;
-      }
-    }
-  }
-}        
-
-/*******************************************************************************
-
 Computes list of installed SlackBuilds that depend on a given SlackBuild
 
 *******************************************************************************/
@@ -134,9 +68,10 @@ void compute_inv_reqs(const BuildListItem & build,
                       std::vector<BuildListItem *> & invreqlist,
                       std::vector<std::vector<BuildListItem> > & slackbuilds)
 {
-  std::vector<BuildListItem *> installedlist;
+  const DepGraph & graph = get_dep_graph(slackbuilds);
+  unsigned int node;
 
   invreqlist.resize(0);
-  installedlist = list_installed(slackbuilds);
-  get_inverse_reqs_recursive(build, invreqlist, installedlist);
+  if (graph.nodeID(build.name(), slackbuilds, node) != 0) { return; }
+  graph.invReqs(node, invreqlist);
 }
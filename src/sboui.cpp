@@ -35,6 +35,10 @@ int main(int argc, char *argv[])
 
   if (clos.sync())
     return sync_repo(false);
+  else if (clos.cachePrune())
+    return prune_source_cache();
+  else if (clos.cacheStats())
+    return source_cache_stats();
   else if (clos.upgradable())
   {
     MainWindow mainwindow(PACKAGE_VERSION);
@@ -35,6 +35,9 @@ namespace settings
   std::string layout;
   bool resolve_deps, confirm_changes, enable_color, rebuild_inv_deps;
   bool save_buildopts, warn_invalid_pkgnames, cumulative_filters;
+  bool watch_changes, prefetch_sources, native_backend;
+  int build_jobs;
+  std::string package_cache;
 }
 
 Color colors;
@@ -170,6 +173,21 @@ int read_config(const std::string & conf_file)
   if (! cfg.lookupValue("cumulative_filters", cumulative_filters))
     cumulative_filters = true;
 
+  if (! cfg.lookupValue("watch_changes", watch_changes))
+    watch_changes = false;
+
+  if (! cfg.lookupValue("prefetch_sources", prefetch_sources))
+    prefetch_sources = false;
+
+  if (! cfg.lookupValue("package_cache", package_cache))
+    package_cache = "";
+
+  if (! cfg.lookupValue("native_backend", native_backend))
+    native_backend = false;
+
+  if (! cfg.lookupValue("build_jobs", build_jobs)) { build_jobs = 1; }
+  else if (build_jobs < 1) { build_jobs = 1; }
+
   if (! cfg.lookupValue("layout", layout)) { layout = "horizontal"; }
   else if ( (layout != "horizontal") && (layout != "vertical") )
   {
@@ -375,6 +393,11 @@ int write_config(const std::string & conf_file)
   root.add("color_theme", Setting::TypeString) = color_theme;
   root.add("warn_invalid_pkgnames", Setting::TypeBoolean) = warn_invalid_pkgnames;
   root.add("cumulative_filters", Setting::TypeBoolean) = cumulative_filters;
+  root.add("watch_changes", Setting::TypeBoolean) = watch_changes;
+  root.add("build_jobs", Setting::TypeInt) = build_jobs;
+  root.add("prefetch_sources", Setting::TypeBoolean) = prefetch_sources;
+  root.add("package_cache", Setting::TypeString) = package_cache;
+  root.add("native_backend", Setting::TypeBoolean) = native_backend;
 
   // Overwrite config file
 
@@ -2,7 +2,12 @@
 #include <sstream>
 #include <fstream>
 #include <vector>
-#include <cctype>  // isdigit
+#include <cctype>  // isdigit, tolower
+#include <cstring>  // memchr, memrchr
+#include <fcntl.h>  // open
+#include <unistd.h>  // read, close
+#include <sys/mman.h>  // mmap
+#include <sys/stat.h>
 #include "string_util.h"
 
 /*******************************************************************************
@@ -148,6 +153,28 @@ std::vector<std::string> split(const std::string & instr, char delim)
 
 /*******************************************************************************
 
+Quotes a string for the shell
+
+*******************************************************************************/
+std::string shell_quote(const std::string & instr)
+{
+  std::string quoted;
+  unsigned int i, len;
+
+  quoted = "'";
+  len = instr.size();
+  for ( i = 0; i < len; i++ )
+  {
+    if (instr[i] == '\'') { quoted += "'\\''"; }
+    else { quoted += instr[i]; }
+  }
+  quoted += "'";
+
+  return quoted;
+}
+
+/*******************************************************************************
+
 Wraps words in a string into separate lines, returned as a vector of strings
 
 *******************************************************************************/
@@ -187,74 +214,209 @@ std::vector<std::string> wrap_words(const std::string & instr,
 
 /*******************************************************************************
 
-Searches in a file for a pattern. Returns true if found, or false if not found
-or file can't be read.
+Checks for a whole-word match of length len at pos in text. Like splitting the
+line at spaces and trimming each word, the match must start a word, and the
+rest of the word (ignoring trailing null characters) must be empty or one of
+the punctuation characters . , ; : ) ? !
 
 *******************************************************************************/
-bool find_in_file(const std::string & pattern, const std::string & filename,
-                  bool whole_word, bool case_sensitive)
+bool whole_word_at(const char *text, std::size_t textlen, std::size_t linestart,
+                   std::size_t pos, std::size_t len)
 {
-  std::ifstream file;
-  std::string searchpattern, line;
-  std::vector<std::string> splitline;
-  bool match;
-  std::size_t pos;
-  unsigned int i, nwords, wordlen;
+  std::size_t wordend, restlen;
   char last;
 
-  file.open(filename.c_str());
-  if (not file.is_open()) { return false; }
+  if ( (pos > linestart) && (text[pos-1] != ' ') ) { return false; }
+
+  wordend = pos + len;
+  while ( (wordend < textlen) && (text[wordend] != ' ') &&
+          (text[wordend] != '\n') )
+    wordend++;
+  while ( (wordend > pos+len) && (text[wordend-1] == '\0') ) { wordend--; }
+
+  restlen = wordend - (pos+len);
+  if (restlen == 0) { return true; }
+  if (restlen > 1) { return false; }
+  last = text[pos+len];
+
+  return ( (last == '.') || (last == ',') || (last == ';') || (last == ':') ||
+           (last == ')') || (last == '?') || (last == '!') );
+}
+
+/*******************************************************************************
+
+Searches in text for a pattern, the same way as find_in_file. Candidate
+positions are found by looking for the first character of the pattern with
+memchr (in both cases, for a case-insensitive search), and only there is the
+rest of the pattern compared.
+
+*******************************************************************************/
+bool find_in_text(const char *text, std::size_t textlen,
+                  const std::string & pattern, bool whole_word,
+                  bool case_sensitive)
+{
+  std::string searchpattern;
+  std::vector<char> firsts;
+  std::vector<std::size_t> nexts;
+  std::size_t pos, hit, linestart, k, plen;
+  const char *found;
+  unsigned int i, nfirsts;
+  bool same;
 
   if (case_sensitive) { searchpattern = pattern; }
   else { searchpattern = string_to_lower(pattern); }
+  plen = searchpattern.size();
+  if (plen == 0) { return true; }
+  if (searchpattern.find('\n') != std::string::npos) { return false; }
+  if ( whole_word && (searchpattern.find(' ') != std::string::npos) )
+    return false;
+
+  // Characters that can start a match
 
-  match = false;
-  while (! file.eof())
+  if (case_sensitive) { firsts.push_back(searchpattern[0]); }
+  else
   {
-    std::getline(file, line);
+    for ( i = 0; i < 256; i++ )
+    {
+      if (char(std::tolower(char(i))) == searchpattern[0])
+        firsts.push_back(char(i));
+    }
+  }
+  nfirsts = firsts.size();
+  nexts.assign(nfirsts, 0);
 
-    // Skip comments
+  pos = 0;
+  while (pos + plen <= textlen)
+  {
+    // Next occurrence of any first character. Positions found earlier are
+    // kept until they are passed.
 
-    if (line[0] == '#') { continue; }
+    hit = textlen;
+    for ( i = 0; i < nfirsts; i++ )
+    {
+      if ( (pos == 0) || (nexts[i] < pos) )
+      {
+        found = static_cast<const char *>(
+                std::memchr(text + pos, firsts[i], textlen - pos));
+        nexts[i] = (found == NULL) ? textlen : found - text;
+      }
+      if (nexts[i] < hit) { hit = nexts[i]; }
+    }
+    if (hit + plen > textlen) { break; }
 
-    if (! case_sensitive) { line = string_to_lower(line); }
+    // Compare rest of pattern
+
+    same = true;
+    for ( k = 1; (k < plen) && same; k++ )
+    {
+      if (case_sensitive) { same = (text[hit+k] == searchpattern[k]); }
+      else { same = (char(std::tolower(text[hit+k])) == searchpattern[k]); }
+    }
+    if (! same)
+    {
+      pos = hit+1;
+      continue;
+    }
 
-    // Search for pattern in entire line
+    // Skip comment lines
 
-    if (! whole_word) 
+    found = static_cast<const char *>(memrchr(text, '\n', hit));
+    linestart = (found == NULL) ? 0 : found - text + 1;
+    if (text[linestart] == '#')
     {
-      pos = line.find(searchpattern);
-      if (pos != std::string::npos) { match = true; }
+      found = static_cast<const char *>(
+              std::memchr(text + hit, '\n', textlen - hit));
+      if (found == NULL) { break; }
+      pos = found - text + 1;
+      continue;
     }
-    
-    // Search individual words
 
-    else
+    if ( (! whole_word) || whole_word_at(text, textlen, linestart, hit, plen) )
+      return true;
+    pos = hit+1;
+  }
+
+  return false;
+}
+
+/*******************************************************************************
+
+Searches in a file for a pattern. Returns true if found, or false if not found
+or file can't be read. Lines starting with # are skipped. For whole-word
+searches, the pattern must match a space-separated word, optionally followed by
+punctuation. An empty pattern matches any file that can be read. Small files
+are read with a single read call, and larger ones are mapped into memory.
+
+*******************************************************************************/
+const std::size_t find_buffer_size = 16384;
+
+bool find_in_file(const std::string & pattern, const std::string & filename,
+                  bool whole_word, bool case_sensitive)
+{
+  int fd;
+  struct stat sb;
+  char buffer[find_buffer_size];
+  std::size_t size, nread;
+  ssize_t check;
+  void *map;
+  bool match;
+
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) { return false; }
+  if ( (fstat(fd, &sb) != 0) || (! S_ISREG(sb.st_mode)) )
+  {
+    close(fd);
+    return false;
+  }
+  if (pattern.size() == 0)
+  {
+    close(fd);
+    return true;
+  }
+  size = sb.st_size;
+
+  if (size <= find_buffer_size)
+  {
+    nread = 0;
+    while (nread < size)
     {
-      splitline = split(line, ' ');
-      nwords = splitline.size();
-      for ( i = 0; i < nwords; i++ )
-      {
-        if (splitline[i] == searchpattern) { match = true; }
-        else
-        {
-          wordlen = splitline[i].size();
-          if (splitline[i].substr(0,wordlen-1) == searchpattern)
-          {
-            // Check for punctuation
-
-            last = splitline[i][wordlen-1];
-            if ( (last == '.') || (last == ',') || (last == ';') ||
-                 (last == ':') || (last == ')') || (last == '?') ||
-                 (last == '!') ) { match = true; }
-          }
-        }
-        if (match) { break; }
-      }
+      check = read(fd, buffer + nread, size - nread);
+      if (check <= 0) { break; }
+      nread += check;
     }
-    if (match) { break; }
+    close(fd);
+    return find_in_text(buffer, nread, pattern, whole_word, case_sensitive);
   }
 
-  file.close();
+  map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) { return false; }
+  match = find_in_text(static_cast<const char *>(map), size, pattern,
+                       whole_word, case_sensitive);
+  munmap(map, size);
+
   return match;
 }
+
+/*******************************************************************************
+
+Searches for a pattern in a list of files in parallel. Files are handed out to
+threads a few at a time, so that threads that finish early take more.
+
+*******************************************************************************/
+void find_in_files(const std::string & pattern,
+                   const std::vector<std::string> & filenames,
+                   std::vector<char> & found, bool whole_word,
+                   bool case_sensitive)
+{
+  int k, nfiles;
+
+  nfiles = filenames.size();
+  found.assign(nfiles, 0);
+#pragma omp parallel for schedule(dynamic,4)
+  for ( k = 0; k < nfiles; k++ )
+  {
+    if (find_in_file(pattern, filenames[k], whole_word, case_sensitive))
+      found[k] = 1;
+  }
+}